@@ -0,0 +1,67 @@
+#include "include/Order.hpp"
+#include "include/OrderBook.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+// market maker style amends: every op shrinks one resting order by 1 lot at
+// the same price (in place amend vs the old cancel + re-add)
+
+std::vector<Order> restingOrders(std::size_t perSide) {
+  std::vector<Order> orders;
+  for (std::size_t i = 1; i <= perSide; i++) {
+    orders.emplace_back("SPY", OrderType::OrderType::GoodTillCancel,
+                        Side::Side::Buy, (10000 - i) / 100.0, 1'000'000,
+                        "0_MM");
+    orders.emplace_back("SPY", OrderType::OrderType::GoodTillCancel,
+                        Side::Side::Sell, (10000 + i) / 100.0, 1'000'000,
+                        "0_MM");
+  }
+  return orders;
+}
+
+template <typename Amend>
+double runAmends(std::size_t opCount, std::size_t perSide, Amend amend) {
+  OrderBook ob("SPY", 10000, 4096);
+  std::vector<Order> orders = restingOrders(perSide);
+  for (Order &order : orders)
+    ob.AddOrder(order);
+
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < opCount; i++) {
+    Order &order = orders[i % orders.size()];
+    Order smaller = order;
+    smaller.setQuantity(order.getRemainingQuantity() - 1);
+    amend(ob, order, smaller);
+    order = smaller;
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         static_cast<double>(opCount);
+}
+
+int main() {
+  const std::size_t opCount = 2'000'000;
+  for (std::size_t perSide : {16, 1000}) {
+    double inPlace = runAmends(
+        opCount, perSide, [](OrderBook &ob, Order &order, Order &smaller) {
+          ob.ModifyOrder(order.getOrderID(), smaller);
+        });
+    double cancelReplace = runAmends(
+        opCount, perSide, [](OrderBook &ob, Order &order, Order &smaller) {
+          ob.CancelOrder(order.getOrderID());
+          ob.AddOrder(smaller);
+        });
+
+    std::cout << perSide << " resting orders per side, " << opCount
+              << " size-down amends" << std::endl;
+    std::cout << "  cancel/replace : " << cancelReplace << " ns/op"
+              << std::endl;
+    std::cout << "  in place       : " << inPlace << " ns/op" << std::endl;
+  }
+}
@@ -0,0 +1,95 @@
+#include "include/InternTable.hpp"
+#include "include/Order.hpp"
+#include "include/OrderBook.hpp"
+#include "include/Participant.hpp"
+#include "include/Trade.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/alias/InternRel.hpp"
+#include "utils/alias/OrderRel.hpp"
+#include "utils/alias/TradeRel.hpp"
+#include "utils/enums/Actions.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 10k participants each rest a one lot ask (one per tick), one more sweeps
+// them all: every fill is attributed to its two participants as it happens
+// (book trade listener -> participant by handle, as Xchange routes it)
+// scan: the previous scheme, every participant walking every trade
+
+int main() {
+  const std::size_t participants = 10000;
+  const std::size_t rounds = 20;
+
+  InternTablePointer symbolNames = std::make_shared<InternTable>();
+  InternTablePointer participantNames = std::make_shared<InternTable>();
+  std::vector<std::shared_ptr<Participant>> parts;
+  for (std::size_t idx = 0; idx <= participants; idx++) {
+    auto part = std::make_shared<Participant>();
+    part->setParticipantID(std::to_string(idx) + "_GOVID");
+    part->setParticipantHandle(participantNames->intern(part->getParticipantID()));
+    part->setSymbolNames(symbolNames);
+    parts.push_back(part);
+  }
+  std::shared_ptr<Participant> &taker = parts.back();
+
+  double matchNs = 0, scanNs = 0;
+  std::size_t fills = 0, scanned = 0;
+  for (std::size_t round = 0; round < rounds; round++) {
+    OrderBook ob("SPY", 10000, 16384, symbolNames, participantNames);
+    ob.reserveTrades(participants);
+    ob.setTradeListener([&parts](const Trade &trade) {
+      parts[trade.getMatchedBid().participant]->recordTrade(trade);
+      parts[trade.getMatchedAsk().participant]->recordTrade(trade);
+    });
+
+    for (std::size_t idx = 0; idx < participants; idx++) {
+      OrderPointer ask = parts[idx]->recordNonCancelOrder(
+          Actions::Actions::Add, "SPY", OrderType::OrderType::GoodTillCancel,
+          Side::Side::Sell, (10000 + idx + 1) / 100.0, 1,
+          parts[idx]->getParticipantID());
+      ob.AddOrder(*ask);
+    }
+    OrderPointer sweep = taker->recordNonCancelOrder(
+        Actions::Actions::Add, "SPY", OrderType::OrderType::GoodTillCancel,
+        Side::Side::Buy, (10000 + participants) / 100.0, participants,
+        taker->getParticipantID());
+
+    auto start = std::chrono::steady_clock::now();
+    fills += ob.AddOrder(*sweep).size();
+    auto mid = std::chrono::steady_clock::now();
+
+    // previous scheme: N participants x T trades of handle compares
+    // (over a flat copy, as the old vector was)
+    Trades trades(ob.getTradeSequence());
+    ob.getTrades().read(0, trades);
+    auto scanStart = std::chrono::steady_clock::now();
+    for (std::size_t idx = 0; idx < participants; idx++) {
+      ParticipantHandle self = parts[idx]->getParticipantHandle();
+      for (const Trade &trade : trades)
+        scanned += (trade.getMatchedBid().participant == self ||
+                    trade.getMatchedAsk().participant == self);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    matchNs += std::chrono::duration<double, std::nano>(mid - start).count();
+    scanNs +=
+        std::chrono::duration<double, std::nano>(end - scanStart).count();
+  }
+
+  std::cout << rounds << " rounds, " << participants
+            << " participants swept by one (" << fills << " fills)"
+            << std::endl;
+  std::cout << "  match + attribution : "
+            << matchNs / static_cast<double>(fills) << " ns/fill" << std::endl;
+  std::cout << "  scan (N x T)        : " << scanNs / static_cast<double>(fills)
+            << " ns/fill (" << scanned << " legs found)" << std::endl;
+  std::cout << "  taker trades        : " << taker->getNumberOfTrades()
+            << std::endl;
+}
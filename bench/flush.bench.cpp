@@ -0,0 +1,71 @@
+#include "include/Order.hpp"
+#include "include/OrderBook.hpp"
+#include "include/Preprocess.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/alias/OrderBookRel.hpp"
+#include "utils/alias/OrderRel.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// cost of one flush per buffered order: K all-or-none bids with nothing to
+// match stay buffered (every flush walks them), K fill-or-kill bids with
+// nothing to match are dropped mid flush (erase while draining), the same
+// against 1000 ask levels they could reach but not fill (depth lookup)
+
+std::vector<OrderPointer> bids(OrderType::OrderType type, std::size_t count,
+                               Quantity quantity) {
+  std::vector<OrderPointer> orders;
+  for (std::size_t i = 0; i < count; i++)
+    orders.push_back(std::make_shared<Order>(
+        "SPY", type, Side::Side::Buy, (10000 + i) / 100.0, quantity, "0_MM"));
+  return orders;
+}
+
+double nsPerBufferedOrder(OrderType::OrderType type, std::size_t count,
+                          std::size_t flushes, std::size_t askLevels = 0) {
+  OrderBookPointer ob = std::make_shared<OrderBook>("SPY", 10000, 4096);
+  for (std::size_t i = 0; i < askLevels; i++) {
+    Order ask("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Sell,
+              (9000 + i) / 100.0, 1, "1_MM");
+    ob->AddOrder(ask);
+  }
+  // thresholds out of reach: only the explicit flushes below run
+  PreProcessor pre(ob, true, SIZE_MAX, std::chrono::hours(24), "Asia/Kolkata",
+                   TimeTuple{std::chrono::minutes(0), std::chrono::hours(24)});
+  std::chrono::steady_clock::duration spent{};
+  for (std::size_t round = 0; round < flushes; round++) {
+    if (pre.getBufferedOrderCount() == 0)
+      for (const OrderPointer &order : bids(type, count, askLevels + 100))
+        pre.InsertAddOrderIntoPreprocessing(order);
+    auto start = std::chrono::steady_clock::now();
+    pre.QueueOrdersForInsertion();
+    spent += std::chrono::steady_clock::now() - start;
+  }
+  return std::chrono::duration<double, std::nano>(spent).count() /
+         static_cast<double>(count * flushes);
+}
+
+int main() {
+  std::cout << "flush, ns per buffered order" << std::endl;
+  for (std::size_t count : {100, 10000}) {
+    std::cout << "  K = " << count << std::endl;
+    std::cout << "    all-or-none (kept)    : "
+              << nsPerBufferedOrder(OrderType::OrderType::AllOrNone, count,
+                                    1000000 / count)
+              << std::endl;
+    std::cout << "    fill-or-kill (dropped): "
+              << nsPerBufferedOrder(OrderType::OrderType::FillOrKill, count,
+                                    100000 / count)
+              << std::endl;
+    std::cout << "    fill-or-kill, 1000 ask levels: "
+              << nsPerBufferedOrder(OrderType::OrderType::FillOrKill, count,
+                                    100000 / count, 1000)
+              << std::endl;
+  }
+}
@@ -0,0 +1,61 @@
+#include "include/Journal.hpp"
+#include "utils/Constants.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/enums/Actions.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+
+// journaling cost per accepted add (what Xchange::placeOrder appends),
+// fdatasync'd: group commit of N events / T us vs one fsync per order
+
+double ordersPerSecond(const std::string &path, std::size_t orders,
+                       JournalOptions options) {
+  std::filesystem::remove(path);
+  const std::optional<TimeStamp> activation = Constants::Now,
+                                 deactivation = Constants::EndOfTime;
+  auto start = std::chrono::steady_clock::now();
+  {
+    Journal journal(path, options);
+    for (std::size_t idx = 0; idx < orders; idx++)
+      journal.appendOrder(static_cast<ParticipantHandle>(idx % 10000),
+                          Actions::Actions::Add, std::nullopt, 0,
+                          (idx & 1) ? Side::Side::Sell : Side::Side::Buy,
+                          OrderType::OrderType::GoodTillCancel,
+                          static_cast<Price>(10000 + idx % 100), 10,
+                          activation, deactivation, idx + 1);
+  } // last group committed here
+  auto end = std::chrono::steady_clock::now();
+  std::filesystem::remove(path);
+  return static_cast<double>(orders) /
+         std::chrono::duration<double>(end - start).count();
+}
+
+int main() {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "xchange-journal.bench")
+          .string();
+
+  std::cout << "journal appends (fdatasync'd), orders/sec" << std::endl;
+  std::cout << "  fsync per order        : "
+            << ordersPerSecond(path, 5000, JournalOptions{1, {}, true})
+            << std::endl;
+  std::cout << "  group 1024 / 1000 us   : "
+            << ordersPerSecond(path, 2000000,
+                               JournalOptions{1024,
+                                              std::chrono::microseconds(1000),
+                                              true})
+            << std::endl;
+  std::cout << "  group 8192 / 5000 us   : "
+            << ordersPerSecond(path, 2000000,
+                               JournalOptions{8192,
+                                              std::chrono::microseconds(5000),
+                                              true})
+            << std::endl;
+}
@@ -0,0 +1,103 @@
+#include "include/Order.hpp"
+#include "include/OrderBook.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+// heap allocations & latency of the add/cancel path once the book is warm
+// (first warmupOps ops are not measured, levels & slots get recycled after)
+
+static bool g_countAllocations = false;
+static std::size_t g_allocationCount = 0;
+
+static void *countedAllocate(std::size_t size) {
+  if (g_countAllocations)
+    g_allocationCount++;
+  if (void *ptr = std::malloc(size == 0 ? 1 : size))
+    return ptr;
+  throw std::bad_alloc();
+}
+static void countedRelease(void *ptr) noexcept { std::free(ptr); }
+
+void *operator new(std::size_t size) { return countedAllocate(size); }
+void *operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void *ptr) noexcept { countedRelease(ptr); }
+void operator delete[](void *ptr) noexcept { countedRelease(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { countedRelease(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { countedRelease(ptr); }
+
+struct BenchOp {
+  bool isCancel;
+  Order order;
+};
+
+std::vector<BenchOp> generateFlow(std::size_t opCount, int bandTicks) {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> offset(1, bandTicks);
+  std::bernoulli_distribution isBuy(0.5);
+  const int mid = 10000; // 100.00
+
+  std::unordered_set<OrderID> resting;
+  std::vector<BenchOp> ops;
+  ops.reserve(opCount);
+  for (std::size_t i = 0; i < opCount; i++) {
+    bool buy = isBuy(rng);
+    int tick = buy ? mid - offset(rng) : mid + offset(rng);
+    Order order("SPY", OrderType::OrderType::GoodTillCancel,
+                buy ? Side::Side::Buy : Side::Side::Sell, tick / 100.0, 10,
+                "0_BENCH");
+    bool cancel = resting.count(order.getOrderID()) > 0;
+    if (cancel)
+      resting.erase(order.getOrderID());
+    else
+      resting.insert(order.getOrderID());
+    ops.push_back(BenchOp{cancel, order});
+  }
+  return ops;
+}
+
+void apply(OrderBook &ob, BenchOp &op) {
+  if (op.isCancel)
+    ob.CancelOrder(op.order.getOrderID());
+  else
+    ob.AddOrder(op.order);
+}
+
+int main() {
+  const std::size_t opCount = 2'000'000;
+  const std::size_t warmupOps = 200'000;
+  for (int bandTicks : {16, 1024}) {
+    std::vector<BenchOp> ops = generateFlow(opCount, bandTicks);
+    OrderBook ob("SPY", 10000, 4096);
+    for (std::size_t i = 0; i < warmupOps; i++)
+      apply(ob, ops[i]);
+
+    g_allocationCount = 0;
+    g_countAllocations = true;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = warmupOps; i < opCount; i++)
+      apply(ob, ops[i]);
+    auto end = std::chrono::steady_clock::now();
+    g_countAllocations = false;
+
+    double measured = static_cast<double>(opCount - warmupOps);
+    std::cout << "band +-" << bandTicks << " ticks, "
+              << opCount - warmupOps << " warm add/cancel ops" << std::endl;
+    std::cout << "  allocations : " << g_allocationCount / measured << " /op"
+              << std::endl;
+    std::cout << "  latency     : "
+              << std::chrono::duration<double, std::nano>(end - start)
+                         .count() /
+                     measured
+              << " ns/op" << std::endl;
+  }
+}
@@ -0,0 +1,52 @@
+#include "include/Order.hpp"
+#include "include/OrderBook.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+// fill heavy flow: refill 1000 one lot asks (one per tick), then a single
+// buy sweeps all of them (1000 fills per round, trade log cleared between)
+
+int main() {
+  const std::size_t levels = 1000;
+  const std::size_t rounds = 2000;
+
+  std::vector<Order> asks;
+  for (std::size_t tick = 1; tick <= levels; tick++)
+    asks.emplace_back("SPY", OrderType::OrderType::GoodTillCancel,
+                      Side::Side::Sell, (10000 + tick) / 100.0, 1,
+                      "1_PARTICIPANT_WITH_LONG_GOVID");
+  Order sweep("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Buy,
+              (10000 + levels) / 100.0, levels,
+              "2_PARTICIPANT_WITH_LONG_GOVID");
+
+  double addNs = 0, matchNs = 0;
+  std::size_t fills = 0;
+  for (std::size_t round = 0; round < rounds; round++) {
+    OrderBook ob("SPY", 10000, 4096);
+    ob.reserveTrades(levels);
+
+    auto start = std::chrono::steady_clock::now();
+    for (Order &ask : asks)
+      ob.AddOrder(ask);
+    auto mid = std::chrono::steady_clock::now();
+    Order aggressor = sweep;
+    fills += ob.AddOrder(aggressor).size();
+    auto end = std::chrono::steady_clock::now();
+
+    addNs += std::chrono::duration<double, std::nano>(mid - start).count();
+    matchNs += std::chrono::duration<double, std::nano>(end - mid).count();
+  }
+
+  std::cout << rounds << " rounds of " << levels << " resting asks swept"
+            << std::endl;
+  std::cout << "  add   : " << addNs / static_cast<double>(rounds * levels)
+            << " ns/order" << std::endl;
+  std::cout << "  match : " << matchNs / static_cast<double>(fills)
+            << " ns/fill" << std::endl;
+}
@@ -0,0 +1,120 @@
+#include "include/Order.hpp"
+#include "include/OrderEntry.hpp"
+#include "include/OrderRequest.hpp"
+#include "include/Xchange.hpp"
+#include "utils/Constants.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/enums/Actions.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+// per request cost of the string API (names, double price, date string
+// parsed per order) vs binary order entry (the encoded stream decoded in
+// place straight into placeOrder): good-till-date adds, each cancelled by
+// the next request, 64 participants over 16 symbols
+
+using namespace std::chrono;
+
+const std::size_t Participants = 64;
+const std::size_t Symbols = 16;
+
+struct Handles {
+  std::vector<ParticipantHandle> parts;
+  std::vector<SymbolHandle> syms;
+  std::vector<std::string> partIDs;
+  std::vector<std::string> symbols;
+};
+
+Handles setUp(Xchange &xchange) {
+  Handles handles;
+  for (std::size_t idx = 0; idx < Participants; idx++) {
+    handles.parts.push_back(
+        xchange.registerParticipant("GOV" + std::to_string(idx)));
+    handles.partIDs.push_back(
+        xchange.getParticipantInfo(handles.parts.back())->getParticipantID());
+  }
+  for (std::size_t idx = 0; idx < Symbols; idx++) {
+    handles.symbols.push_back("SYM" + std::to_string(idx));
+    handles.syms.push_back(xchange.tradeNewSymbol(handles.symbols.back()));
+  }
+  return handles;
+}
+
+// dd-mm-yyyy hh:mm:ss local, as placeOrder takes it
+std::string localDateTime(TimeStamp time) {
+  std::time_t tt = system_clock::to_time_t(time);
+  std::tm local = *std::localtime(&tt);
+  char text[32];
+  std::strftime(text, sizeof(text), "%d-%m-%Y %H:%M:%S", &local);
+  return text;
+}
+
+double nsPerStringRequest(std::size_t orders, TimeStamp expiry) {
+  Xchange &xchange = Xchange::getInstance(1000000, 1000000);
+  Handles handles = setUp(xchange);
+  const std::optional<std::string> activation = "",
+                                   deactivation = localDateTime(expiry);
+  auto start = steady_clock::now();
+  for (std::size_t idx = 0; idx < orders; idx++) {
+    const std::string &part = handles.partIDs[idx % Participants];
+    const std::string &sym = handles.symbols[idx % Symbols];
+    Side::Side side = (idx & 1) ? Side::Side::Sell : Side::Side::Buy;
+    double price = static_cast<double>(10000 + idx % 4000) / 100;
+    std::optional<OrderID> id = xchange.placeOrder(
+        part, Actions::Actions::Add, std::nullopt, sym, side,
+        OrderType::OrderType::GoodTillDate, price, 10, activation,
+        deactivation);
+    xchange.placeOrder(part, Actions::Actions::Cancel, id, sym, side,
+                       OrderType::OrderType::GoodTillDate, std::nullopt,
+                       std::nullopt, std::nullopt, std::nullopt);
+  }
+  auto end = steady_clock::now();
+  Xchange::destroyInstance();
+  return duration<double, std::nano>(end - start).count() /
+         static_cast<double>(2 * orders);
+}
+
+// ids are drawn in order, so the load generator knows which one to cancel
+double nsPerBinaryRequest(std::size_t orders, TimeStamp expiry) {
+  Xchange &xchange = Xchange::getInstance(1000000, 1000000);
+  Handles handles = setUp(xchange);
+  OrderID next = Order::getIdGenerator().peek();
+  std::vector<char> wire;
+  OrderEntry::Encoder encoder(wire);
+  for (std::size_t idx = 0; idx < orders; idx++) {
+    ParticipantHandle part = handles.parts[idx % Participants];
+    SymbolHandle sym = handles.syms[idx % Symbols];
+    Side::Side side = (idx & 1) ? Side::Side::Sell : Side::Side::Buy;
+    encoder.newOrder(part, sym, side, OrderType::OrderType::GoodTillDate,
+                     static_cast<Price>(10000 + idx % 4000), 10, Constants::Now,
+                     expiry);
+    encoder.cancelOrder(part, next++, sym, side,
+                        OrderType::OrderType::GoodTillDate);
+  }
+  OrderEntry::Decoder decoder(xchange);
+  auto start = steady_clock::now();
+  std::size_t consumed = decoder.decode(wire.data(), wire.size());
+  auto end = steady_clock::now();
+  Xchange::destroyInstance();
+  if (consumed != wire.size())
+    std::cout << "stream not fully decoded" << std::endl;
+  return duration<double, std::nano>(end - start).count() /
+         static_cast<double>(2 * orders);
+}
+
+int main() {
+  const TimeStamp expiry = floor<seconds>(system_clock::now()) + days(30);
+  std::cout << "ns per request (gtd add + cancel)" << std::endl;
+  std::cout << "  string API   : " << nsPerStringRequest(200000, expiry)
+            << std::endl;
+  std::cout << "  binary entry : " << nsPerBinaryRequest(200000, expiry)
+            << std::endl;
+}
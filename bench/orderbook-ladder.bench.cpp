@@ -0,0 +1,76 @@
+#include "include/Order.hpp"
+#include "include/OrderBook.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+// add/cancel heavy flow: each op picks a resting price on one side of the
+// mid, adds an order if the level is empty or cancels it if it is resting
+// (levels are created & destroyed constantly, matching never kicks in)
+
+struct BenchOp {
+  bool isCancel;
+  Order order;
+};
+
+std::vector<BenchOp> generateFlow(std::size_t opCount, int bandTicks) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> offset(1, bandTicks);
+  std::bernoulli_distribution isBuy(0.5);
+  const int mid = 10000; // 100.00
+
+  std::unordered_set<OrderID> resting;
+  std::vector<BenchOp> ops;
+  ops.reserve(opCount);
+  for (std::size_t i = 0; i < opCount; i++) {
+    bool buy = isBuy(rng);
+    int tick = buy ? mid - offset(rng) : mid + offset(rng);
+    Order order("SPY", OrderType::OrderType::GoodTillCancel,
+                buy ? Side::Side::Buy : Side::Side::Sell, tick / 100.0, 10,
+                "0_BENCH");
+    bool cancel = resting.count(order.getOrderID()) > 0;
+    if (cancel)
+      resting.erase(order.getOrderID());
+    else
+      resting.insert(order.getOrderID());
+    ops.push_back(BenchOp{cancel, order});
+  }
+  return ops;
+}
+
+double runFlow(OrderBook &ob, std::vector<BenchOp> ops) {
+  auto start = std::chrono::steady_clock::now();
+  for (auto &op : ops) {
+    if (op.isCancel)
+      ob.CancelOrder(op.order.getOrderID());
+    else
+      ob.AddOrder(op.order);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         static_cast<double>(ops.size());
+}
+
+int main() {
+  const std::size_t opCount = 2'000'000;
+  for (int bandTicks : {16, 256, 1024}) {
+    std::vector<BenchOp> ops = generateFlow(opCount, bandTicks);
+
+    OrderBook sparse("SPY");                // std::map levels
+    OrderBook ladder("SPY", 10000, 4096);   // dense ladder (+-20.48)
+    double sparseNs = runFlow(sparse, ops);
+    double ladderNs = runFlow(ladder, ops);
+
+    std::cout << "band +-" << bandTicks << " ticks, " << opCount
+              << " add/cancel ops" << std::endl;
+    std::cout << "  map    : " << sparseNs << " ns/op" << std::endl;
+    std::cout << "  ladder : " << ladderNs << " ns/op" << std::endl;
+  }
+}
@@ -0,0 +1,73 @@
+#include "include/Journal.hpp"
+#include "include/Xchange.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/enums/Actions.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// journaled placeOrder (fdatasync'd), add + cancel per order: everything
+// on the caller's thread (group commit of 1024 / 1 ms) vs the pipeline
+// (journal stage commits per batch while the execute stage matches)
+
+double requestsPerSecond(bool pipelined, std::size_t orders,
+                         const std::string &path) {
+  const std::size_t symbols = 64;
+  const std::size_t participants = 64;
+  std::filesystem::remove(path);
+  Xchange &xchange = Xchange::getInstance(30, 1000000);
+  xchange.startJournal(path);
+  std::vector<ParticipantHandle> parts;
+  for (std::size_t idx = 0; idx < participants; idx++)
+    parts.push_back(xchange.registerParticipant("GOV" + std::to_string(idx)));
+  std::vector<SymbolHandle> syms;
+  for (std::size_t idx = 0; idx < symbols; idx++)
+    syms.push_back(xchange.tradeNewSymbol("SYM" + std::to_string(idx)));
+  if (pipelined)
+    xchange.startPipeline();
+
+  const std::optional<std::string> activation = "", deactivation = "";
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t idx = 0; idx < orders; idx++) {
+    ParticipantHandle part = parts[(idx / symbols) % participants];
+    SymbolHandle sym = syms[idx % symbols];
+    Side::Side side = (idx & 1) ? Side::Side::Sell : Side::Side::Buy;
+    double price = (static_cast<double>(idx % 4000) + 10000.5) / 100;
+    std::optional<OrderID> id = xchange.placeOrder(
+        part, Actions::Actions::Add, std::nullopt, sym, side,
+        OrderType::OrderType::GoodTillCancel, price, 10, activation,
+        deactivation);
+    xchange.placeOrder(part, Actions::Actions::Cancel, id, sym, side,
+                       OrderType::OrderType::GoodTillCancel, std::nullopt,
+                       std::nullopt, std::nullopt, std::nullopt);
+  }
+  xchange.drainPipeline();
+  xchange.stopJournal(); // tail committed inside the timing
+  auto end = std::chrono::steady_clock::now();
+  Xchange::destroyInstance();
+  std::filesystem::remove(path);
+  return static_cast<double>(2 * orders) /
+         std::chrono::duration<double>(end - start).count();
+}
+
+int main() {
+  const std::size_t orders = 200000;
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "xchange-pipeline.bench")
+          .string();
+  std::cout << "journaled placeOrder (add + cancel), requests/sec, "
+            << std::thread::hardware_concurrency() << " hardware threads"
+            << std::endl;
+  std::cout << "  caller's thread : " << requestsPerSecond(false, orders, path)
+            << std::endl;
+  std::cout << "  pipelined       : " << requestsPerSecond(true, orders, path)
+            << std::endl;
+}
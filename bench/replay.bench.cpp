@@ -0,0 +1,137 @@
+#include "include/Clock.hpp"
+#include "include/Xchange.hpp"
+#include "utils/alias/ClockRel.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/enums/Actions.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// a full BSE session (6 h 15 m) journaled on a simulated clock: one
+// good-till-date add every 25 ms, each expiring a minute later (1 s pending
+// duration: flushes, expiries & session checks all on event time), then
+// replayed on a fresh exchange as fast as it applies; plus the live
+// request path (add + cancel) reading the wall clock vs a coarse clock
+
+using namespace std::chrono;
+
+const TimeStamp SessionOpen = sys_days{2025y / July / 21} + hours(3) +
+                              minutes(45); // Monday
+const milliseconds Spacing{25};
+const std::size_t Symbols = 16;
+
+struct Handles {
+  std::vector<ParticipantHandle> parts;
+  std::vector<SymbolHandle> syms;
+};
+
+Handles setUp(Xchange &xchange) {
+  Handles handles;
+  for (std::size_t idx = 0; idx < 16; idx++)
+    handles.parts.push_back(
+        xchange.registerParticipant("GOV" + std::to_string(idx)));
+  for (std::size_t idx = 0; idx < Symbols; idx++)
+    handles.syms.push_back(xchange.tradeNewSymbol("SYM" + std::to_string(idx)));
+  return handles;
+}
+
+// dd-mm-yyyy hh:mm:ss local, as placeOrder takes it
+std::string localDateTime(TimeStamp time) {
+  std::time_t tt = system_clock::to_time_t(time);
+  std::tm local = *std::localtime(&tt);
+  char text[32];
+  std::strftime(text, sizeof(text), "%d-%m-%Y %H:%M:%S", &local);
+  return text;
+}
+
+// buys on even symbols, sells on odd ones: rests till it expires
+std::size_t placeSession(Xchange &xchange, SimulatedClock &clock) {
+  Handles handles = setUp(xchange);
+  const TimeStamp close = SessionOpen + hours(6) + minutes(15);
+  const std::optional<std::string> activation = "";
+  std::size_t requests = 0;
+  for (std::size_t idx = 0; clock.read() < close; idx++) {
+    clock.advance(Spacing);
+    SymbolHandle sym = handles.syms[idx % Symbols];
+    Side::Side side = (sym & 1) ? Side::Side::Sell : Side::Side::Buy;
+    double price = (static_cast<double>(idx % 4000) + 10000.5) / 100;
+    xchange.placeOrder(handles.parts[idx % handles.parts.size()],
+                       Actions::Actions::Add, std::nullopt, sym, side,
+                       OrderType::OrderType::GoodTillDate, price, 10,
+                       activation, localDateTime(clock.read() + minutes(1)));
+    requests++;
+  }
+  return requests;
+}
+
+double secondsToReplay(const std::string &path, std::size_t &requests) {
+  std::filesystem::remove(path);
+  auto live = std::make_shared<SimulatedClock>(SessionOpen);
+  Clock::install(live);
+  Xchange &xchange = Xchange::getInstance(1000000, 1000);
+  xchange.startJournal(path);
+  requests = placeSession(xchange, *live);
+  Xchange::destroyInstance();
+
+  Clock::install(std::make_shared<SimulatedClock>(SessionOpen));
+  Xchange &rebuilt = Xchange::getInstance(1000000, 1000);
+  auto start = steady_clock::now();
+  rebuilt.replayJournal(path);
+  auto end = steady_clock::now();
+  Xchange::destroyInstance();
+  Clock::install(nullptr);
+  std::filesystem::remove(path);
+  return duration<double>(end - start).count();
+}
+
+double nsPerRequest(ClockPointer clock, std::size_t orders) {
+  Clock::install(std::move(clock));
+  Xchange &xchange = Xchange::getInstance(1000000, 1000);
+  Handles handles = setUp(xchange);
+  const std::optional<std::string> activation = "", deactivation = "";
+  auto start = steady_clock::now();
+  for (std::size_t idx = 0; idx < orders; idx++) {
+    ParticipantHandle part = handles.parts[idx % handles.parts.size()];
+    SymbolHandle sym = handles.syms[idx % Symbols];
+    Side::Side side = (idx & 1) ? Side::Side::Sell : Side::Side::Buy;
+    double price = (static_cast<double>(idx % 4000) + 10000.5) / 100;
+    std::optional<OrderID> id = xchange.placeOrder(
+        part, Actions::Actions::Add, std::nullopt, sym, side,
+        OrderType::OrderType::GoodTillCancel, price, 10, activation,
+        deactivation);
+    xchange.placeOrder(part, Actions::Actions::Cancel, id, sym, side,
+                       OrderType::OrderType::GoodTillCancel, std::nullopt,
+                       std::nullopt, std::nullopt, std::nullopt);
+  }
+  auto end = steady_clock::now();
+  Xchange::destroyInstance();
+  Clock::install(nullptr);
+  return duration<double, std::nano>(end - start).count() /
+         static_cast<double>(2 * orders);
+}
+
+int main() {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "xchange-replay.bench")
+          .string();
+  std::size_t requests = 0;
+  double seconds = secondsToReplay(path, requests);
+  std::cout << "6 h 15 m session, " << requests
+            << " requests replayed on journal time: " << seconds << " s"
+            << std::endl;
+  std::cout << "live placeOrder, ns per request" << std::endl;
+  std::cout << "  wall clock  : "
+            << nsPerRequest(std::make_shared<WallClock>(), 200000) << std::endl;
+  std::cout << "  coarse clock: "
+            << nsPerRequest(std::make_shared<CoarseClock>(), 200000)
+            << std::endl;
+}
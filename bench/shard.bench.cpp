@@ -0,0 +1,62 @@
+#include "include/Xchange.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/enums/Actions.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// placeOrder throughput over independent symbols: caller's thread only
+// vs N shards (add + cancel per order, timed till every shard drained)
+
+double requestsPerSecond(std::size_t shards, std::size_t orders) {
+  const std::size_t symbols = 64;
+  const std::size_t participants = 64;
+  Xchange &xchange = Xchange::getInstance(30, 1000000);
+  std::vector<ParticipantHandle> parts;
+  for (std::size_t idx = 0; idx < participants; idx++)
+    parts.push_back(xchange.registerParticipant("GOV" + std::to_string(idx)));
+  std::vector<SymbolHandle> syms;
+  for (std::size_t idx = 0; idx < symbols; idx++)
+    syms.push_back(xchange.tradeNewSymbol("SYM" + std::to_string(idx)));
+  xchange.startShards(shards);
+
+  const std::optional<std::string> activation = "", deactivation = "";
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t idx = 0; idx < orders; idx++) {
+    ParticipantHandle part = parts[(idx / symbols) % participants];
+    SymbolHandle sym = syms[idx % symbols];
+    Side::Side side = (idx & 1) ? Side::Side::Sell : Side::Side::Buy;
+    double price = (static_cast<double>(idx % 4000) + 10000.5) / 100;
+    std::optional<OrderID> id = xchange.placeOrder(
+        part, Actions::Actions::Add, std::nullopt, sym, side,
+        OrderType::OrderType::GoodTillCancel, price, 10, activation,
+        deactivation);
+    xchange.placeOrder(part, Actions::Actions::Cancel, id, sym, side,
+                       OrderType::OrderType::GoodTillCancel, std::nullopt,
+                       std::nullopt, std::nullopt, std::nullopt);
+  }
+  xchange.drainShards();
+  auto end = std::chrono::steady_clock::now();
+  Xchange::destroyInstance();
+  return static_cast<double>(2 * orders) /
+         std::chrono::duration<double>(end - start).count();
+}
+
+int main() {
+  const std::size_t orders = 200000;
+  std::cout << "placeOrder (add + cancel), requests/sec, "
+            << std::thread::hardware_concurrency() << " hardware threads"
+            << std::endl;
+  std::cout << "  caller's thread : " << requestsPerSecond(0, orders)
+            << std::endl;
+  for (std::size_t shards : {1, 2, 4})
+    std::cout << "  " << shards << " shard(s)      : "
+              << requestsPerSecond(shards, orders) << std::endl;
+}
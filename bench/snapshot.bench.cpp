@@ -0,0 +1,81 @@
+#include "include/OrderBook.hpp"
+#include "include/Participant.hpp"
+#include "include/Xchange.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/alias/OrderRel.hpp"
+#include "utils/alias/ParticipantRel.hpp"
+#include "utils/enums/Actions.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// restart cost of an exchange holding 1M resting orders (250 symbols,
+// 2000 bid & 2000 ask ticks each around the touch, 1000 participants):
+// snapshot write, then restore (mmap + rebuild) on a fresh exchange
+
+int main() {
+  const std::size_t symbols = 250;
+  const std::size_t ticks = 2000; // per side per symbol
+  const std::size_t participants = 1000;
+  const std::filesystem::path dir = std::filesystem::temp_directory_path();
+  const std::string snapshot = (dir / "xchange-bench.snapshot").string();
+  const std::string journal = (dir / "xchange-bench.journal").string();
+  std::filesystem::remove(journal);
+
+  Xchange &live = Xchange::getInstance(30, 1000000);
+  std::vector<ParticipantPointer> parts;
+  for (std::size_t idx = 0; idx < participants; idx++)
+    parts.push_back(live.getParticipantInfo(
+        live.registerParticipant("GOV" + std::to_string(idx))));
+
+  std::size_t resting = 0;
+  for (std::size_t sym = 0; sym < symbols; sym++) {
+    std::string symbol = "SYM" + std::to_string(sym);
+    OrderBookPointer ob = live.getOrderBook(live.tradeNewSymbol(symbol));
+    ob->reserveOrders(2 * ticks);
+    for (std::size_t tick = 1; tick <= ticks; tick++) {
+      for (Side::Side side : {Side::Side::Buy, Side::Side::Sell}) {
+        // bids below the mid, asks above it: nothing crosses
+        std::size_t mid = 100000;
+        std::size_t at = (side == Side::Side::Buy) ? mid - tick : mid + tick;
+        ParticipantPointer &part = parts[(tick + sym) % participants];
+        OrderPointer order = part->recordNonCancelOrder(
+            Actions::Actions::Add, symbol,
+            OrderType::OrderType::GoodTillCancel, side, (at + 0.5) / 100.0,
+            10, part->getParticipantID());
+        ob->AddOrder(*order);
+        resting++;
+      }
+    }
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  live.writeSnapshot(snapshot);
+  auto written = std::chrono::steady_clock::now();
+  Xchange::destroyInstance();
+
+  auto restart = std::chrono::steady_clock::now();
+  Xchange &restored = Xchange::getInstance(30, 1000000);
+  restored.restore(snapshot, journal);
+  auto end = std::chrono::steady_clock::now();
+
+  std::cout << resting << " resting orders, "
+            << std::filesystem::file_size(snapshot) / (1024 * 1024)
+            << " MiB snapshot" << std::endl;
+  std::cout << "  write   : "
+            << std::chrono::duration<double, std::milli>(written - start).count()
+            << " ms" << std::endl;
+  std::cout << "  restore : "
+            << std::chrono::duration<double, std::milli>(end - restart).count()
+            << " ms" << std::endl;
+  std::cout << "  books   : " << restored.getSymbolsTradedCount()
+            << ", participants " << restored.getParticipantCount() << std::endl;
+  Xchange::destroyInstance();
+  std::filesystem::remove(snapshot);
+}
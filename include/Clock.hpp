@@ -0,0 +1,73 @@
+#pragma once
+
+#include "utils/alias/Fundamental.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+// where the whole process reads the time (orders, preprocessors, trades,
+// journal): the wall clock unless another clock is installed
+// CoarseClock: cached reading, refreshed at batch boundaries (no vDSO call
+// per read), SimulatedClock: follows the timestamps of replayed events, so
+// flush durations, GAT/GTD timers & MOO/MOC windows run on event time
+class Clock {
+public:
+  virtual ~Clock() = default;
+
+  virtual TimeStamp read() const = 0;
+  // a batch of requests is about to run (coarse clocks re-read here)
+  virtual void tick() {}
+  // time carried by an event being applied (simulated clocks follow it)
+  virtual void observe(TimeStamp eventTime) { (void)eventTime; }
+
+  static TimeStamp now() {
+    return s_current.load(std::memory_order_acquire)->read();
+  }
+  static void refresh() { s_current.load(std::memory_order_acquire)->tick(); }
+  static void follow(TimeStamp eventTime) {
+    s_current.load(std::memory_order_acquire)->observe(eventTime);
+  }
+  // nullptr: back to the wall clock, returns the clock it replaced
+  // only while nothing else reads the time (Xchange::setClock quiesces)
+  static std::shared_ptr<Clock> install(std::shared_ptr<Clock> clock);
+  static std::shared_ptr<Clock> installed();
+
+private:
+  static std::atomic<Clock *> s_current;
+  static std::shared_ptr<Clock> s_installed; // keeps s_current alive
+};
+
+class WallClock : public Clock {
+public:
+  TimeStamp read() const override { return std::chrono::system_clock::now(); }
+};
+
+// readings may lag the wall clock by one batch, never run backwards
+class CoarseClock : public Clock {
+public:
+  CoarseClock() { CoarseClock::tick(); }
+  TimeStamp read() const override {
+    return TimeStamp{TimeStamp::duration{m_now.load(std::memory_order_relaxed)}};
+  }
+  void tick() override;
+
+private:
+  std::atomic<TimeStamp::rep> m_now{0};
+};
+
+// only moves forward: set/advance by whoever drives it, observe by replay
+class SimulatedClock : public Clock {
+public:
+  explicit SimulatedClock(TimeStamp start)
+      : m_now{start.time_since_epoch().count()} {}
+  TimeStamp read() const override {
+    return TimeStamp{TimeStamp::duration{m_now.load(std::memory_order_relaxed)}};
+  }
+  void observe(TimeStamp eventTime) override { SimulatedClock::set(eventTime); }
+  void set(TimeStamp time);
+  void advance(TimeStamp::duration by) { SimulatedClock::set(read() + by); }
+
+private:
+  std::atomic<TimeStamp::rep> m_now;
+};
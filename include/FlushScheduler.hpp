@@ -0,0 +1,41 @@
+#pragma once
+
+#include "utils/alias/SymbolInfoRel.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// background thread driving the time based flush (and activation/expiry
+// timers) of every symbol's preprocessors: once a tick it reads each
+// preprocessor's next due time (an atomic, no lock) & only takes the
+// symbol's lock to flush the due ones, so a buffered order waits at most
+// the pending duration + 1 tick even when nothing else arrives for it
+class FlushScheduler {
+public:
+  explicit FlushScheduler(
+      std::chrono::milliseconds tick = std::chrono::milliseconds(1));
+  FlushScheduler(const FlushScheduler &) = delete;
+  FlushScheduler &operator=(const FlushScheduler &) = delete;
+  ~FlushScheduler(); // joins, symbols back to flush on insert
+
+  void add(const SymbolInfoPointer &symbolInfo);
+  void remove(const SymbolInfoPointer &symbolInfo);
+  // no pass runs while the returned lock is held
+  std::unique_lock<std::mutex> pause();
+
+private:
+  void run();
+  void pass();
+  static void setScheduled(const SymbolInfoPointer &symbolInfo, bool scheduled);
+
+  std::chrono::milliseconds m_tick;
+  std::mutex m_running; // held for a whole pass (pause)
+  std::mutex m_mutex;   // targets & stop flag, always after m_running
+  std::condition_variable m_wake;
+  std::vector<SymbolInfoPointer> m_targets;
+  bool m_stopping{false};
+  std::thread m_thread;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/alias/Fundamental.hpp"
+
+// string <-> dense 32 bit handle, handed out in arrival order (never reused)
+// core (book, trades, records) passes handles, names resolved at the edges
+class InternTable {
+public:
+  InternHandle intern(const std::string &name); // existing or fresh handle
+  InternHandle find(const std::string &name) const; // InvalidHandle if unseen
+  const std::string &name(InternHandle handle) const { return m_names.at(handle); }
+  bool contains(InternHandle handle) const { return handle < m_names.size(); }
+  std::size_t size() const { return m_names.size(); }
+
+private:
+  std::vector<std::string> m_names; // handle -> name
+  std::unordered_map<std::string, InternHandle> m_handles;
+};
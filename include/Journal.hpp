@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/alias/Fundamental.hpp"
+#include "utils/enums/Actions.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+// append-only binary write-ahead log of everything the exchange accepted
+// (participants & symbols in/out, every add/modify/cancel), in order,
+// one monotonic sequence number per event
+// appends go to a user space buffer, durability is group committed:
+// write + fdatasync once every N events or T microseconds (whichever first),
+// a background flusher commits what a quiet exchange left pending once T is up
+// replay hands the events back in order (stops at a torn tail)
+using JournalSequence = std::uint64_t; // 1 = first event, 0 = none yet
+
+struct JournalOptions {
+  std::size_t commitEvents = 1024; // fsync at latest every N events
+  std::chrono::microseconds commitInterval{1000}; // or T since last commit
+  bool sync = true; // false: write(2) only (page cache, survives crashes
+                    // of the process, not of the machine)
+};
+
+class Journal {
+public:
+  enum class EventType : std::uint8_t {
+    RegisterParticipant,
+    RemoveParticipant,
+    TradeSymbol,
+    RetireSymbol,
+    PlaceOrder
+  };
+
+  // one decoded event (replay side)
+  struct Event {
+    JournalSequence sequence{0};
+    TimeStamp time{};
+    EventType type{EventType::PlaceOrder};
+    std::string name; // govID / participantID / symbol of the name events
+
+    ParticipantHandle participant{InvalidHandle};
+    SymbolHandle symbol{InvalidHandle};
+    Actions::Actions action{Actions::Actions::Add};
+    std::optional<OrderID> oldOrderID;
+    std::optional<Side::Side> side;
+    std::optional<OrderType::OrderType> orderType;
+    std::optional<Price> price; // ticks
+    std::optional<Quantity> quantity;
+    std::optional<TimeStamp> activationTime;
+    std::optional<TimeStamp> deactivationTime;
+    std::optional<OrderID> orderID; // given to the order it created
+  };
+  using EventVisitor = std::function<void(const Event &event)>;
+
+  // opens (creates) path for append, a torn tail is cut off first &
+  // sequences continue after the last complete event
+  explicit Journal(const std::string &path, JournalOptions options = {});
+  Journal(const Journal &) = delete;
+  Journal &operator=(const Journal &) = delete;
+  ~Journal(); // stops the flusher, commits what is buffered
+
+  JournalSequence appendName(EventType type, const std::string &name);
+  JournalSequence appendOrder(
+      ParticipantHandle participant, Actions::Actions action,
+      const std::optional<OrderID> &oldOrderID, SymbolHandle symbol,
+      const std::optional<Side::Side> &side,
+      const std::optional<OrderType::OrderType> &orderType,
+      const std::optional<Price> &price,
+      const std::optional<Quantity> &quantity,
+      const std::optional<TimeStamp> &activationTime,
+      const std::optional<TimeStamp> &deactivationTime,
+      const std::optional<OrderID> &orderID);
+  // write out & (options.sync) fdatasync everything appended so far
+  // a failed write can be retried, a failed sync leaves the journal unusable
+  // (every later append/commit throws)
+  void commit();
+  // drops everything appended since the last commit (buffered or already
+  // partly written): the file ends at the last commit again
+  void rollback();
+
+  JournalSequence getLastSequence() const { return m_lastSequence; }
+  JournalSequence getCommittedSequence() const {
+    return m_committedSequence.load(std::memory_order_acquire);
+  }
+  const std::string &getPath() const { return m_path; }
+
+  // every complete event of the file in order (those up to after are
+  // skipped undecoded), returns the last sequence
+  static JournalSequence replay(const std::string &path,
+                                const EventVisitor &visitor,
+                                JournalSequence after = 0);
+
+private:
+  // on disk: header then payload (little endian host layout, same machine)
+  struct Header {
+    std::uint32_t length; // payload bytes
+    EventType type;
+    std::uint8_t reserved[3];
+    std::uint32_t checksum; // CRC32C of header (this field 0) & payload
+    std::uint32_t padding;
+    JournalSequence sequence;
+    std::int64_t time; // system clock ticks
+  };
+
+  void beginEvent(EventType type);
+  JournalSequence endEvent();
+  void put(const void *data, std::size_t size);
+  void commitLocked();
+  void writeOut();
+  void checkUsable() const; // throws once a sync failed
+  void flushWhenDue();      // flusher thread
+  // scans path: last complete sequence & byte length of the complete prefix
+  static JournalSequence scan(const std::string &path, std::size_t &validBytes,
+                              const EventVisitor *visitor,
+                              JournalSequence after = 0);
+
+  std::string m_path;
+  JournalOptions m_options;
+  int m_fd{-1};
+  std::vector<char> m_buffer; // events appended since the last write out
+  std::size_t m_eventStart{0}; // header offset of the event being encoded
+  std::size_t m_pendingEvents{0};
+  std::size_t m_fileBytes{0};      // written so far
+  std::size_t m_committedBytes{0}; // of which synced by the last commit
+  std::chrono::steady_clock::time_point m_lastCommit;
+  JournalSequence m_lastSequence{0};
+  std::atomic<JournalSequence> m_committedSequence{0};
+  bool m_syncFailed{false};
+  // appends, commits & the flusher take turns on the buffer & the file
+  std::mutex m_mutex;
+  std::condition_variable m_wake; // first pending event, closing
+  bool m_closing{false};
+  std::thread m_flusher;
+};
@@ -2,42 +2,89 @@
 #pragma once
 
 #include <cassert>
-#include <unordered_map>
+#include <cstddef>
+#include <iterator>
 
-#include "include/Order.hpp"
+#include "include/OrderPool.hpp"
+#include "include/OrderRecord.hpp"
 #include "utils/alias/Fundamental.hpp"
 #include "utils/alias/OrderRel.hpp"
 
 class Level {
 public:
-  struct OrderPointerInfo {
-    OrderPointer order{nullptr};             // store pointer to order
-    OrderList::iterator orderListIterator{}; // store loc in list
-  };
-
   Level() = default;
-  Level(Symbol Symbol, Price price, Quantity quantity);
+  // orders at the level live in the (book owned) pool, level keeps the links
+  Level(Symbol Symbol, Price price, Quantity quantity, OrderPool &pool);
 
   // core level functionality
-  void AddOrder(Order &order);
-  void CancelOrder(OrderID orderID);
-  void ModifyOrder(OrderID oldOrderID, Order &ModifiedOrder);
+  // orders are addressed by pool slot (book's OrderIndex maps orderID->slot)
+  SlotIndex AddOrder(const OrderRecord &record); // slot the copy landed in
+  void CancelOrder(SlotIndex slot);
+  SlotIndex ModifyOrder(SlotIndex oldSlot, const OrderRecord &modifiedRecord);
+  // same price, less quantity: rewrite record inside its slot (keeps priority)
+  void AmendOrder(SlotIndex slot, const OrderRecord &amendedRecord);
 
   // sanity maintainence functionality
   void UpdateLevelQuantityPostMatch(Quantity filledQuantity);
-  void removeMatchedOrder(OrderID orderID);
+  void removeMatchedOrder(SlotIndex slot);
 
   // getters
   Price getPrice() const { return m_price; }
   Quantity getQuantity() const { return m_quantity; }
-  OrderList getOrderList() const { return m_orderList; }
-  TimeStamp getActivationTime(const OrderID &orderID);
-  TimeStamp getDeactivationTime(const OrderID &orderID);
+
+  // walks the FIFO oldest to newest, orders are viewed inside their slots
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = OrderRecord;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const OrderRecord *;
+    using reference = const OrderRecord &;
+
+    const_iterator() = default;
+    const_iterator(const OrderPool *pool, SlotIndex slot)
+        : m_pool{pool}, m_slot{slot} {}
+
+    reference operator*() const { return (*m_pool)[m_slot]; }
+    pointer operator->() const { return &(*m_pool)[m_slot]; }
+    const_iterator &operator++() {
+      m_slot = (*m_pool)[m_slot].links.next;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator old = *this;
+      ++(*this);
+      return old;
+    }
+    bool operator==(const const_iterator &other) const {
+      return m_slot == other.m_slot;
+    }
+
+  private:
+    const OrderPool *m_pool{nullptr};
+    SlotIndex m_slot{NullSlot};
+  };
+
+  // zero copy view of the FIFO queue (valid till the level is modified)
+  SlotIndex frontSlot() const { return m_head; }
+  OrderRecord &front() { return (*m_pool)[m_head]; }
+  const OrderRecord &front() const { return (*m_pool)[m_head]; }
+  std::size_t getOrderCount() const { return m_orderCount; }
+  bool empty() const { return m_orderCount == 0; }
+  const_iterator begin() const { return const_iterator(m_pool, m_head); }
+  const_iterator end() const { return const_iterator(m_pool, NullSlot); }
+
+  TimeStamp getActivationTime(SlotIndex slot) const;
+  TimeStamp getDeactivationTime(SlotIndex slot) const;
 
 private:
+  void unlink(SlotIndex slot); // detach from FIFO & give slot back to pool
+
   Symbol m_symbol;
   Price m_price;
-  Quantity m_quantity;   // aggregated quantity on the level
-  OrderList m_orderList; // list of orders at the level
-  std::unordered_map<OrderID, OrderPointerInfo> m_info; // quick info access
+  Quantity m_quantity; // aggregated quantity on the level
+  OrderPool *m_pool{nullptr};
+  SlotIndex m_head{NullSlot}; // oldest order (first to match)
+  SlotIndex m_tail{NullSlot}; // newest order
+  std::size_t m_orderCount{0};
 };
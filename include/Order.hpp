@@ -1,5 +1,6 @@
 #pragma once
 
+#include "include/OrderIdGenerator.hpp"
 #include "utils/alias/Fundamental.hpp"
 #include "utils/enums/OrderStatus.hpp"
 #include "utils/enums/OrderTypes.hpp"
@@ -7,23 +8,51 @@
 
 #include <cassert>
 #include <chrono>
+#include <optional>
 
 class Order {
 public:
   // various constructors
   Order() = default;
+  // price in currency units, active now till the end of time (next id)
   Order(const Symbol symbol, const OrderType::OrderType orderType,
         const Side::Side side, const double price, const Quantity quantity,
-        const ParticipantID &participantID,
-        const std::string &activationTime = "",
-        const std::string &deactivationTime = "");
-  Order(const Order &other); // copy constructor
+        const ParticipantID &participantID);
+  // price in ticks, Constants::Now activates on entry, Constants::EndOfTime
+  // never deactivates (nullopt: next id); nothing parsed per order
+  Order(const Symbol &symbol, const OrderType::OrderType orderType,
+        const Side::Side side, const Price price, const Quantity quantity,
+        const ParticipantID &participantID, TimeStamp activationTime,
+        TimeStamp deactivationTime,
+        std::optional<OrderID> orderID = std::nullopt);
+  // rebuilt from a snapshot: every attribute as saved, nothing re-derived
+  Order(const Symbol &symbol, const OrderType::OrderType orderType,
+        const Side::Side side, const Price price, const Quantity remaining,
+        const ParticipantID &participantID, ParticipantHandle participant,
+        TimeStamp orderTime, OrderID orderID, TimeStamp activationTime,
+        TimeStamp deactivationTime, OrderStatus::OrderStatus orderStatus);
+  // copy everything (participant & entry time included), assignment lets
+  // pool slots be refilled in place
+  Order(const Order &other) = default;
+  Order &operator=(const Order &other) = default;
 
   // time functionality
   static std::string
   returnReadableTime(const std::chrono::system_clock::time_point &tt);
-  static TimeStamp convertDateTimeToTimeStamp(const std::string &s);
-  OrderID encodeOrderID(TimeStamp timestamp, Price price, bool isBid);
+  // exactly dd-mm-yyyy hh:mm:ss, wall time in zone (std::runtime_error
+  // otherwise): a time repeated by a DST change is the earlier instant, a
+  // time skipped by one is a std::runtime_error
+  static TimeStamp convertDateTimeToTimeStamp(const std::string &s,
+                                              const std::chrono::time_zone *zone);
+  // string edge (Xchange's string placeOrder only): "" / "NOW" ->
+  // Constants::Now, "" / "EOT" -> Constants::EndOfTime, else the above
+  static TimeStamp parseActivationTime(const std::string &activationTime,
+                                       const std::chrono::time_zone *zone);
+  static TimeStamp parseDeactivationTime(const std::string &deactivationTime,
+                                         const std::chrono::time_zone *zone);
+  static Price toTicks(double price);
+  // the process wide sequence new orders draw their ids from
+  static OrderIdGenerator &getIdGenerator();
 
   bool operator<(const Order &other) const;
   bool operator==(const Order &other) const;
@@ -32,7 +61,7 @@ public:
   bool isFullyFilled();
 
   // const member fns: can't change val of data member
-  Symbol getSymbol() const { return m_symbol; }
+  const Symbol &getSymbol() const { return m_symbol; }
   OrderType::OrderType getOrderType() const { return m_orderType; }
   Side::Side getSide() const { return m_side; }
   Price getPrice() const { return m_price; }
@@ -41,7 +70,9 @@ public:
   TimeStamp getOrderTime() const { return m_timestamp; }
   TimeStamp getActivationTime() const { return m_activateTime; }
   TimeStamp getDeactivationTime() const { return m_deactivateTime; }
-  ParticipantID getParticipantID() const { return m_participantID; }
+  const ParticipantID &getParticipantID() const { return m_participantID; }
+  // interned participantID (InvalidHandle till the exchange stamps it)
+  ParticipantHandle getParticipantHandle() const { return m_participantHandle; }
   OrderStatus::OrderStatus getOrderStatus() const { return m_orderStatus; }
 
   void printTimeInfo() const;
@@ -51,6 +82,9 @@ public:
   void setOrderType(OrderType::OrderType newType) { m_orderType = newType; }
   void setActivationTime(TimeStamp newtime) { m_activateTime = newtime; }
   void setDeactivationTime(TimeStamp newtime) { m_deactivateTime = newtime; }
+  void setParticipantHandle(ParticipantHandle handle) {
+    m_participantHandle = handle;
+  }
   void setOrderStatus(OrderStatus::OrderStatus newOrderStatus) {
     m_orderStatus = newOrderStatus;
   }
@@ -64,6 +98,7 @@ private:
   Price m_price;
   Quantity m_remQuantity;
   ParticipantID m_participantID;
+  ParticipantHandle m_participantHandle{InvalidHandle};
   TimeStamp m_timestamp;
   OrderID m_orderID;
   TimeStamp m_activateTime;
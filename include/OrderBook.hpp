@@ -1,39 +1,97 @@
 #pragma once
 
-#include <functional>
-#include <map>
+#include <cassert>
+#include <cstddef>
 #include <optional>
+#include <span>
+#include <utility>
+#include <vector>
 
+#include "include/InternTable.hpp"
 #include "include/Order.hpp"
+#include "include/OrderIndex.hpp"
+#include "include/OrderPool.hpp"
+#include "include/OrderRecord.hpp"
 #include "include/Trade.hpp"
+#include "include/TradeLog.hpp"
 #include "utils/alias/Fundamental.hpp"
+#include "utils/alias/InternRel.hpp"
 #include "utils/alias/LevelRel.hpp"
+#include "utils/alias/PriceLadderRel.hpp"
+#include "utils/alias/TradeRel.hpp"
 #include "utils/enums/Side.hpp"
 
 class OrderBook {
 private:
   Symbol m_symbol;
-  std::map<Price, LevelPointer, std::greater<Price>> m_bids; // max bid tradable
-  std::map<Price, LevelPointer, std::less<Price>> m_asks;    // min ask tradable
+  // name tables (shared w the exchange, own ones when standalone)
+  InternTablePointer m_symbolNames;
+  InternTablePointer m_participantNames;
+  SymbolHandle m_symbolHandle; // m_symbol interned (stamped on every fill)
+  // resting orders of both sides (declared first: outlives the levels)
+  OrderPool m_orderPool;
+  // orderID -> (level, slot) of every resting order
+  OrderIndex m_orderIndex;
+  // participant handle -> newest resting order (chain runs through the slots)
+  std::vector<SlotIndex> m_participantOrders;
+  BidLadder m_bids; // max bid tradable
+  AskLadder m_asks; // min ask tradable
 
-  // all trades that occur (reset mechanism & backup needed for atleast this)
-  std::vector<Trade> m_trades;
+  // all trades that occur: bounded in memory, older segments spilled to disk
+  TradeLog m_trades;
+  // fills of the latest sweep (cleared per aggressor, capacity reused)
+  Trades m_lastFills;
+  // per side consumers (preprocessors), called once per fill of that side
+  FillListener m_bidFillListener;
+  FillListener m_askFillListener;
+  // called after both sides' listeners (routes the trade to its participants)
+  TradeListener m_tradeListener;
 
 public:
-  // various constructors
-  OrderBook() = default;
-  OrderBook(Symbol symbol) : m_symbol{symbol} {}
-  // linker error initially since copy constr not implemented before
-  OrderBook(OrderBook &ob) = default; // copy constructor
-
-  // made static since stay same across all instances
-  static Price decodePriceFromOrderID(const OrderID orderID);
-  static Side::Side decodeSideFromOrderID(const OrderID orderID);
+  // various constructors (name tables: nullptr -> book keeps its own)
+  OrderBook() : OrderBook(Symbol{}) {}
+  OrderBook(Symbol symbol, InternTablePointer symbolNames = nullptr,
+            InternTablePointer participantNames = nullptr)
+      : m_symbol{symbol}, m_symbolNames{ownIfNull(symbolNames)},
+        m_participantNames{ownIfNull(participantNames)},
+        m_symbolHandle{m_symbolNames->intern(symbol)} {}
+  // ladder mode: ticks wide array of levels per side (centered on first order)
+  OrderBook(Symbol symbol, std::size_t ladderTicks,
+            InternTablePointer symbolNames = nullptr,
+            InternTablePointer participantNames = nullptr)
+      : m_symbol{symbol}, m_symbolNames{ownIfNull(symbolNames)},
+        m_participantNames{ownIfNull(participantNames)},
+        m_symbolHandle{m_symbolNames->intern(symbol)}, m_bids{ladderTicks},
+        m_asks{ladderTicks} {}
+  OrderBook(Symbol symbol, Price referencePrice, std::size_t ladderTicks,
+            InternTablePointer symbolNames = nullptr,
+            InternTablePointer participantNames = nullptr)
+      : m_symbol{symbol}, m_symbolNames{ownIfNull(symbolNames)},
+        m_participantNames{ownIfNull(participantNames)},
+        m_symbolHandle{m_symbolNames->intern(symbol)},
+        m_bids{referencePrice, ladderTicks},
+        m_asks{referencePrice, ladderTicks} {}
+  // levels link into this book's order pool, a copy would share its slots
+  OrderBook(const OrderBook &ob) = delete;
 
   // core functionality of orderbook
-  std::optional<Trade> AddOrder(Order &order);
+  // returned batch stays valid till the next call into the orderbook
+  TradeBatch AddOrder(Order &order);
   std::optional<Trade> CancelOrder(OrderID orderID);
-  std::optional<Trade> ModifyOrder(OrderID orderID, Order &modifiedOrder);
+  // quantity down at same price is amended in place (queue priority kept),
+  // anything else is cancel/replace (back of the queue, may match)
+  TradeBatch ModifyOrder(OrderID orderID, Order &modifiedOrder);
+  bool canAmendInPlace(OrderID orderID, const Order &modifiedOrder) const;
+  // pulls every resting order of the participant, returns #orders cancelled
+  std::size_t CancelAllForParticipant(const ParticipantID &participantID);
+  std::size_t CancelAllForParticipant(ParticipantHandle participant);
+  // rests a record as is (no matching): rebuilding a book from a snapshot
+  void RestoreResting(const OrderRecord &record);
+  // snapshot restore: the saved log appended in sequence (no listeners)
+  void RestoreTrades(std::span<const Trade> trades);
+  bool isResting(OrderID orderID) const {
+    return m_orderIndex.find(orderID) != nullptr;
+  }
 
   void printOrderBookState(const std::string &message = "");
 
@@ -48,16 +106,67 @@ public:
 
   // matching functionality
   bool CanMatchOrder(Side::Side side, Price price) const;
-  std::optional<Trade> MatchPotentialOrders();
+  // opposite side's quantity an order of side at price could match now
+  // (cumulative depth, O(log ticks): no walk over the levels)
+  Quantity getMatchableQuantity(Side::Side side, Price price) const;
+  TradeBatch MatchPotentialOrders(); // sweeps till book is uncrossed
 
-  // store the levels for each side
-  std::map<Price, LevelPointer, std::greater<Price>> getBidLevels() const {
-    return m_bids;
-  };
-  std::map<Price, LevelPointer, std::less<Price>> getAskLevels() const {
-    return m_asks;
-  };
+  // store the levels for each side (views, no copies)
+  const BidLadder &getBidLevels() const { return m_bids; };
+  const AskLadder &getAskLevels() const { return m_asks; };
 
   Symbol getSymbol() const { return m_symbol; } // symbol getter
-  std::vector<Trade> getTrades() { return m_trades; }
+  SymbolHandle getSymbolHandle() const { return m_symbolHandle; }
+  // resolve handles carried by records & fills back to names
+  const InternTable &getSymbolNames() const { return *m_symbolNames; }
+  const InternTable &getParticipantNames() const { return *m_participantNames; }
+  const TradeLog &getTrades() const { return m_trades; }
+  // segment size, resident segments, spill file (before the first trade)
+  void setTradeLog(TradeLog trades) {
+    assert(m_trades.empty());
+    m_trades = std::move(trades);
+  }
+
+  // paged trade cursor: consumers remember getTradeSequence() & later ask
+  // only for what was appended since (spilled trades read back transparently)
+  TradeSequence getTradeSequence() const { return m_trades.size(); }
+  TradeLog::Range getTradesSince(TradeSequence sequence) const {
+    return m_trades.since(sequence);
+  }
+  // pre-size trade storage (no reallocation on the match path till count)
+  void reserveTrades(std::size_t count) {
+    m_trades.reserve(count);
+    m_lastFills.reserve(count);
+  }
+  // pre-carve order slots & index buckets (no growth on add path till count)
+  void reserveOrders(std::size_t count) {
+    m_orderPool.reserve(count);
+    m_orderIndex.reserve(count);
+  }
+  const OrderPool &getOrderPool() const { return m_orderPool; }
+
+  // push model: consumer sees only its side's fills, as they happen
+  // (empty listener unsubscribes)
+  void setFillListener(Side::Side side, FillListener listener) {
+    if (side == Side::Side::Buy)
+      m_bidFillListener = std::move(listener);
+    else
+      m_askFillListener = std::move(listener);
+  }
+  void setTradeListener(TradeListener listener) {
+    m_tradeListener = std::move(listener);
+  }
+
+private:
+  static InternTablePointer ownIfNull(InternTablePointer table) {
+    return table ? table : std::make_shared<InternTable>();
+  }
+  OrderRecord makeRecord(const Order &order); // interns unseen participants
+  void restRecord(const OrderRecord &record);
+  ParticipantHandle findParticipant(const Order &order) const;
+  void cancelResting(Level *level, SlotIndex slot);
+  void removeDepth(Side::Side side, Price price, Quantity quantity);
+  void forgetResting(SlotIndex slot); // drop index entry & participant link
+  void linkParticipant(SlotIndex slot);
+  void unlinkParticipant(SlotIndex slot);
 };
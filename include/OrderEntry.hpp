@@ -0,0 +1,102 @@
+#pragma once
+
+#include "include/OrderRequest.hpp"
+#include "utils/Constants.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class Xchange;
+
+// binary order entry in front of Xchange::placeOrder: fixed layout, little
+// endian messages carrying interned handles, prices in ticks & times as ns
+// since the epoch (no names, doubles or date strings on the wire)
+// header (8): u16 length, u8 type, u8 version, u32 participant handle
+//   NewOrder     (48): u32 symbol, i32 price, u64 quantity, u8 side,
+//                      u8 orderType, 6 reserved, i64 activation (0: now),
+//                      i64 deactivation (0: end of time)
+//   ReplaceOrder (56): NewOrder's fields, then u64 id of the order replaced
+//   CancelOrder  (24): u32 symbol, u8 side, u8 orderType, 2 reserved,
+//                      u64 id of the order cancelled
+namespace OrderEntry {
+enum class MessageType : std::uint8_t {
+  NewOrder = 1,
+  ReplaceOrder = 2,
+  CancelOrder = 3
+};
+
+inline constexpr std::uint8_t Version = 1;
+inline constexpr std::size_t HeaderBytes = 8;
+inline constexpr std::size_t NewOrderBytes = 48;
+inline constexpr std::size_t ReplaceOrderBytes = 56;
+inline constexpr std::size_t CancelOrderBytes = 24;
+
+// load generators: whole messages appended to a caller owned buffer
+// (clear & refill it, capacity is kept)
+class Encoder {
+public:
+  explicit Encoder(std::vector<char> &buffer) : m_buffer{buffer} {}
+
+  void newOrder(ParticipantHandle participant, SymbolHandle symbol,
+                Side::Side side, OrderType::OrderType orderType, Price price,
+                Quantity quantity, TimeStamp activationTime = Constants::Now,
+                TimeStamp deactivationTime = Constants::EndOfTime);
+  void replaceOrder(ParticipantHandle participant, OrderID oldOrderID,
+                    SymbolHandle symbol, Side::Side side,
+                    OrderType::OrderType orderType, Price price,
+                    Quantity quantity,
+                    TimeStamp activationTime = Constants::Now,
+                    TimeStamp deactivationTime = Constants::EndOfTime);
+  void cancelOrder(ParticipantHandle participant, OrderID orderID,
+                   SymbolHandle symbol, Side::Side side,
+                   OrderType::OrderType orderType);
+
+private:
+  char *append(MessageType type, std::size_t bytes,
+               ParticipantHandle participant);
+
+  std::vector<char> &m_buffer;
+};
+
+// reads the fields where they lie in the caller's buffer (no copy of the
+// message, nothing allocated) into one reused request per message
+// a malformed message (unknown type/version, wrong length, side or order
+// type out of range) is acked as rejected & decoding stops in front of it:
+// the stream can't be trusted past it, drop the session
+// a well formed request placeOrder refuses (throws) is rejected on its own
+// ack, the messages after it are still placed
+class Decoder {
+public:
+  // after every message: the request as placed, what placeOrder returned &
+  // why it was rejected (empty when placed)
+  using Acknowledge = std::function<void(const OrderRequest &request,
+                                         const std::optional<OrderID> &orderID,
+                                         std::string_view rejected)>;
+
+  explicit Decoder(Xchange &xchange, Acknowledge acknowledge = nullptr)
+      : m_xchange{xchange}, m_acknowledge{std::move(acknowledge)} {}
+
+  // every whole message in [data, data + size) placed in order, returns the
+  // bytes consumed (a message cut off at the end waits for the next call,
+  // a malformed one stops it: consumed ends where that message starts)
+  std::size_t decode(const char *data, std::size_t size);
+
+  // one message at data into request: its length, 0 if not all there yet,
+  // std::runtime_error if malformed
+  static std::size_t parse(const char *data, std::size_t size,
+                           OrderRequest &request);
+
+private:
+  Xchange &m_xchange;
+  Acknowledge m_acknowledge;
+  OrderRequest m_request;
+};
+} // namespace OrderEntry
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "utils/alias/Fundamental.hpp"
+
+#include <atomic>
+
+// order ids: one 64 bit sequence handed out in acceptance order, so among
+// equal prices the smaller id came first (time priority without a clock)
+// ids are never reused; replay & restore only move it past the ids they
+// bring back (price & side travel with the order, nothing is packed in)
+class OrderIdGenerator {
+public:
+  explicit OrderIdGenerator(OrderID first = 1) : m_next{first} {}
+
+  OrderID next() { return m_next.fetch_add(1, std::memory_order_relaxed); }
+  OrderID peek() const { return m_next.load(std::memory_order_relaxed); }
+  // next() hands out at least next from now on (never goes back)
+  void advanceTo(OrderID next) {
+    OrderID current = m_next.load(std::memory_order_relaxed);
+    while (next > current &&
+           !m_next.compare_exchange_weak(current, next,
+                                         std::memory_order_relaxed)) {
+    }
+  }
+
+private:
+  std::atomic<OrderID> m_next;
+};
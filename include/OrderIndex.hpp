@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "utils/alias/Fundamental.hpp"
+#include "utils/alias/OrderRel.hpp"
+
+class Level;
+
+// book wide orderID -> resting order handle (level + pool slot)
+// open addressing, linear probing over a power of two table (load <= 1/2)
+// erase shifts the following run back (no tombstones, probes stay short)
+// cancel/modify: one probe instead of decoding price/side & 2 lookups
+class OrderIndex {
+public:
+  struct Entry {
+    OrderID orderID{0};
+    Level *level{nullptr}; // owned by the book's ladders
+    SlotIndex slot{NullSlot}; // NullSlot marks an empty bucket
+  };
+
+  explicit OrderIndex(std::size_t capacity = 64);
+
+  // nullptr if order is not resting in the book
+  const Entry *find(OrderID orderID) const;
+  bool insert(OrderID orderID, Level *level, SlotIndex slot); // false if dup
+  bool erase(OrderID orderID);
+  void reserve(std::size_t count); // no rehash on insert till count
+
+  std::size_t size() const { return m_size; }
+  std::size_t getCapacity() const { return m_table.size(); }
+
+private:
+  std::size_t home(OrderID orderID) const;
+  void rehash(std::size_t capacity);
+
+  std::vector<Entry> m_table;
+  std::size_t m_size{0};
+  unsigned m_shift{0}; // 64 - log2(capacity)
+};
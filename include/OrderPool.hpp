@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "include/OrderRecord.hpp"
+#include "utils/alias/OrderRel.hpp"
+
+// per book slab allocator for resting orders
+// slots are carved out of fixed size slabs (addresses never move), freed slots
+// are chained on a free list & handed out again before a new slab is carved
+// hence add/cancel stops touching the heap once the book is warm
+class OrderPool {
+public:
+  // a slot is one 64 byte record (links to level FIFO & participant inside)
+  using Slot = OrderRecord;
+
+  static constexpr std::size_t SlabBits = 10;
+  static constexpr std::size_t SlabSize = std::size_t{1} << SlabBits;
+
+  OrderPool() = default;
+  // slots point into slabs owned by this pool (levels hold indices)
+  OrderPool(const OrderPool &) = delete;
+  OrderPool &operator=(const OrderPool &) = delete;
+
+  SlotIndex acquire(const OrderRecord &record); // copies record into a slot
+  void release(SlotIndex slot);
+  void reserve(std::size_t count); // carve slabs upfront
+
+  Slot &operator[](SlotIndex slot) {
+    return m_slabs[slot >> SlabBits][slot & (SlabSize - 1)];
+  }
+  const Slot &operator[](SlotIndex slot) const {
+    return m_slabs[slot >> SlabBits][slot & (SlabSize - 1)];
+  }
+
+  std::size_t getCapacity() const { return m_slabs.size() * SlabSize; }
+  std::size_t getLiveCount() const { return m_liveCount; }
+
+private:
+  void carveSlab();
+
+  std::vector<std::unique_ptr<Slot[]>> m_slabs;
+  SlotIndex m_freeHead{NullSlot};
+  std::size_t m_liveCount{0};
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "utils/alias/Fundamental.hpp"
+#include "utils/alias/OrderRel.hpp"
+#include "utils/enums/OrderStatus.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+// resting order as the book stores it: one cache line, no strings, no
+// destructor (slots are memcpy-able & reused as is by the pool)
+// symbol & participant are interned handles, Order stays the edge object
+struct alignas(64) OrderRecord {
+  // intrusive links of the level FIFO & the participant chain
+  struct Links {
+    SlotIndex prev{NullSlot};
+    SlotIndex next{NullSlot}; // free list link while slot is unused
+    SlotIndex participantPrev{NullSlot};
+    SlotIndex participantNext{NullSlot};
+  };
+
+  OrderID orderID{0};
+  Quantity remQuantity{0};
+  TimeStamp activateTime{};
+  TimeStamp deactivateTime{};
+  Price price{0};
+  SymbolHandle symbol{InvalidHandle};
+  ParticipantHandle participant{InvalidHandle};
+  std::uint8_t orderType{0};
+  std::uint8_t side{0};
+  std::uint8_t orderStatus{0};
+  Links links{};
+
+  Side::Side getSide() const { return static_cast<Side::Side>(side); }
+  OrderType::OrderType getOrderType() const {
+    return static_cast<OrderType::OrderType>(orderType);
+  }
+  OrderStatus::OrderStatus getOrderStatus() const {
+    return static_cast<OrderStatus::OrderStatus>(orderStatus);
+  }
+  void setOrderStatus(OrderStatus::OrderStatus status) {
+    orderStatus = static_cast<std::uint8_t>(status);
+  }
+  void FillPartially(Quantity quantity) { remQuantity -= quantity; }
+  bool isFullyFilled() const { return remQuantity == 0; }
+};
+
+static_assert(sizeof(OrderRecord) == 64, "order record must fill one line");
+static_assert(std::is_trivially_copyable_v<OrderRecord>);
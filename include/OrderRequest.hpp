@@ -0,0 +1,35 @@
+#pragma once
+
+#include "utils/alias/Fundamental.hpp"
+#include "utils/enums/Actions.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <optional>
+#include <string>
+
+// one placeOrder call (handles resolved, typed: price in ticks,
+// Constants::Now / Constants::EndOfTime for NOW / EOT)
+struct OrderRequest {
+  ParticipantHandle participant{InvalidHandle};
+  Actions::Actions action{Actions::Actions::Add};
+  std::optional<OrderID> oldOrderID;
+  SymbolHandle symbol{InvalidHandle};
+  std::optional<Side::Side> side;
+  std::optional<OrderType::OrderType> orderType;
+  std::optional<Price> price;
+  std::optional<Quantity> quantity;
+  std::optional<TimeStamp> activationTime;
+  std::optional<TimeStamp> deactivationTime;
+  std::optional<OrderID> orderID; // of the order it creates (on acceptance)
+};
+
+// outcome of a request executed off the caller's thread (shard/pipeline)
+struct ExecutionReport {
+  ParticipantHandle participant{InvalidHandle};
+  SymbolHandle symbol{InvalidHandle};
+  Actions::Actions action{Actions::Actions::Add};
+  std::optional<OrderID> orderID; // the one placeOrder returned
+  bool accepted{true};
+  std::string reason; // why not accepted
+};
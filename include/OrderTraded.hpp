@@ -2,29 +2,32 @@
 
 #include "utils/alias/Fundamental.hpp"
 
+#include <type_traits>
+
+// one side of a fill: handles only (names resolved by whoever reports it),
+// trivially copyable so a fill never touches the heap
 struct OrderTraded {
-  Symbol symbol;
-  OrderID orderID;
-  double price;
-  Quantity quantityFilled;
-  ParticipantID participantID;
+  SymbolHandle symbol{InvalidHandle};
+  OrderID orderID{0};
+  double price{0};
+  Quantity quantityFilled{0};
+  ParticipantHandle participant{InvalidHandle};
 
   OrderTraded() = default;
 
-  // need to make params type as const so that r-vals can be accepted too
-  OrderTraded(const Symbol &symbol, const OrderID &orderID, const double price,
-              const Quantity quantityFilled, const ParticipantID participantID)
+  OrderTraded(const SymbolHandle symbol, const OrderID orderID,
+              const double price, const Quantity quantityFilled,
+              const ParticipantHandle participant)
       : symbol{symbol}, orderID{orderID}, price{price},
-        quantityFilled{quantityFilled}, participantID{participantID} {
+        quantityFilled{quantityFilled}, participant{participant} {
     ;
   }
 
-  const Symbol &getSymbol() const noexcept { return symbol; }
+  SymbolHandle getSymbol() const noexcept { return symbol; }
   OrderID getOrderID() const noexcept { return orderID; }
   double getPrice() const noexcept { return price; }
   Quantity getQuantityFilled() const noexcept { return quantityFilled; }
-  const ParticipantID &getParticipantID() const noexcept {
-    return participantID;
-  }
-  ~OrderTraded() = default;
+  ParticipantHandle getParticipant() const noexcept { return participant; }
 };
+
+static_assert(std::is_trivially_copyable_v<OrderTraded>);
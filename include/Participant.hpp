@@ -2,16 +2,20 @@
 
 #include "include/Trade.hpp"
 #include "utils/alias/Fundamental.hpp"
+#include "utils/alias/InternRel.hpp"
 #include "utils/alias/OrderRel.hpp"
 #include "utils/enums/Actions.hpp"
 #include "utils/enums/OrderTypes.hpp"
 #include "utils/enums/Side.hpp"
 #include <cstddef>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
 class Participant
 {
+  friend class Snapshot; // saves & restores the private state as is
+
 private:
   struct ParticipantOrderInfo
   {
@@ -31,6 +35,10 @@ private:
   };
 
   ParticipantID m_participantID;
+  // handle fills carry for this participant (stamped by the exchange)
+  ParticipantHandle m_participantHandle{InvalidHandle};
+  // resolves fill symbol handles to portfolio names
+  InternTablePointer m_symbolNames;
   Portfolio m_portfolio;
   std::string localTimeZone;
 
@@ -43,17 +51,29 @@ public:
   Participant(const std::string &localTimeZoneOfParticipant);
   Participant();
 
+  // price in ticks, Constants::Now / Constants::EndOfTime for NOW / EOT
+  // (what the exchange records, nothing parsed per order)
   OrderPointer recordNonCancelOrder(const Actions::Actions action,
                                     const Symbol &symbol,
                                     const OrderType::OrderType orderType,
-                                    const Side::Side side, const double price,
+                                    const Side::Side side, const Price price,
                                     const Quantity quantity,
                                     const ParticipantID &participantID,
-                                    const std::string &activationTime = "",
-                                    const std::string &deactivationTime = "");
+                                    TimeStamp activationTime,
+                                    TimeStamp deactivationTime,
+                                    std::optional<OrderID> assignedID = std::nullopt);
+  // price in currency units, active now till the end of time
+  OrderPointer recordNonCancelOrder(const Actions::Actions action,
+                                    const Symbol &symbol,
+                                    const OrderType::OrderType orderType,
+                                    const Side::Side side, const double price,
+                                    const Quantity quantity,
+                                    const ParticipantID &participantID);
 
   void recordCancelOrder(const OrderID &orderID);
 
+  // pushed by the exchange for every trade this participant is a leg of
+  void recordTrade(const Trade &trade);
   void recordTrades(const std::vector<Trade> &recentTrades);
   void updatePortfolio(const Side::Side &side, const Trade &trade);
   void updateOrderStatus(const OrderID &matchedID);
@@ -77,9 +97,11 @@ public:
   std::size_t getNumberOfCancelledOrders() const;
   std::size_t getNumberOfProcessedOrders() const;
 
-  static std::size_t lastProcessedTradeIndex;
   std::size_t getNumberOfTrades() const;
   std::vector<Trade> getHistoryOfTrades() const;
 
   void setParticipantID(const ParticipantID &newID);
+  ParticipantHandle getParticipantHandle() const { return m_participantHandle; }
+  void setParticipantHandle(ParticipantHandle handle);
+  void setSymbolNames(InternTablePointer symbolNames);
 };
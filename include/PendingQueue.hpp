@@ -0,0 +1,116 @@
+#pragma once
+
+#include "utils/alias/Fundamental.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// buffered actions of one order type, drained in priority order (T's <)
+// sorted vector with tombstones: insert appends, erase only forgets the
+// order (its slot dies in place), drain sorts what arrived since the last
+// one, merges it into the sorted survivors & walks the lot once, dead
+// slots are compacted in bulk afterwards (no copy of the queue, no per
+// element allocation while flushing)
+// T: orderID member & operator<, at most one live entry per order
+template <typename T> class PendingQueue {
+public:
+  // false if the order is already buffered here
+  bool insert(const T &info) {
+    auto [it, inserted] = m_live.try_emplace(info.orderID, m_nextSeq);
+    if (!inserted)
+      return false;
+    m_entries.push_back(Entry{info, m_nextSeq++});
+    return true;
+  }
+
+  bool erase(OrderID orderID) {
+    if (m_live.erase(orderID) == 0)
+      return false;
+    m_dead++;
+    // mostly dead outside a drain: squeeze once, not on every erase
+    if (!m_draining && m_dead > m_live.size() + 16)
+      PendingQueue::compact(m_sorted);
+    return true;
+  }
+
+  bool contains(OrderID orderID) const { return m_live.contains(orderID); }
+  std::size_t size() const { return m_live.size(); }
+  bool empty() const { return m_live.empty(); }
+
+  // visit(const T &) on every live entry in priority order, visitor erases
+  // whatever it consumed; erase & insert are fine from inside it (inserts
+  // wait for the next drain), a drain nested in a drain is a no-op
+  template <typename Visit> void drain(Visit &&visit) {
+    if (m_draining || m_live.empty())
+      return;
+    m_draining = true;
+    PendingQueue::compact(m_sorted);
+    auto byPriority = [](const Entry &lhs, const Entry &rhs) {
+      return lhs.info < rhs.info;
+    };
+    auto sortedEnd = m_entries.begin() + static_cast<std::ptrdiff_t>(m_sorted);
+    std::sort(sortedEnd, m_entries.end(), byPriority);
+    std::inplace_merge(m_entries.begin(), sortedEnd, m_entries.end(),
+                       byPriority);
+
+    const std::size_t end = m_entries.size();
+    for (std::size_t idx = 0; idx < end; idx++) {
+      Entry entry = m_entries[idx]; // visitor may append (reallocate)
+      if (m_dead == 0 || PendingQueue::isLive(entry))
+        visit(static_cast<const T &>(entry.info));
+    }
+    PendingQueue::compact(end);
+    m_draining = false;
+  }
+
+  // every live entry, in no particular order
+  template <typename Visit> void forEach(Visit &&visit) const {
+    for (const Entry &entry : m_entries)
+      if (m_dead == 0 || PendingQueue::isLive(entry))
+        visit(entry.info);
+  }
+
+private:
+  struct Entry {
+    T info;
+    std::uint64_t seq; // live while the order still maps to it
+  };
+
+  bool isLive(const Entry &entry) const {
+    auto it = m_live.find(entry.info.orderID);
+    return it != m_live.end() && it->second == entry.seq;
+  }
+
+  // drops dead slots, keeps order: survivors of [0, sortedEnd) (sorted)
+  // become the new sorted prefix
+  void compact(std::size_t sortedEnd) {
+    if (m_dead == 0) {
+      m_sorted = sortedEnd;
+      return;
+    }
+    std::size_t kept = 0, keptSorted = 0;
+    for (std::size_t idx = 0; idx < m_entries.size(); idx++) {
+      if (!PendingQueue::isLive(m_entries[idx]))
+        continue;
+      if (idx < sortedEnd)
+        keptSorted++;
+      if (kept != idx)
+        m_entries[kept] = std::move(m_entries[idx]);
+      kept++;
+    }
+    m_entries.resize(kept);
+    m_sorted = keptSorted;
+    m_dead = 0;
+  }
+
+  std::vector<Entry> m_entries; // [0, m_sorted) sorted, rest as inserted
+  std::size_t m_sorted{0};
+  std::size_t m_dead{0}; // erased slots not compacted yet (0: all live)
+  std::unordered_map<OrderID, std::uint64_t> m_live; // order -> its entry
+  std::uint64_t m_nextSeq{0};
+  bool m_draining{false};
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "include/OrderRequest.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// one slot of the pipeline ring: the request & what the stages made of it
+struct PipelineEvent {
+  OrderRequest request;
+  ExecutionReport report;
+};
+
+// sequenced pipeline over one preallocated ring (disruptor style):
+// the producer claims & publishes slots in order, each stage runs on its
+// own thread & follows the one before it (stage 0 the producer's cursor),
+// so different stages work on different events at the same time
+// every stage owns one sequence (last slot it is done with): no locks, no
+// queues between stages, slots are reused in place (the producer waits on
+// the last stage before wrapping onto a slot still in use)
+class Pipeline {
+public:
+  // endOfBatch: last event the stage saw available (flush points)
+  using Stage = std::function<void(PipelineEvent &event, bool endOfBatch)>;
+
+  Pipeline(std::size_t capacity, std::vector<Stage> stages);
+  Pipeline(const Pipeline &) = delete;
+  Pipeline &operator=(const Pipeline &) = delete;
+  ~Pipeline(); // drains & joins
+
+  // producer only: next slot to fill (waits while the ring is full), then
+  // publish() hands it to stage 0
+  PipelineEvent &claim();
+  void publish();
+  // producer only: returns once the last stage is done with everything
+  void drain() const;
+  void stop();
+
+  std::size_t capacity() const { return m_events.size(); }
+
+private:
+  using Sequence = std::int64_t; // -1: nothing yet
+  struct alignas(64) Cursor {
+    std::atomic<Sequence> value{-1};
+  };
+
+  void runStage(std::size_t index);
+
+  std::vector<PipelineEvent> m_events;
+  std::size_t m_mask;
+  std::vector<Stage> m_stages;
+  Cursor m_published; // producer's cursor
+  std::unique_ptr<Cursor[]> m_done; // per stage
+  Sequence m_claimed{-1}; // producer owned
+  Sequence m_cachedGate{-1}; // last stage, as the producer last saw it
+  std::atomic<bool> m_running{true};
+  std::vector<std::thread> m_threads;
+};
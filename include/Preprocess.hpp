@@ -1,19 +1,22 @@
 #pragma once
 
 #include "include/OrderBook.hpp"
+#include "include/PendingQueue.hpp"
+#include "include/TimerWheel.hpp"
 #include "utils/alias/Fundamental.hpp"
 #include "utils/alias/OrderBookRel.hpp"
 #include "utils/alias/OrderRel.hpp"
+#include "utils/alias/SessionCalendarRel.hpp"
 #include "utils/enums/Actions.hpp"
 #include "utils/enums/OrderTypes.hpp"
 #include "utils/enums/Side.hpp"
 
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <cstddef>
 #include <memory>
 #include <optional>
-#include <set>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -22,31 +25,39 @@
 
 class PreProcessor
 {
+  friend class Snapshot; // saves & restores the private state as is
+
 public:
+  // calendar: the venue's shared one (nullptr: own one from timeTuple)
   PreProcessor(OrderBookPointer &orderbookPtr, bool isBidPreprocessor,
                std::size_t pendingOrderThreshold,
                std::chrono::milliseconds pendingDurationThreshold,
-               const std::string &localTimeZone, const TimeTuple &timeTuple);
+               const std::string &localTimeZone, const TimeTuple &timeTuple,
+               SessionCalendarPointer calendar = nullptr);
 
   PreProcessor(OrderBookPointer &orderbookPtr, bool isBidPreprocessor);
   PreProcessor(OrderBookPointer &orderbookPtr, bool isBidPreProcessor, std::size_t pendingOrderThreshold,
                std::chrono::milliseconds pendingDurationThreshold);
   PreProcessor(OrderBookPointer &orderbookPtr, bool isBidPreProcessor, const std::string &localTimeZone, const TimeTuple &timeTuple);
+  // book holds a listener bound to this preprocessor
+  PreProcessor(const PreProcessor &) = delete;
+  PreProcessor &operator=(const PreProcessor &) = delete;
+  ~PreProcessor();
 
   struct OrderActionInfo
   {
     OrderID orderID;
     OrderType::OrderType orderType;
     Actions::Actions action;
+    Side::Side side;
+    Price price; // of the order acted on (cancels sort with their add)
 
     OrderActionInfo(const OrderID &orderId, OrderType::OrderType orderType,
-                    Actions::Actions action);
-
-    static Side::Side decodeSideFromOrderID(const OrderID orderID);
-    static Price decodePriceFromOrderID(const OrderID orderID);
+                    Actions::Actions action, Side::Side side, Price price);
 
     // follow rule of 3/5 as per need (context: constructors)
     OrderActionInfo() = default;
+    // price priority, then id (ids are handed out in arrival order)
     bool operator<(const OrderActionInfo &other) const;
   };
 
@@ -57,6 +68,8 @@ public:
   void setMaxPendingDuration(std::chrono::milliseconds duration);
 
   const std::string &getTimeZone() const;
+  // sessions (open/close, holidays) checked from now on
+  void setCalendar(SessionCalendarPointer calendar);
 
   std::string getType(OrderType::OrderType type);
   void printPreProcessorStatus();
@@ -79,13 +92,30 @@ public:
                              const OrderPointer &orderptr);
 
   void TryFlush();
+  // time based flush (and timers) for a scheduler driving this preprocessor
+  void FlushIfDue();
+  // when FlushIfDue has something to do next (read from any thread)
+  TimeStamp getNextDue() const
+  {
+    return TimeStamp{TimeStamp::duration{m_nextDue.load(std::memory_order_relaxed)}};
+  }
+  // on: TryFlush on the insert path only flushes on the order count, the
+  // duration is left to whoever calls FlushIfDue
+  void setScheduledFlush(bool scheduled) { m_scheduledFlush = scheduled; }
+  bool isFlushScheduled() const { return m_scheduledFlush; }
   void QueueOrdersForInsertion();
-  void EmptyTypeRankedOrders(std::set<OrderActionInfo> &typeRankedOrders);
+  void EmptyTypeRankedOrders(PendingQueue<OrderActionInfo> &typeRankedOrders);
   void EmptyOrderIntoOrderbook(const OrderActionInfo &ordactinfo);
   bool canInsertOrderIntoOrderbook(const OrderID &orderID);
-  void ClearSeenOrdersWhenMatched();
+  // fill of this side pushed by the book (one order touched per fill)
+  void ClearSeenOrdersWhenMatched(const OrderTraded &fill);
 
-  std::size_t getBufferedOrderCount();
+  // fires due GAT activations & GFD/GTD expiries (resting ones pulled from
+  // the book), driven by TryFlush or anyone ticking the preprocessor
+  void AdvanceTimers();
+  std::size_t getPendingTimerCount() const { return m_timers.size(); }
+
+  std::size_t getBufferedOrderCount() const; // O(1), kept as orders move
   std::size_t getNumberOfOrderTypes();
   std::size_t NumberOfOrdersBeingProcessed(const OrderType::OrderType &otype);
   bool hasOrderBeenEncountered(const OrderID &orderID);
@@ -99,28 +129,18 @@ private:
   static std::unordered_map<OrderType::OrderType, int> m_typeRank;
   static std::unordered_map<int, OrderType::OrderType> m_rankType;
 
-  // maa's idea to also check for public holidays
-  static constexpr std::array<std::tuple<unsigned, unsigned, int>, 15>
-      m_holidays = {{
-          {26u, 1u, 2025},  // Republic Day
-          {14u, 3u, 2025},  // Holi
-          {31u, 3u, 2025},  // Idul Fitr
-          {6u, 4u, 2025},   // Ram Navami
-          {18u, 4u, 2025},  // Good Friday
-          {12u, 5u, 2025},  // Buddha Purnima
-          {7u, 6u, 2025},   // Bakrid
-          {6u, 7u, 2025},   // Muharram
-          {15u, 8u, 2025},  // Independence Day
-          {16u, 8u, 2025},  // Janmashtami
-          {2u, 10u, 2025},  // Gandhi Jayanti
-          {2u, 10u, 2025},  // Vijaya Dashami
-          {21u, 10u, 2025}, // Diwali
-          {5u, 11u, 2025},  // Guru Nanak Jayanti
-          {25u, 12u, 2025}  // Christmas
-      }};
-  bool isHoliday(const TimeStamp &time);
   bool canTrade();
 
+  void scheduleExpiry(const OrderPointer &orderptr);
+  void cancelOrderTimer(const OrderID &orderID);
+  void ActivateOrder(const OrderID &orderID);
+  void ExpireOrder(const OrderID &orderID);
+  void DropBufferedOrder(const OrderID &orderId,
+                         const OrderType::OrderType &orderType);
+  bool bufferAction(const OrderActionInfo &orderactinfo);
+  bool unbufferAction(const OrderID &orderID,
+                      const OrderType::OrderType &orderType);
+
   TimeStamp getNextMarketTime(bool isOpen);
   TimeStamp getNextOpenTime() { return getNextMarketTime(true); }
   TimeStamp getNextCloseTime() { return getNextMarketTime(false); }
@@ -132,13 +152,27 @@ private:
   std::chrono::milliseconds m_MAX_PENDING_DURATION;
   std::string localTimeZone;
   TimeTuple openCloseTime;
+  // where the market's sessions stand (boundaries cached, moves with time)
+  SessionCalendar::Cursor m_session;
 
   // OrderBook as attribute as orderbook is unique for all prepro of same symbol
   // shared_ptr orderbook is shared across all prepro instances (bids, asks)
   // OrderBook ptr removed once all preprocessors removed
   // independence across symbols will also be maintained
-  std::vector<std::set<OrderActionInfo>> m_laterProcessOrders;
+  std::vector<PendingQueue<OrderActionInfo>> m_laterProcessOrders;
+  std::size_t m_bufferedOrders{0}; // entries across m_laterProcessOrders
   std::chrono::system_clock::time_point m_lastFlushTime;
+  bool m_scheduledFlush{false};
+  // next flush deadline or timer poll, only ever lowered off the scheduler
+  std::atomic<TimeStamp::rep> m_nextDue{0};
+  void lowerNextDue(TimeStamp due);
+
+  // activation/expiry timers by order (one pending per order at most)
+  TimerWheel m_timers;
+  std::unordered_map<OrderID, TimerWheel::TimerHandle> m_orderTimers;
+  std::vector<TimerWheel::Timer> m_dueTimers; // reused across ticks
+  // GAT orders waiting on the wheel (buffered, kept out of the flush scan)
+  std::size_t m_dormantOrders{0};
 
   std::unordered_set<OrderID> m_encounteredOrders;
   std::unordered_map<OrderID, OrderActionInfo>
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils/alias/Fundamental.hpp"
+#include "utils/alias/LevelRel.hpp"
+
+// one side of the book, ranked by Compare (greater: bids, less: asks)
+// dense mode: contiguous array of levels indexed by tick around a reference
+// price, O(1) lookup & best/worst cursors (prices are ints, PRICE_MULTIPLIER)
+// sparse mode: red-black tree, used for prices that fall outside the window
+// (ticks == 0 disables the array, equivalent to the old std::map book)
+// depth: resting quantity per window tick kept in a Fenwick tree (the book
+// reports every quantity change), so the quantity at or better than a price
+// is O(log ticks) + the tree levels in range (none while prices stay inside)
+
+// templates live in the header (instantiated at compile time)
+template <typename Compare> class PriceLadder {
+public:
+  // entries handed out while iterating (no shared_ptr copy)
+  using value_type = std::pair<Price, const LevelPointer &>;
+
+  PriceLadder() = default;
+  // window centered lazily on the first price that arrives, and again on
+  // the first one outside it once the side has emptied (prices wander)
+  // prices <= 0 (a market order resting unpriced) never center it
+  explicit PriceLadder(std::size_t ticks)
+      : m_dense(ticks), m_spare(ticks), m_depth(ticks + 1) {}
+  PriceLadder(Price referencePrice, std::size_t ticks)
+      : m_dense(ticks), m_spare(ticks), m_depth(ticks + 1) {
+    centerOn(referencePrice);
+  }
+
+  bool empty() const { return size() == 0; }
+  std::size_t size() const { return m_denseCount + m_sparse.size(); }
+  std::size_t getTicks() const { return m_dense.size(); }
+  bool isCentered() const { return m_centered; }
+  Price getReferencePrice() const {
+    return m_base + static_cast<Price>(m_dense.size() / 2);
+  }
+  // level is (or would be) stored in the array instead of the tree
+  bool isDense(Price price) const {
+    return m_centered && price >= m_base &&
+           static_cast<std::size_t>(price - m_base) < m_dense.size();
+  }
+
+  // nullptr if level does not exist
+  LevelPointer find(Price price) const {
+    if (isDense(price))
+      return m_dense[index(price)];
+    auto it = m_sparse.find(price);
+    return (it == m_sparse.end()) ? nullptr : it->second;
+  }
+
+  bool contains(Price price) const { return find(price) != nullptr; }
+
+  // mirrors std::map::at (throws if level does not exist)
+  LevelPointer at(Price price) const {
+    LevelPointer level = find(price);
+    if (level == nullptr)
+      throw std::out_of_range("no level at price " + std::to_string(price));
+    return level;
+  }
+
+  void insert(Price price, const LevelPointer &level) {
+    if (!m_dense.empty() && empty() && price > 0 && !isDense(price))
+      centerOn(price);
+
+    if (!isDense(price)) {
+      m_sparse[price] = level;
+      return;
+    }
+
+    std::size_t idx = index(price);
+    if (m_dense[idx] == nullptr)
+      m_denseCount++;
+    m_dense[idx] = level;
+
+    // move cursors outwards if new level beats them
+    if (m_bestIdx == npos || better(idx, m_bestIdx))
+      m_bestIdx = idx;
+    if (m_worstIdx == npos || better(m_worstIdx, idx))
+      m_worstIdx = idx;
+  }
+
+  void erase(Price price) {
+    if (!isDense(price)) {
+      m_sparse.erase(price);
+      return;
+    }
+
+    std::size_t idx = index(price);
+    if (m_dense[idx] == nullptr)
+      return;
+    m_spare[idx] = std::move(m_dense[idx]); // parked for reuse, slot now null
+    m_denseCount--;
+
+    if (m_denseCount == 0) {
+      m_bestIdx = m_worstIdx = npos;
+      return;
+    }
+    // walk cursor towards the other one till a live level: as many ticks as
+    // the gap to it, O(window ticks) worst case (a lone far level), short
+    // near the touch where the book is dense
+    if (idx == m_bestIdx)
+      m_bestIdx = nextWorse(idx);
+    if (idx == m_worstIdx)
+      m_worstIdx = nextBetter(idx);
+  }
+
+  // quantity resting at price went up / down (tree levels are read live)
+  void addDepth(Price price, Quantity quantity) {
+    if (isDense(price))
+      fenwickAdd(index(price), quantity);
+  }
+  void removeDepth(Price price, Quantity quantity) {
+    if (isDense(price))
+      fenwickAdd(index(price), Quantity{0} - quantity); // wraps back exactly
+  }
+
+  // total quantity on levels at or better than price
+  Quantity depthThrough(Price price) const {
+    if (empty())
+      return 0;
+    Quantity depth = 0;
+    for (auto it = m_sparse.begin();
+         it != m_sparse.end() && !Compare{}(price, it->first); ++it)
+      depth += it->second->getQuantity();
+    if (!m_centered || m_dense.empty())
+      return depth;
+
+    const Price top = m_base + static_cast<Price>(m_dense.size()) - 1;
+    if (Compare{}(1, 0)) { // bids: price and above
+      if (price > top)
+        return depth;
+      std::size_t below =
+          (price <= m_base) ? 0 : static_cast<std::size_t>(price - m_base);
+      return depth + fenwickPrefix(m_dense.size()) - fenwickPrefix(below);
+    }
+    // asks: price and below
+    if (price < m_base)
+      return depth;
+    std::size_t upto = (price >= top)
+                           ? m_dense.size()
+                           : static_cast<std::size_t>(price - m_base) + 1;
+    return depth + fenwickPrefix(upto);
+  }
+
+  // level parked when its window slot was erased (nullptr if none)
+  // add/cancel churn at a tick reuses it instead of allocating a new level
+  LevelPointer takeSpare(Price price) {
+    if (!isDense(price))
+      return nullptr;
+    return std::exchange(m_spare[index(price)], nullptr);
+  }
+
+  // best price level on this side (nullptr if side is empty)
+  LevelPointer best() const {
+    auto sparseBest = m_sparse.begin();
+    if (m_bestIdx == npos)
+      return (sparseBest == m_sparse.end()) ? nullptr : sparseBest->second;
+    if (sparseBest != m_sparse.end() &&
+        Compare{}(sparseBest->first, priceAt(m_bestIdx)))
+      return sparseBest->second;
+    return m_dense[m_bestIdx];
+  }
+
+  // worst price level on this side (nullptr if side is empty)
+  LevelPointer worst() const {
+    auto sparseWorst = m_sparse.rbegin();
+    if (m_worstIdx == npos)
+      return (sparseWorst == m_sparse.rend()) ? nullptr : sparseWorst->second;
+    if (sparseWorst != m_sparse.rend() &&
+        Compare{}(priceAt(m_worstIdx), sparseWorst->first))
+      return sparseWorst->second;
+    return m_dense[m_worstIdx];
+  }
+
+  // walks levels best to worst:
+  // tree levels better than the window, window levels, tree levels worse
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = PriceLadder::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    const_iterator() = default;
+
+    value_type operator*() const {
+      if (m_phase == Phase::Dense)
+        return {m_ladder->priceAt(m_idx), m_ladder->m_dense[m_idx]};
+      return {m_sparseIt->first, m_sparseIt->second};
+    }
+
+    const_iterator &operator++() {
+      if (m_phase == Phase::Dense) {
+        m_idx = (m_idx == m_ladder->m_worstIdx) ? npos
+                                                : m_ladder->nextWorse(m_idx);
+        if (m_idx == npos)
+          m_phase = Phase::SparseWorse;
+      } else {
+        ++m_sparseIt;
+      }
+      settle();
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator old = *this;
+      ++(*this);
+      return old;
+    }
+
+    bool operator==(const const_iterator &other) const {
+      return m_phase == other.m_phase && m_idx == other.m_idx &&
+             m_sparseIt == other.m_sparseIt;
+    }
+
+  private:
+    friend class PriceLadder;
+    enum class Phase { SparseBetter, Dense, SparseWorse, End };
+    using SparseIterator =
+        typename std::map<Price, LevelPointer, Compare>::const_iterator;
+
+    const_iterator(const PriceLadder *ladder, Phase phase)
+        : m_ladder{ladder}, m_phase{phase},
+          m_sparseIt{ladder->m_sparse.begin()} {
+      if (phase == Phase::End)
+        m_sparseIt = ladder->m_sparse.end();
+      settle();
+    }
+
+    // skip exhausted phases (keeps end() comparison trivial)
+    void settle() {
+      if (m_phase == Phase::SparseBetter) {
+        if (m_sparseIt != m_ladder->m_sparse.end() &&
+            (m_ladder->m_bestIdx == npos ||
+             Compare{}(m_sparseIt->first,
+                       m_ladder->priceAt(m_ladder->m_bestIdx))))
+          return;
+        m_phase = Phase::Dense;
+        m_idx = m_ladder->m_bestIdx;
+      }
+      if (m_phase == Phase::Dense) {
+        if (m_idx != npos)
+          return;
+        m_phase = Phase::SparseWorse;
+      }
+      if (m_phase == Phase::SparseWorse) {
+        if (m_sparseIt != m_ladder->m_sparse.end())
+          return;
+        m_phase = Phase::End;
+      }
+      m_idx = npos;
+    }
+
+    const PriceLadder *m_ladder{nullptr};
+    Phase m_phase{Phase::End};
+    SparseIterator m_sparseIt{};
+    std::size_t m_idx{npos};
+  };
+
+  const_iterator begin() const {
+    return const_iterator(this, const_iterator::Phase::SparseBetter);
+  }
+  const_iterator end() const {
+    return const_iterator(this, const_iterator::Phase::End);
+  }
+
+private:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  // only while the side is empty: no live level & no depth to move, parked
+  // levels belong to the old ticks
+  void centerOn(Price referencePrice) {
+    if (m_centered)
+      std::fill(m_spare.begin(), m_spare.end(), nullptr);
+    m_base = referencePrice - static_cast<Price>(m_dense.size() / 2);
+    m_centered = true;
+  }
+
+  std::size_t index(Price price) const {
+    return static_cast<std::size_t>(price - m_base);
+  }
+  Price priceAt(std::size_t idx) const {
+    return m_base + static_cast<Price>(idx);
+  }
+  bool better(std::size_t lhs, std::size_t rhs) const {
+    return Compare{}(priceAt(lhs), priceAt(rhs));
+  }
+
+  // m_depth[i] covers (i - lowbit(i), i] of the window, 1 based
+  void fenwickAdd(std::size_t idx, Quantity quantity) {
+    for (std::size_t node = idx + 1; node < m_depth.size();
+         node += node & (~node + 1))
+      m_depth[node] += quantity;
+  }
+  // sum of the first count window slots
+  Quantity fenwickPrefix(std::size_t count) const {
+    Quantity sum = 0;
+    for (std::size_t node = count; node > 0; node -= node & (~node + 1))
+      sum += m_depth[node];
+    return sum;
+  }
+
+  // neighbouring live slot in worse/better direction (npos if none)
+  std::size_t nextWorse(std::size_t idx) const { return step(idx, false); }
+  std::size_t nextBetter(std::size_t idx) const { return step(idx, true); }
+  std::size_t step(std::size_t idx, bool towardsBetter) const {
+    // greater<Price> ranks higher index as better, less<Price> lower index
+    const bool upwards = (Compare{}(1, 0) == towardsBetter);
+    while (true) {
+      if (upwards) {
+        if (idx + 1 >= m_dense.size())
+          return npos;
+        idx++;
+      } else {
+        if (idx == 0)
+          return npos;
+        idx--;
+      }
+      if (m_dense[idx] != nullptr)
+        return idx;
+    }
+  }
+
+  std::vector<LevelPointer> m_dense;   // tick indexed window (base + idx)
+  std::vector<LevelPointer> m_spare;   // erased window levels (recycled)
+  std::map<Price, LevelPointer, Compare> m_sparse; // far away prices
+  std::vector<Quantity> m_depth;       // Fenwick tree over the window
+  Price m_base{0};
+  bool m_centered{false};
+  std::size_t m_denseCount{0};
+  std::size_t m_bestIdx{npos};
+  std::size_t m_worstIdx{npos};
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "utils/alias/Fundamental.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// trading sessions of one venue: open/close instants from its GMT hours
+// (Xchange::tradingHoursGMT), weekends & holidays skipped
+// the next sessions are laid out once when built (immutable after, shared
+// by every preprocessor of the venue); a Cursor walks them as time passes,
+// so "open now?" & "next open/close" compare against cached boundaries
+// (day, weekday & date math only once the table runs out)
+class SessionCalendar {
+public:
+  struct Session {
+    TimeStamp open;
+    TimeStamp close;
+  };
+  using Holiday = std::chrono::year_month_day;
+
+  static constexpr std::size_t DefaultSessions = 512; // ~2 years
+
+  // sessions from the day of from on
+  SessionCalendar(const TimeTuple &hours, std::vector<Holiday> holidays,
+                  TimeStamp from, std::size_t sessions = DefaultSessions);
+
+  // one YYYY-MM-DD per line, '#' starts a comment (std::runtime_error if the
+  // file can't be read or a line isn't a date)
+  static std::vector<Holiday> loadHolidays(const std::string &path);
+  // built in list (BSE 2025)
+  static std::vector<Holiday> defaultHolidays();
+
+  bool isHoliday(Holiday day) const;
+  const TimeTuple &getHours() const { return m_hours; }
+  const std::vector<Holiday> &getHolidays() const { return m_holidays; }
+  std::size_t size() const { return m_sessions.size(); }
+  Session first() const;
+  // session after the index-th one (computed past the precomputed table)
+  Session following(std::size_t index, const Session &session) const;
+
+  // per reader position (not thread safe, one per preprocessor), time is
+  // expected to only move forward
+  class Cursor {
+  public:
+    Cursor() = default;
+    explicit Cursor(std::shared_ptr<const SessionCalendar> calendar)
+        : m_calendar{std::move(calendar)}, m_current{m_calendar->first()},
+          m_next{m_calendar->following(0, m_current)} {}
+
+    bool isOpen(TimeStamp now) {
+      const Session &current = seek(now);
+      return now >= current.open && now < current.close;
+    }
+    // next open at or after now (the running session's has passed)
+    TimeStamp nextOpen(TimeStamp now) {
+      const Session &current = seek(now);
+      return (current.open >= now) ? current.open : m_next.open;
+    }
+    // close of the running session, else of the next one
+    TimeStamp nextClose(TimeStamp now) { return seek(now).close; }
+
+  private:
+    // first session not closed before now
+    const Session &seek(TimeStamp now) {
+      while (m_current.close < now) {
+        m_current = m_next;
+        m_next = m_calendar->following(++m_index, m_current);
+      }
+      return m_current;
+    }
+
+    std::shared_ptr<const SessionCalendar> m_calendar;
+    std::size_t m_index{0};
+    Session m_current{};
+    Session m_next{};
+  };
+
+private:
+  // session of the first trading day after day (weekends, holidays skipped)
+  Session sessionAfter(std::chrono::sys_days day) const;
+
+  TimeTuple m_hours;
+  std::chrono::sys_days m_start;
+  std::vector<Holiday> m_holidays; // sorted
+  std::vector<Session> m_sessions;
+};
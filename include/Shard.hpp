@@ -0,0 +1,47 @@
+#pragma once
+
+#include "include/OrderRequest.hpp"
+#include "include/SpscRing.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+// worker thread owning a subset of the symbols (handle % shard count):
+// requests come in through its ring from the one thread placing orders &
+// run there one after another, so books & preprocessors of a symbol are
+// only ever touched by their shard
+class Shard {
+public:
+  using Handler = std::function<void(OrderRequest &request)>;
+
+  // pinned to core index % hardware threads when the platform allows
+  Shard(std::size_t index, std::size_t capacity, Handler handler);
+  Shard(const Shard &) = delete;
+  Shard &operator=(const Shard &) = delete;
+  ~Shard(); // drains & joins
+
+  // producer only: spins (yielding) while the ring is full
+  void submit(OrderRequest &&request);
+  // producer only: returns once everything submitted has executed
+  void drain() const;
+  void stop();
+
+  std::size_t getIndex() const { return m_index; }
+  std::uint64_t getExecutedCount() const {
+    return m_executed.load(std::memory_order_acquire);
+  }
+
+private:
+  void run();
+
+  std::size_t m_index;
+  SpscRing<OrderRequest> m_ring;
+  Handler m_handler;
+  std::uint64_t m_submitted{0}; // producer owned
+  std::atomic<std::uint64_t> m_executed{0};
+  std::atomic<bool> m_running{true};
+  std::thread m_thread;
+};
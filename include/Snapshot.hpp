@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "include/Journal.hpp"
+
+class Xchange;
+
+// point in time image of the whole exchange: name tables, participants
+// (portfolio, orders, trade history), every book's resting records in FIFO
+// order & trade log, both preprocessors' buffered state, plus the journal
+// sequence it covers (restart = load + replay of the journal after that
+// sequence)
+// file: versioned header & section table, then 64 byte aligned arrays of
+// fixed size records (host layout), mapped read only on load & walked in
+// place, strings live in one blob referenced by offset/length
+class Snapshot {
+public:
+  static constexpr std::uint32_t Version = 4;
+
+  // written to path + ".tmp" then renamed (a crash leaves the old one)
+  static void write(const Xchange &xchange, const std::string &path,
+                    JournalSequence sequence);
+  // into a fresh exchange (nothing registered or traded yet), throws
+  // std::runtime_error on a missing/foreign/truncated file
+  static JournalSequence load(Xchange &xchange, const std::string &path);
+};
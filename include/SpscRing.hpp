@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// bounded lock-free single producer / single consumer queue
+// slots preallocated (capacity rounded up to a power of 2), indices only
+// grow & are masked, each side caches the other's index so the shared
+// cache lines are touched only when the cached view says full/empty
+template <typename T> class SpscRing {
+public:
+  explicit SpscRing(std::size_t capacity)
+      : m_slots(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity)),
+        m_mask{m_slots.size() - 1} {}
+  SpscRing(const SpscRing &) = delete;
+  SpscRing &operator=(const SpscRing &) = delete;
+
+  // producer side: false when full (value left untouched)
+  bool tryPush(T &&value) {
+    std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_cachedHead == m_slots.size()) {
+      m_cachedHead = m_head.load(std::memory_order_acquire);
+      if (tail - m_cachedHead == m_slots.size())
+        return false;
+    }
+    m_slots[tail & m_mask] = std::move(value);
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // consumer side: false when empty
+  bool tryPop(T &value) {
+    std::size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_cachedTail) {
+      m_cachedTail = m_tail.load(std::memory_order_acquire);
+      if (head == m_cachedTail)
+        return false;
+    }
+    value = std::move(m_slots[head & m_mask]);
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  std::size_t capacity() const { return m_slots.size(); }
+  // exact only from the producer or the consumer while the other is idle
+  std::size_t size() const {
+    return m_tail.load(std::memory_order_acquire) -
+           m_head.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+
+private:
+  static constexpr std::size_t CacheLine = 64;
+
+  std::vector<T> m_slots;
+  std::size_t m_mask;
+  // consumer owned
+  alignas(CacheLine) std::atomic<std::size_t> m_head{0};
+  std::size_t m_cachedTail{0};
+  // producer owned
+  alignas(CacheLine) std::atomic<std::size_t> m_tail{0};
+  std::size_t m_cachedHead{0};
+};
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "utils/alias/Fundamental.hpp"
+#include "utils/alias/InternRel.hpp"
 #include "utils/alias/OrderBookRel.hpp"
 #include "utils/alias/PreProcessorRel.hpp"
+#include "utils/alias/SessionCalendarRel.hpp"
 #include <chrono>
 #include <cstddef>
+#include <mutex>
 
 // SymbolInfo essentially groups up data for a symbol
 // no need to create a class for it
@@ -14,9 +17,15 @@ struct SymbolInfo {
   OrderBookPointer m_orderbook;
   PreProcessorPointer m_bidprepro;
   PreProcessorPointer m_askprepro;
+  // held by whoever drives book & preprocessors once a second thread can
+  // (flush scheduler running), free otherwise
+  std::mutex m_lock;
 
   SymbolInfo(const Symbol &symbol);
   SymbolInfo(const Symbol &symbol, const std::size_t &orderThreshold,
              const std::chrono::milliseconds &durationThreshold,
-            const std::string& localTimeZone, const TimeTuple& timeTuple);
+            const std::string& localTimeZone, const TimeTuple& timeTuple,
+            InternTablePointer symbolNames = nullptr,
+            InternTablePointer participantNames = nullptr,
+            SessionCalendarPointer calendar = nullptr);
 };
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "utils/alias/Fundamental.hpp"
+
+// hierarchical timing wheel for order activation (GAT) & expiry (GFD, GTD)
+// 4 levels x 256 slots of 1 tick each level up (1 ms tick: ~49 days ahead,
+// farther timers park in the top level & are re-filed when it comes round)
+// schedule/cancel O(1), advance O(due + cascaded), empty stretches skipped
+class TimerWheel {
+public:
+  enum class TimerKind : std::uint8_t { Activate, Expire };
+  using TimerHandle = std::uint32_t; // valid till fired or cancelled
+  static constexpr TimerHandle NullTimer = UINT32_MAX;
+
+  struct Timer {
+    OrderID orderID;
+    TimerKind kind;
+  };
+
+  static constexpr std::size_t LevelBits = 8;
+  static constexpr std::size_t SlotsPerLevel = std::size_t{1} << LevelBits;
+  static constexpr std::size_t Levels = 4;
+
+  explicit TimerWheel(TimeStamp origin = TimeStamp{},
+                      std::chrono::milliseconds tick = std::chrono::milliseconds(1));
+
+  // due at or before the current tick: fires on the next advance
+  TimerHandle schedule(TimeStamp due, OrderID orderID, TimerKind kind);
+  void cancel(TimerHandle handle);
+  // appends every timer due at or before now (never early) to due
+  void advance(TimeStamp now, std::vector<Timer> &due);
+  // when advance next has work (a timer firing or moving down a level),
+  // never after the earliest timer; TimeStamp::max() when empty
+  TimeStamp nextDue() const;
+
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+private:
+  using Tick = std::uint64_t;
+  static constexpr std::uint16_t ReadyBucket = Levels * SlotsPerLevel;
+  static constexpr std::uint32_t NullNode = UINT32_MAX;
+
+  struct Node {
+    Tick dueTick;
+    OrderID orderID;
+    TimerKind kind;
+    std::uint16_t bucket; // level * SlotsPerLevel + slot, or ReadyBucket
+    std::uint32_t prev;
+    std::uint32_t next; // free list link while unused
+  };
+
+  Tick tickCeil(TimeStamp time) const;
+  Tick tickFloor(TimeStamp time) const;
+  void place(std::uint32_t node);
+  void link(std::uint32_t node, std::uint16_t bucket);
+  void unlink(std::uint32_t node);
+  void cascade(std::size_t level);
+  void fireSlot(std::size_t slot, std::vector<Timer> &due);
+  void release(std::uint32_t node);
+
+  TimeStamp m_origin;
+  std::chrono::milliseconds m_tick;
+  Tick m_currentTick{0}; // everything due at or before it has fired
+
+  std::vector<Node> m_nodes;
+  std::uint32_t m_freeHead{NullNode};
+  std::array<std::uint32_t, Levels * SlotsPerLevel + 1> m_buckets;
+  std::array<std::size_t, Levels> m_levelCount{};
+  std::size_t m_size{0};
+};
@@ -1,14 +1,17 @@
 #pragma once
 
+#include "include/Clock.hpp"
 #include "include/OrderTraded.hpp"
 #include "utils/alias/Fundamental.hpp"
 #include <cassert>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
+#include <type_traits>
 
 class Trade {
 public:
+  Trade() = default; // blank record (trade log buffers, read back from disk)
   Trade(const OrderTraded &bidOrder, const OrderTraded &askOrder)
       : m_bidMatch{bidOrder}, m_askMatch{askOrder} {
     assert(bidOrder.getSymbol() == askOrder.getSymbol());
@@ -17,7 +20,7 @@ public:
   }
 
   // https://stackoverflow.com/a/16449914
-  const Symbol getSymbol() const { return m_symbol; }
+  SymbolHandle getSymbol() const { return m_symbol; }
   const OrderTraded &getMatchedBid() const { return m_bidMatch; }
   const OrderTraded &getMatchedAsk() const { return m_askMatch; }
   const TimeStamp getMatchTime() const { return m_timeMatch; }
@@ -31,14 +34,16 @@ public:
   }
 
   static TimeStamp getLocalTime() {
-    auto now = std::chrono::system_clock::now();
-    return now;
+    return Clock::now();
     // return now + std::chrono::hours(5) + std::chrono::minutes(30);
   }
 
 private:
-  Symbol m_symbol;
+  SymbolHandle m_symbol{InvalidHandle};
   OrderTraded m_bidMatch;
   OrderTraded m_askMatch;
   TimeStamp m_timeMatch;
 };
+
+// stored & spilled as raw bytes by the trade log
+static_assert(std::is_trivially_copyable_v<Trade>);
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "include/Trade.hpp"
+#include "utils/alias/TradeRel.hpp"
+
+// session trade history of one book, addressed by sequence (0 = first trade)
+// fixed size segments of raw trade records, at most residentSegments of them
+// in memory (a ring, buffers reused); the oldest is appended to a spill file
+// when a new one is needed. appends never reallocate, memory stays bounded
+// readers see one sequence space: resident trades by reference, spilled ones
+// read back from the file
+class TradeLog {
+public:
+  static constexpr std::size_t DefaultSegmentTrades = 4096;
+  static constexpr std::size_t DefaultResidentSegments = 16;
+
+  // spillPath empty: anonymous temporary file (gone when the log is)
+  explicit TradeLog(std::size_t segmentTrades = DefaultSegmentTrades,
+                    std::size_t residentSegments = DefaultResidentSegments,
+                    std::string spillPath = "");
+  TradeLog(TradeLog &&) = default;
+  TradeLog &operator=(TradeLog &&) = default;
+
+  TradeSequence append(const Trade &trade);
+  // room for the next append: the spill (may throw) & segment it needs are
+  // done here, append can't fail after it (callers mutating state first)
+  void prepareAppend();
+
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+  // [0, firstResident()) lives in the spill file, the rest in memory
+  TradeSequence firstResident() const { return m_firstResident; }
+  bool isResident(TradeSequence sequence) const {
+    return sequence >= m_firstResident && sequence < m_size;
+  }
+  const Trade &back() const { return resident(m_size - 1); }
+  Trade at(TradeSequence sequence) const; // throws std::out_of_range
+  // bulk copy from sequence on (one file read for the spilled part),
+  // returns #trades copied
+  std::size_t read(TradeSequence from, std::span<Trade> out) const;
+  // carve resident segments up front (no allocation on append till count)
+  void reserve(std::size_t count);
+
+  // input iterator over sequences, yields trades by value
+  class Iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Trade;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() = default;
+    Iterator(const TradeLog *log, TradeSequence sequence)
+        : m_log{log}, m_sequence{sequence} {}
+
+    Trade operator*() const { return m_log->at(m_sequence); }
+    Iterator &operator++() {
+      m_sequence++;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator previous = *this;
+      m_sequence++;
+      return previous;
+    }
+    TradeSequence sequence() const { return m_sequence; }
+    bool operator==(const Iterator &other) const {
+      return m_sequence == other.m_sequence;
+    }
+
+  private:
+    const TradeLog *m_log{nullptr};
+    TradeSequence m_sequence{0};
+  };
+
+  // trades [from, end of log) at the time of the call
+  struct Range {
+    Iterator first;
+    Iterator last;
+    Iterator begin() const { return first; }
+    Iterator end() const { return last; }
+    std::size_t size() const { return last.sequence() - first.sequence(); }
+    bool empty() const { return first == last; }
+  };
+  Range since(TradeSequence from) const;
+  Iterator begin() const { return Iterator{this, 0}; }
+  Iterator end() const { return Iterator{this, m_size}; }
+
+private:
+  struct FileCloser {
+    void operator()(std::FILE *file) const { std::fclose(file); }
+  };
+
+  const Trade &resident(TradeSequence sequence) const {
+    std::size_t segment = sequence / m_segmentTrades;
+    return m_segments[segment % m_residentSegments][sequence % m_segmentTrades];
+  }
+  void spillOldest();
+  std::FILE *spillFile();
+
+  std::size_t m_segmentTrades;
+  std::size_t m_residentSegments;
+  std::string m_spillPath;
+  std::unique_ptr<std::FILE, FileCloser> m_spill; // opened on first spill
+
+  // ring slot = (sequence / m_segmentTrades) % m_residentSegments
+  std::vector<std::unique_ptr<Trade[]>> m_segments;
+  TradeSequence m_firstResident{0}; // always a segment boundary
+  TradeSequence m_size{0};
+};
@@ -1,18 +1,32 @@
 #pragma once
 
+#include "include/FlushScheduler.hpp"
+#include "include/Journal.hpp"
+#include "include/OrderRequest.hpp"
+#include "include/Pipeline.hpp"
+#include "include/Shard.hpp"
 #include "include/SymbolInfo.hpp"
+#include "include/Trade.hpp"
+#include "utils/alias/ClockRel.hpp"
 #include "utils/alias/Fundamental.hpp"
+#include "utils/alias/InternRel.hpp"
 #include "utils/alias/ParticipantRel.hpp"
+#include "utils/alias/SessionCalendarRel.hpp"
+#include "utils/alias/ShardRel.hpp"
 #include "utils/alias/SymbolInfoRel.hpp"
 #include "utils/enums/Actions.hpp"
 #include "utils/enums/OrderTypes.hpp"
 
 #include <chrono>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 // initial idea: make Xchange singleton
 // benefits: only 1 instance, not customizable initialization
@@ -21,16 +35,53 @@
 
 class Xchange
 {
+  friend class Snapshot; // saves & restores the private state as is
+
 private:
   std::unordered_set<std::string> m_govIDs;
-  std::unordered_map<ParticipantID, ParticipantPointer> m_participants;
   std::unordered_map<std::string, ParticipantID> govID_partIDMap;
 
-  std::unordered_map<Symbol, SymbolInfoPointer> m_symbolInfos;
+  // names interned once here, core (books, fills) only sees the handles
+  InternTablePointer m_symbolNames;
+  InternTablePointer m_participantNames;
+
+  // flat, indexed by handle (nullptr once removed/retired, handles not reused)
+  std::vector<ParticipantPointer> m_participants;
+  std::vector<SymbolInfoPointer> m_symbolInfos;
+  std::size_t m_participantCount = 0;
+  std::size_t m_symbolCount = 0;
 
   std::size_t m_MAX_PENDING_ORDERS_THRESHOLD;
   std::chrono::milliseconds m_MAX_PENDING_DURATION;
   std::string localTimeZone;
+  // resolved once: local date strings placed are read in the venue's zone
+  const std::chrono::time_zone *m_zone;
+  // sessions of the venue (its GMT hours & holidays), shared by every
+  // symbol's preprocessors
+  SessionCalendarPointer m_calendar;
+
+  // write-ahead log of accepted requests (nullptr: not journaling)
+  std::unique_ptr<Journal> m_journal;
+  // periodic snapshot (every m_snapshotEvents journal events, 0: off)
+  std::string m_snapshotPath;
+  std::uint64_t m_snapshotEvents = 0;
+  JournalSequence m_snapshotSequence = 0;
+
+  // sharded mode (empty: placeOrder runs everything on the caller's thread)
+  std::vector<ShardPointer> m_shards;
+  ExecutionListener m_executionListener;
+  // participants are shared across shards (& the flush scheduler): striped
+  // by handle
+  static constexpr std::size_t ParticipantLockStripes = 64;
+  std::unique_ptr<std::mutex[]> m_participantLocks;
+  // pipelined mode (validate -> journal -> execute -> publish threads)
+  std::unique_ptr<Pipeline> m_pipeline;
+  std::uint64_t m_pipelinedSinceSnapshot = 0;
+  // journal stage: events of the batch & their journal sequences (the ones
+  // not committed yet are rejected together when a commit fails)
+  std::vector<std::pair<PipelineEvent *, JournalSequence>> m_journalBatch;
+  // time based flush of every symbol off the request path (nullptr: off)
+  std::unique_ptr<FlushScheduler> m_flushScheduler;
 
   static std::unique_ptr<Xchange>
       m_instance; // must initialize outside class in main
@@ -41,20 +92,90 @@ private:
   Xchange(std::size_t pendingThreshold,
           std::chrono::milliseconds pendingDuration);
 
+  // trade listener of every book: both legs' participants by handle, O(1)
+  void routeTrade(const Trade &trade) const;
+
+  // what placeOrder checks before accepting (participant & symbol live,
+  // side & type given, old order id for modify/cancel)
+  bool isAcceptable(const ParticipantHandle participant,
+                    const Actions::Actions action,
+                    const std::optional<OrderID> &oldOrderID,
+                    const SymbolHandle symbol,
+                    const std::optional<Side::Side> side,
+                    const std::optional<OrderType::OrderType> orderType) const;
+  // placeOrder (handles resolved): validates, draws the id of the order the
+  // request creates (replay: the journaled one) & journals or hands it off
+  std::optional<OrderID> acceptOrder(
+      const ParticipantHandle participant, const Actions::Actions action,
+      const std::optional<OrderID> &oldOrderID, const SymbolHandle symbol,
+      const std::optional<Side::Side> side,
+      const std::optional<OrderType::OrderType> orderType,
+      const std::optional<Price> price, const std::optional<Quantity> quantity,
+      const std::optional<TimeStamp> &activationTime,
+      const std::optional<TimeStamp> &deactivationTime,
+      const std::optional<OrderID> &journaledID);
+  // flush, match & participant bookkeeping of an accepted request
+  std::optional<OrderID> executeOrder(
+      const ParticipantHandle participant, const Actions::Actions action,
+      const std::optional<OrderID> &oldOrderID, const SymbolHandle symbol,
+      const std::optional<Side::Side> side,
+      const std::optional<OrderType::OrderType> orderType,
+      const std::optional<Price> price, const std::optional<Quantity> quantity,
+      const std::optional<TimeStamp> &activationTime,
+      const std::optional<TimeStamp> &deactivationTime,
+      const std::optional<OrderID> &orderID);
+  // shard side: executes, reports (rejections included, nothing thrown)
+  void executeOnShard(OrderRequest &request);
+  // producer side of the pipeline: claims, fills & publishes one slot
+  void pipelineOrder(
+      const ParticipantHandle participant, const Actions::Actions action,
+      const std::optional<OrderID> &oldOrderID, const SymbolHandle symbol,
+      const std::optional<Side::Side> side,
+      const std::optional<OrderType::OrderType> orderType,
+      const std::optional<Price> price, const std::optional<Quantity> quantity,
+      const std::optional<TimeStamp> &activationTime,
+      const std::optional<TimeStamp> &deactivationTime,
+      const std::optional<OrderID> &orderID);
+  // pipeline stages, each on its own thread
+  void validateEvent(PipelineEvent &event) const;
+  void journalEvent(PipelineEvent &event, bool endOfBatch);
+  void executeEvent(PipelineEvent &event);
+  void publishEvent(const PipelineEvent &event) const;
+  // shards & pipeline idle, flush scheduler held off while the returned
+  // lock lives: shared state is the caller's thread's again
+  std::unique_lock<std::mutex> quiesce() const;
+  // empty lock unless the flush scheduler runs
+  std::unique_lock<std::mutex> lockSymbol(SymbolInfo &symbolInfo) const;
+  // empty lock when not sharded
+  std::unique_lock<std::mutex> lockParticipant(ParticipantHandle participant) const;
+  // every symbol's preprocessors moved to calendar (caller quiesced)
+  void switchCalendar(SessionCalendarPointer calendar);
+
 public:
   Xchange(const Xchange &) = delete;            // copy-constructor
   Xchange &operator=(const Xchange &) = delete; // copy-assignment
+  ~Xchange(); // books handed out may outlive it: detaches their listeners
 
   static Xchange &getInstance(int pendingThreshold, int pendingDuration, const std::string &localTimeZone);
   static Xchange &getInstance(int pendingThreshold, int pendingDuration);
   static void destroyInstance();
 
+  // handle API: one vector index per lookup, string API wraps it
+  ParticipantHandle registerParticipant(const std::string &govId);
   ParticipantID addParticipant(const std::string &govId);
   ParticipantID generateParticipantID(
       const std::string
           &govId); // part may wish to know their Id if they don't remember
   void removeParticipant(const ParticipantID &participantID);
 
+  std::optional<OrderID> placeOrder(
+      const ParticipantHandle participant, const Actions::Actions action,
+      const std::optional<OrderID> &OrderID, const SymbolHandle symbol,
+      const std::optional<Side::Side> side,
+      const std::optional<OrderType::OrderType> orderType,
+      const std::optional<double> price, const std::optional<Quantity> quantity,
+      const std::optional<std::string> &activationTime,
+      const std::optional<std::string> &deactivationTime);
   std::optional<OrderID> placeOrder(
       const ParticipantID &participantID, const Actions::Actions action,
       const std::optional<OrderID> &OrderID,
@@ -63,24 +184,98 @@ public:
       const std::optional<double> price, const std::optional<Quantity> quantity,
       const std::optional<std::string> &activationTime,
       const std::optional<std::string> &deactivationTime);
+  // typed (see OrderRequest; its orderID is ignored): no strings parsed,
+  // what the binary order entry decoder calls
+  std::optional<OrderID> placeOrder(const OrderRequest &request);
 
   ParticipantPointer
   getParticipantInfo(const ParticipantID &participantID) const;
+  ParticipantPointer getParticipantInfo(ParticipantHandle participant) const;
+  // InvalidHandle if not (or no longer) registered/traded
+  ParticipantHandle findParticipant(const ParticipantID &participantID) const;
+  SymbolHandle findSymbol(const Symbol &symbol) const;
   std::size_t getParticipantCount() const;
   bool canMapGovIDToParticipantID(const std::string &govID) const;
   ParticipantID getParticipantIDFromGovID(const std::string &govId) const;
 
-  void tradeNewSymbol(const Symbol &symbol);
+  SymbolHandle tradeNewSymbol(const Symbol &symbol);
   void retireOldSymbol(const Symbol &symbol);
   std::size_t getSymbolsTradedCount() const;
   OrderBookPointer getOrderBook(const Symbol &symbol) const;
+  OrderBookPointer getOrderBook(SymbolHandle symbol) const;
   PreProcessorPointer getPreProcessor(const Symbol &symbol,
                                       const Side::Side &side) const;
   std::vector<Trade> getTradesExecuted(const Symbol &symbol) const;
 
+  // every accepted request is appended before the preprocessor sees it
+  void startJournal(const std::string &path, JournalOptions options = {});
+  void stopJournal(); // commits & closes
+  const Journal *getJournal() const { return m_journal.get(); }
+  // re-applies a journal in order (same handles, same orders): call on a
+  // fresh exchange, before journaling; returns the last sequence applied
+  JournalSequence replayJournal(const std::string &path,
+                                JournalSequence after = 0);
+
+  // symbols split over shardCount pinned threads (handle % shardCount),
+  // placeOrder then validates, journals & enqueues: the order id comes back
+  // at once, the execution report later through the listener
+  // placeOrder must then be called from one thread only; participant &
+  // symbol changes, snapshots & replay drain the shards first, anything
+  // else reading books/participants calls drainShards itself
+  void startShards(std::size_t shardCount, std::size_t ringCapacity = 1 << 16);
+  void stopShards(); // drains & joins, back to the caller's thread
+  void drainShards() const;
+  std::size_t getShardCount() const { return m_shards.size(); }
+  // one preallocated ring of requests walked by 4 stage threads in order:
+  // validation, journal append (committed at the end of every batch),
+  // preprocess + match, report publish; a stage works on later requests
+  // while the next one is still busy with earlier ones
+  // placeOrder only claims & fills a slot (id back at once), the same
+  // single thread & drain rules as sharded mode apply; the two modes are
+  // exclusive (std::logic_error)
+  void startPipeline(std::size_t ringCapacity = 1 << 16);
+  void stopPipeline(); // drains & joins
+  void drainPipeline() const;
+  bool isPipelined() const { return m_pipeline != nullptr; }
+  // background thread flushing every symbol's preprocessors once their
+  // pending duration is up (quiet symbols included, timers advanced too);
+  // the order count flush stays on the insert path, requests & flushes
+  // of a symbol take its lock while it runs
+  void startFlushScheduler(
+      std::chrono::milliseconds tick = std::chrono::milliseconds(1));
+  void stopFlushScheduler(); // joins, flush on insert again
+  bool isFlushScheduled() const { return m_flushScheduler != nullptr; }
+  // called on the shard/publish threads (must be thread safe)
+  void setExecutionListener(ExecutionListener listener);
+
+  // point in time image of everything (covers the journal so far)
+  void writeSnapshot(const std::string &path);
+  // snapshot whenever everyEvents more requests were journaled
+  void setSnapshotPolicy(const std::string &path, std::uint64_t everyEvents);
+  // fast restart on a fresh exchange: snapshot, then the journal tail
+  JournalSequence restore(const std::string &snapshotPath,
+                          const std::string &journalPath);
+
+  const InternTablePointer &getSymbolNames() const { return m_symbolNames; }
+  const InternTablePointer &getParticipantNames() const {
+    return m_participantNames;
+  }
+
   std::size_t getOrderThreshold() const;
   std::uint64_t getDurationThreshold() const;
   const std::string &getTimeZone() const;
+  // holiday file (SessionCalendar::loadHolidays format) replaces the built
+  // in list: sessions rebuilt once, every symbol switched over (not
+  // journaled: load before replay/restore like the rest of the setup)
+  void loadHolidays(const std::string &path);
+  const SessionCalendarPointer &getCalendar() const { return m_calendar; }
+  // time source of the whole process (nullptr: wall clock), sessions
+  // rebuilt from its reading; a clock behind the current one once symbols
+  // trade is a std::logic_error (timers & sessions only move forward), so
+  // a simulated clock starting in the past goes in first
+  // replay hands it every event's journaled time (Clock::follow), a coarse
+  // clock is refreshed once per request & flush scheduler pass
+  void setClock(ClockPointer clock);
 
   bool isGovIDPresent(const std::string &govId) const;
   bool isParticipantIDPresent(const std::string &partId) const;
@@ -0,0 +1,43 @@
+#include "include/Clock.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <utility>
+
+namespace
+{
+WallClock wallClock; // default, never destroyed before its readers
+
+// moves now up to time (several threads may refresh/drive at once)
+void raiseTo(std::atomic<TimeStamp::rep> &now, TimeStamp::rep time)
+{
+  TimeStamp::rep current = now.load(std::memory_order_relaxed);
+  while (time > current &&
+         !now.compare_exchange_weak(current, time, std::memory_order_relaxed))
+  {
+  }
+}
+} // namespace
+
+std::atomic<Clock *> Clock::s_current{&wallClock};
+std::shared_ptr<Clock> Clock::s_installed = nullptr;
+
+std::shared_ptr<Clock> Clock::install(std::shared_ptr<Clock> clock)
+{
+  s_current.store((clock != nullptr) ? clock.get() : &wallClock,
+                  std::memory_order_release);
+  return std::exchange(s_installed, std::move(clock));
+}
+
+std::shared_ptr<Clock> Clock::installed() { return s_installed; }
+
+void CoarseClock::tick()
+{
+  raiseTo(m_now, std::chrono::system_clock::now().time_since_epoch().count());
+}
+
+void SimulatedClock::set(TimeStamp time)
+{
+  raiseTo(m_now, time.time_since_epoch().count());
+}
@@ -0,0 +1,84 @@
+#include "include/FlushScheduler.hpp"
+#include "include/Clock.hpp"
+#include "include/Preprocess.hpp"
+#include "include/SymbolInfo.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+FlushScheduler::FlushScheduler(std::chrono::milliseconds tick) : m_tick{tick}
+{
+  m_thread = std::thread([this]
+                         { FlushScheduler::run(); });
+}
+
+FlushScheduler::~FlushScheduler()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_wake.notify_one();
+  m_thread.join();
+  for (const SymbolInfoPointer &symbolInfo : m_targets)
+    FlushScheduler::setScheduled(symbolInfo, false);
+}
+
+void FlushScheduler::setScheduled(const SymbolInfoPointer &symbolInfo,
+                                  bool scheduled)
+{
+  symbolInfo->m_bidprepro->setScheduledFlush(scheduled);
+  symbolInfo->m_askprepro->setScheduledFlush(scheduled);
+}
+
+void FlushScheduler::add(const SymbolInfoPointer &symbolInfo)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  FlushScheduler::setScheduled(symbolInfo, true);
+  m_targets.push_back(symbolInfo);
+}
+
+void FlushScheduler::remove(const SymbolInfoPointer &symbolInfo)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = std::find(m_targets.begin(), m_targets.end(), symbolInfo);
+  if (it == m_targets.end())
+    return;
+  FlushScheduler::setScheduled(symbolInfo, false);
+  m_targets.erase(it);
+}
+
+std::unique_lock<std::mutex> FlushScheduler::pause()
+{
+  return std::unique_lock<std::mutex>(m_running);
+}
+
+void FlushScheduler::run()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_wake.wait_for(lock, m_tick, [this]
+                          { return m_stopping; }))
+  {
+    lock.unlock();
+    FlushScheduler::pass();
+    lock.lock();
+  }
+}
+
+void FlushScheduler::pass()
+{
+  std::lock_guard<std::mutex> running(m_running);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Clock::refresh(); // quiet symbols get a fresh coarse reading too
+  TimeStamp now = PreProcessor::getLocalTime();
+  for (const SymbolInfoPointer &symbolInfo : m_targets)
+  {
+    if (symbolInfo->m_bidprepro->getNextDue() > now &&
+        symbolInfo->m_askprepro->getNextDue() > now)
+      continue;
+    std::lock_guard<std::mutex> symbolLock(symbolInfo->m_lock);
+    symbolInfo->m_bidprepro->FlushIfDue();
+    symbolInfo->m_askprepro->FlushIfDue();
+  }
+}
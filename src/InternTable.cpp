@@ -0,0 +1,21 @@
+#include "include/InternTable.hpp"
+#include "utils/alias/Fundamental.hpp"
+
+#include <string>
+
+InternHandle InternTable::intern(const std::string &name)
+{
+  auto [it, inserted] =
+      m_handles.try_emplace(name, static_cast<InternHandle>(m_names.size()));
+  if (inserted)
+  {
+    m_names.push_back(name);
+  }
+  return it->second;
+}
+
+InternHandle InternTable::find(const std::string &name) const
+{
+  auto it = m_handles.find(name);
+  return (it == m_handles.end()) ? InvalidHandle : it->second;
+}
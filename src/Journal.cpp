@@ -0,0 +1,443 @@
+#include "include/Journal.hpp"
+#include "include/Clock.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/enums/Actions.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+// presence bits of the optional fields of an order event
+enum OrderFields : std::uint8_t
+{
+  HasOldOrderID = 1 << 0,
+  HasSide = 1 << 1,
+  HasOrderType = 1 << 2,
+  HasPrice = 1 << 3,
+  HasQuantity = 1 << 4,
+  HasActivation = 1 << 5,
+  HasDeactivation = 1 << 6,
+  HasOrderID = 1 << 7
+};
+
+// an order event (fixed size: price in ticks, times as clock ticks)
+struct OrderPayload
+{
+  ParticipantHandle participant;
+  SymbolHandle symbol;
+  std::uint8_t action;
+  std::uint8_t fields;
+  std::uint8_t side;
+  std::uint8_t orderType;
+  OrderID oldOrderID;
+  OrderID orderID; // replay hands out the same ids
+  Quantity quantity;
+  TimeStamp::rep activationTime; // Constants::Now stays as is (0)
+  TimeStamp::rep deactivationTime;
+  Price price;
+};
+
+constexpr std::size_t MaxEventBytes = 1 << 16; // anything larger is garbage
+constexpr std::size_t InitialBuffer = 1 << 20;
+
+// CRC32C (Castagnoli, reflected), sliced by 8: one table lookup per byte
+// but 8 bytes folded per step (a byte at a time chains every lookup)
+using CrcTables = std::array<std::array<std::uint32_t, 256>, 8>;
+constexpr CrcTables makeCrcTables()
+{
+  CrcTables tables{};
+  for (std::uint32_t idx = 0; idx < 256; idx++)
+  {
+    std::uint32_t crc = idx;
+    for (int bit = 0; bit < 8; bit++)
+      crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78u : crc >> 1;
+    tables[0][idx] = crc;
+  }
+  for (std::size_t slice = 1; slice < 8; slice++)
+    for (std::uint32_t idx = 0; idx < 256; idx++)
+      tables[slice][idx] = (tables[slice - 1][idx] >> 8) ^
+                           tables[0][tables[slice - 1][idx] & 0xFF];
+  return tables;
+}
+constexpr CrcTables CrcTable = makeCrcTables();
+
+// continues crc (start from 0) over [data, data + size)
+std::uint32_t crc32c(std::uint32_t crc, const char *data, std::size_t size)
+{
+  crc = ~crc;
+  std::size_t idx = 0;
+  for (; idx + 8 <= size; idx += 8)
+  {
+    std::uint64_t word;
+    std::memcpy(&word, data + idx, sizeof(word)); // little endian host
+    word ^= crc;
+    crc = CrcTable[7][word & 0xFF] ^ CrcTable[6][(word >> 8) & 0xFF] ^
+          CrcTable[5][(word >> 16) & 0xFF] ^ CrcTable[4][(word >> 24) & 0xFF] ^
+          CrcTable[3][(word >> 32) & 0xFF] ^ CrcTable[2][(word >> 40) & 0xFF] ^
+          CrcTable[1][(word >> 48) & 0xFF] ^ CrcTable[0][word >> 56];
+  }
+  for (; idx < size; idx++)
+    crc = CrcTable[0][(crc ^ static_cast<unsigned char>(data[idx])) & 0xFF] ^
+          (crc >> 8);
+  return ~crc;
+}
+
+// payload walker for replay (bounds checked, false once exhausted)
+struct Reader
+{
+  const char *data;
+  std::size_t size;
+  std::size_t offset{0};
+
+  bool get(void *out, std::size_t count)
+  {
+    if (offset + count > size)
+      return false;
+    std::memcpy(out, data + offset, count);
+    offset += count;
+    return true;
+  }
+};
+
+bool decodeOrder(Reader &reader, Journal::Event &event)
+{
+  OrderPayload payload;
+  if (!reader.get(&payload, sizeof(payload)))
+    return false;
+  event.participant = payload.participant;
+  event.symbol = payload.symbol;
+  event.action = static_cast<Actions::Actions>(payload.action);
+  if (payload.fields & HasOldOrderID)
+    event.oldOrderID = payload.oldOrderID;
+  if (payload.fields & HasOrderID)
+    event.orderID = payload.orderID;
+  if (payload.fields & HasSide)
+    event.side = static_cast<Side::Side>(payload.side);
+  if (payload.fields & HasOrderType)
+    event.orderType = static_cast<OrderType::OrderType>(payload.orderType);
+  if (payload.fields & HasPrice)
+    event.price = payload.price;
+  if (payload.fields & HasQuantity)
+    event.quantity = payload.quantity;
+  if (payload.fields & HasActivation)
+    event.activationTime =
+        TimeStamp{TimeStamp::duration{payload.activationTime}};
+  if (payload.fields & HasDeactivation)
+    event.deactivationTime =
+        TimeStamp{TimeStamp::duration{payload.deactivationTime}};
+  return true;
+}
+} // namespace
+
+Journal::Journal(const std::string &path, JournalOptions options)
+    : m_path{path}, m_options{options},
+      m_lastCommit{std::chrono::steady_clock::now()}
+{
+  std::size_t validBytes = 0;
+  m_lastSequence = Journal::scan(path, validBytes, nullptr);
+  m_committedSequence = m_lastSequence;
+
+  m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (m_fd < 0)
+    throw std::system_error(errno, std::generic_category(),
+                            "journal could NOT be opened: " + path);
+  // torn tail of a crashed writer: appends continue after the last whole event
+  if (::ftruncate(m_fd, static_cast<off_t>(validBytes)) != 0)
+    throw std::system_error(errno, std::generic_category(),
+                            "journal could NOT be truncated: " + path);
+  m_fileBytes = m_committedBytes = validBytes;
+  m_buffer.reserve(InitialBuffer);
+  m_flusher = std::thread([this]
+                          { Journal::flushWhenDue(); });
+}
+
+Journal::~Journal()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closing = true;
+  }
+  m_wake.notify_one();
+  m_flusher.join();
+  try
+  {
+    Journal::commit();
+  }
+  catch (...)
+  {
+    // nothing sane left to do with a failing disk while unwinding
+  }
+  if (m_fd >= 0)
+    ::close(m_fd);
+}
+
+void Journal::put(const void *data, std::size_t size)
+{
+  const char *bytes = static_cast<const char *>(data);
+  m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+}
+
+void Journal::beginEvent(EventType type)
+{
+  Journal::checkUsable();
+  m_eventStart = m_buffer.size();
+  Header header{};
+  header.type = type;
+  header.sequence = m_lastSequence + 1;
+  header.time = Clock::now().time_since_epoch().count();
+  put(&header, sizeof(header));
+}
+
+// payload length patched in, group commit decided
+JournalSequence Journal::endEvent()
+{
+  std::uint32_t length =
+      static_cast<std::uint32_t>(m_buffer.size() - m_eventStart - sizeof(Header));
+  std::memcpy(m_buffer.data() + m_eventStart + offsetof(Header, length),
+              &length, sizeof(length));
+  // header (checksum still 0) & payload are contiguous in the buffer
+  std::uint32_t checksum = crc32c(0, m_buffer.data() + m_eventStart,
+                                  m_buffer.size() - m_eventStart);
+  std::memcpy(m_buffer.data() + m_eventStart + offsetof(Header, checksum),
+              &checksum, sizeof(checksum));
+  m_lastSequence++;
+  if (++m_pendingEvents == 1)
+    m_wake.notify_one(); // flusher: the interval starts counting
+
+  if (m_pendingEvents >= m_options.commitEvents ||
+      std::chrono::steady_clock::now() - m_lastCommit >=
+          m_options.commitInterval)
+    Journal::commitLocked();
+  return m_lastSequence;
+}
+
+JournalSequence Journal::appendName(EventType type, const std::string &name)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Journal::beginEvent(type);
+  put(name.data(), name.size());
+  return Journal::endEvent();
+}
+
+JournalSequence Journal::appendOrder(
+    ParticipantHandle participant, Actions::Actions action,
+    const std::optional<OrderID> &oldOrderID, SymbolHandle symbol,
+    const std::optional<Side::Side> &side,
+    const std::optional<OrderType::OrderType> &orderType,
+    const std::optional<Price> &price, const std::optional<Quantity> &quantity,
+    const std::optional<TimeStamp> &activationTime,
+    const std::optional<TimeStamp> &deactivationTime,
+    const std::optional<OrderID> &orderID)
+{
+  OrderPayload payload{};
+  payload.participant = participant;
+  payload.symbol = symbol;
+  payload.action = static_cast<std::uint8_t>(action);
+  payload.fields = static_cast<std::uint8_t>(
+      (oldOrderID ? HasOldOrderID : 0) | (side ? HasSide : 0) |
+      (orderType ? HasOrderType : 0) | (price ? HasPrice : 0) |
+      (quantity ? HasQuantity : 0) | (activationTime ? HasActivation : 0) |
+      (deactivationTime ? HasDeactivation : 0) | (orderID ? HasOrderID : 0));
+  payload.side = static_cast<std::uint8_t>(side.value_or(Side::Side::Buy));
+  payload.orderType = static_cast<std::uint8_t>(
+      orderType.value_or(OrderType::OrderType::GoodTillCancel));
+  payload.oldOrderID = oldOrderID.value_or(0);
+  payload.orderID = orderID.value_or(0);
+  payload.price = price.value_or(0);
+  payload.quantity = quantity.value_or(0);
+  payload.activationTime =
+      activationTime.value_or(TimeStamp{}).time_since_epoch().count();
+  payload.deactivationTime =
+      deactivationTime.value_or(TimeStamp{}).time_since_epoch().count();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Journal::beginEvent(EventType::PlaceOrder);
+  put(&payload, sizeof(payload));
+  return Journal::endEvent();
+}
+
+// bytes that made it to the file leave the buffer even when a later write
+// fails: a retried commit continues right after them (nothing twice)
+void Journal::writeOut()
+{
+  std::size_t written = 0;
+  while (written < m_buffer.size())
+  {
+    ssize_t count =
+        ::write(m_fd, m_buffer.data() + written, m_buffer.size() - written);
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count < 0)
+    {
+      int error = errno;
+      m_buffer.erase(m_buffer.begin(),
+                     m_buffer.begin() + static_cast<std::ptrdiff_t>(written));
+      throw std::system_error(error, std::generic_category(),
+                              "journal could NOT be written: " + m_path);
+    }
+    written += static_cast<std::size_t>(count);
+    m_fileBytes += static_cast<std::size_t>(count);
+  }
+  m_buffer.clear(); // capacity kept
+}
+
+void Journal::commit()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Journal::commitLocked();
+}
+
+// a failed fdatasync is final: the kernel may already have dropped the dirty
+// pages (a retry would report success for data never on disk), so nothing
+// more is appended or committed
+void Journal::commitLocked()
+{
+  Journal::checkUsable();
+  m_lastCommit = std::chrono::steady_clock::now();
+  if (m_pendingEvents == 0)
+    return;
+  Journal::writeOut();
+  if (m_options.sync && ::fdatasync(m_fd) != 0)
+  {
+    m_syncFailed = true;
+    throw std::system_error(errno, std::generic_category(),
+                            "journal could NOT be synced: " + m_path);
+  }
+  m_pendingEvents = 0;
+  m_committedBytes = m_fileBytes;
+  m_committedSequence.store(m_lastSequence, std::memory_order_release);
+}
+
+void Journal::rollback()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_buffer.clear();
+  m_pendingEvents = 0;
+  m_lastSequence = m_committedSequence.load(std::memory_order_relaxed);
+  if (m_fileBytes == m_committedBytes)
+    return;
+  if (::ftruncate(m_fd, static_cast<off_t>(m_committedBytes)) != 0)
+    throw std::system_error(errno, std::generic_category(),
+                            "journal could NOT be truncated: " + m_path);
+  m_fileBytes = m_committedBytes;
+}
+
+// sleeps while nothing is pending, else till the interval since the last
+// commit is up (appends may commit first & move it)
+void Journal::flushWhenDue()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_closing)
+  {
+    if (m_pendingEvents == 0 || m_syncFailed)
+    {
+      m_wake.wait(lock);
+      continue;
+    }
+    auto due = m_lastCommit + m_options.commitInterval;
+    if (std::chrono::steady_clock::now() < due)
+    {
+      m_wake.wait_until(lock, due);
+      continue;
+    }
+    try
+    {
+      Journal::commitLocked();
+    }
+    catch (const std::exception &)
+    {
+      // a failed write is retried next interval (or by the next append's
+      // commit, which reports it), a failed sync stays latched
+    }
+  }
+}
+
+void Journal::checkUsable() const
+{
+  if (m_syncFailed)
+    throw std::runtime_error("journal could NOT be used after a failed sync: " +
+                             m_path);
+}
+
+JournalSequence Journal::replay(const std::string &path,
+                                const EventVisitor &visitor,
+                                JournalSequence after)
+{
+  std::size_t validBytes = 0;
+  return Journal::scan(path, validBytes, &visitor, after);
+}
+
+JournalSequence Journal::scan(const std::string &path, std::size_t &validBytes,
+                              const EventVisitor *visitor, JournalSequence after)
+{
+  validBytes = 0;
+  std::error_code error;
+  if (!std::filesystem::exists(path, error))
+    return 0;
+  std::FILE *file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr)
+    throw std::runtime_error("journal could NOT be read: " + path);
+
+  JournalSequence last = 0;
+  std::vector<char> payload;
+  Header header;
+  while (std::fread(&header, sizeof(header), 1, file) == 1)
+  {
+    // torn or foreign tail: everything from here on is ignored
+    if (header.length > MaxEventBytes || header.sequence != last + 1)
+      break;
+    payload.resize(header.length);
+    if (header.length > 0 &&
+        std::fread(payload.data(), header.length, 1, file) != 1)
+      break;
+    // only verified events are replayed & kept (garbage past a torn write)
+    const std::uint32_t checksum = header.checksum;
+    header.checksum = 0;
+    if (crc32c(crc32c(0, reinterpret_cast<const char *>(&header),
+                      sizeof(header)),
+               payload.data(), payload.size()) != checksum)
+      break;
+
+    if (visitor != nullptr && header.sequence > after)
+    {
+      Event event;
+      event.sequence = header.sequence;
+      event.time = TimeStamp{TimeStamp::duration{header.time}};
+      event.type = header.type;
+      if (header.type == EventType::PlaceOrder)
+      {
+        Reader reader{payload.data(), payload.size()};
+        if (!decodeOrder(reader, event))
+          break;
+      }
+      else
+      {
+        event.name.assign(payload.data(), payload.size());
+      }
+      (*visitor)(event);
+    }
+    last = header.sequence;
+    validBytes += sizeof(header) + header.length;
+  }
+  std::fclose(file);
+  return last;
+}
@@ -2,80 +2,106 @@
 #include "utils/alias/Fundamental.hpp"
 #include "utils/enums/OrderStatus.hpp"
 
-#include <iterator>
-#include <unordered_map>
-Level::Level(Symbol symbol, Price price, Quantity quantity)
-    : m_symbol{symbol}, m_price{price}, m_quantity{quantity}, m_orderList{} {}
+Level::Level(Symbol symbol, Price price, Quantity quantity, OrderPool &pool)
+    : m_symbol{symbol}, m_price{price}, m_quantity{quantity}, m_pool{&pool} {}
 
-TimeStamp Level::getActivationTime(const OrderID &orderID)
+TimeStamp Level::getActivationTime(SlotIndex slot) const
 {
-  OrderPointer orderptr = (m_info[orderID]).order;
-  return orderptr->getActivationTime();
+  return (*m_pool)[slot].activateTime;
 }
 
-TimeStamp Level::getDeactivationTime(const OrderID &orderID)
+TimeStamp Level::getDeactivationTime(SlotIndex slot) const
 {
-  OrderPointer orderptr = (m_info[orderID]).order;
-  return orderptr->getDeactivationTime();
+  return (*m_pool)[slot].deactivateTime;
 }
 
-void Level::AddOrder(Order &order)
+// readdition of same order is caught by the book (orderID index)
+SlotIndex Level::AddOrder(const OrderRecord &record)
 {
-  assert(m_price == order.getPrice()); // ensure price matches
+  assert(m_price == record.price); // ensure price matches
 
-  if (m_info.count(order.getOrderID()) > 0)
-  { // avoid readdition of same order
-    return;
-  }
-  m_quantity += order.getRemainingQuantity(); // add quantity to current level
+  m_quantity += record.remQuantity; // add quantity to current level
 
-  // uses copy constructor over provided constructor to create pointer to
-  // resource
-  OrderPointer currentOrderPointer = std::make_shared<Order>(order);
+  // copy lands in a recycled pool slot (no heap allocation once warm)
+  SlotIndex slot = m_pool->acquire(record);
+  OrderRecord &entry = (*m_pool)[slot];
 
   // add order has now entered the orderbook's specific level, once executed
   // it's status will be updated to processed
-  currentOrderPointer->setOrderStatus(OrderStatus::OrderStatus::Processing);
-
-  m_orderList.push_back(currentOrderPointer); // pass by value (copy created)
-  // verify copy creation using currentOrderPointer.use_count(): ref incr by 1
-
-  // https://stackoverflow.com/a/2678214 (iterator of latest aka last order)
-  OrderList::iterator listEndIterator = std::prev(m_orderList.end());
+  entry.setOrderStatus(OrderStatus::OrderStatus::Processing);
 
-  // store information of the order in the level
-  m_info[order.getOrderID()] =
-      OrderPointerInfo{currentOrderPointer, listEndIterator};
+  // append at the tail of the FIFO (time priority)
+  entry.links.prev = m_tail;
+  if (m_tail != NullSlot)
+  {
+    (*m_pool)[m_tail].links.next = slot;
+  }
+  else
+  {
+    m_head = slot;
+  }
+  m_tail = slot;
+  m_orderCount++;
+  return slot;
 }
 
-void Level::CancelOrder(OrderID orderID)
+void Level::unlink(SlotIndex slot)
 {
-  // cannot delete non-existing order in a level
-  if (m_info.count(orderID) == 0)
+  OrderRecord::Links &links = (*m_pool)[slot].links;
+  if (links.prev != NullSlot)
+  {
+    (*m_pool)[links.prev].links.next = links.next;
+  }
+  else
+  {
+    m_head = links.next;
+  }
+  if (links.next != NullSlot)
   {
-    // in case order is not found, then the cancel order remains NotProcessed
-    // (no hope for it)
-    return;
+    (*m_pool)[links.next].links.prev = links.prev;
   }
+  else
+  {
+    m_tail = links.prev;
+  }
+  m_orderCount--;
+  m_pool->release(slot);
+}
+
+void Level::CancelOrder(SlotIndex slot)
+{
   // obtain to be deleted order information
-  const auto &[corrOrderPointer, corrOrderListIterator] = m_info.at(orderID);
+  OrderRecord &record = (*m_pool)[slot];
 
-  // debugging: before & after: m_quantity, ol size, info size
-  m_quantity -=
-      corrOrderPointer->getRemainingQuantity(); // subtract qty from level
+  // debugging: before & after: m_quantity, order count
+  m_quantity -= record.remQuantity; // subtract qty from level
 
   // cancel order that is cancelled has served its purpose (hence it is
   // processed not processing)
-  corrOrderPointer->setOrderStatus(OrderStatus::OrderStatus::Cancelled);
+  record.setOrderStatus(OrderStatus::OrderStatus::Cancelled);
 
-  m_orderList.erase(corrOrderListIterator); // remove from list of orders
-  m_info.erase(orderID);                    // remove information of old order
+  unlink(slot); // remove from list of orders
 }
 
-void Level::ModifyOrder(OrderID oldOrderID, Order &ModifiedOrder)
+SlotIndex Level::ModifyOrder(SlotIndex oldSlot,
+                             const OrderRecord &modifiedRecord)
 {
-  CancelOrder(oldOrderID);
-  AddOrder(ModifiedOrder);
+  CancelOrder(oldSlot);
+  return AddOrder(modifiedRecord);
+}
+
+void Level::AmendOrder(SlotIndex slot, const OrderRecord &amendedRecord)
+{
+  OrderRecord &record = (*m_pool)[slot];
+  assert(m_price == amendedRecord.price);
+  assert(amendedRecord.remQuantity <= record.remQuantity);
+
+  // only the delta leaves the level, FIFO & participant links stay untouched
+  m_quantity -= record.remQuantity - amendedRecord.remQuantity;
+  OrderRecord::Links links = record.links;
+  record = amendedRecord;
+  record.links = links;
+  record.setOrderStatus(OrderStatus::OrderStatus::Processing);
 }
 
 void Level::UpdateLevelQuantityPostMatch(Quantity filledQuantity)
@@ -83,17 +109,7 @@ void Level::UpdateLevelQuantityPostMatch(Quantity filledQuantity)
   m_quantity -= filledQuantity;
 }
 
-void Level::removeMatchedOrder(
-    OrderID orderID)
-{ // orderID of the order executed fully (no volume left)
-  // find the matched order
-  std::unordered_map<OrderID, OrderPointerInfo>::iterator it =
-      m_info.find(orderID);
-  if (it == m_info.end())
-  {
-    return; // ignore if already removed
-  }
-  m_orderList.erase(
-      it->second.orderListIterator); // remove info from level info
-  m_info.erase(it);
+void Level::removeMatchedOrder(SlotIndex slot)
+{ // slot of the order executed fully (no volume left)
+  unlink(slot);
 }
@@ -1,25 +1,75 @@
 #include "include/Order.hpp"
+#include "include/Clock.hpp"
 #include "utils/Constants.hpp"
 #include "utils/alias/Fundamental.hpp"
 #include "utils/enums/OrderStatus.hpp"
 
 #include <cassert>
 #include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
-#include <ctime>
-#include <iomanip>
 #include <iostream>
+#include <optional>
 #include <ostream>
-#include <sstream>
 #include <stdexcept>
+#include <string>
 #include <format>
 
 const int PRICE_MULTIPLIER = 100;
 
+namespace
+{
+OrderIdGenerator orderIDs;
+
+// count ascii digits of text from offset, as a number (false on any other)
+bool digitsAt(const std::string &text, std::size_t offset, std::size_t count,
+              int &value)
+{
+  value = 0;
+  for (std::size_t idx = offset; idx < offset + count; idx++)
+  {
+    if (text[idx] < '0' || text[idx] > '9')
+      return false;
+    value = value * 10 + (text[idx] - '0');
+  }
+  return true;
+}
+
+// a local time this far from either end of its offset's span is unique
+// (no zone ever moved its clocks by more than a day at once)
+constexpr std::chrono::days SPAN_MARGIN{2};
+
+// local wall time in zone -> instant: the zone's offset is cached per
+// thread for the span it holds, the tz database is only asked again for
+// another zone or a time near a change (DST), never per order
+TimeStamp fromLocalTime(std::chrono::local_seconds local,
+                        const std::chrono::time_zone *zone)
+{
+  thread_local const std::chrono::time_zone *spanZone = nullptr;
+  thread_local std::chrono::sys_info span{}; // empty till the first call
+  if (zone == spanZone)
+  {
+    std::chrono::sys_seconds instant{local.time_since_epoch() - span.offset};
+    if (instant >= span.begin + SPAN_MARGIN && instant < span.end - SPAN_MARGIN)
+      return instant;
+  }
+  const std::chrono::local_info info = zone->get_info(local);
+  if (info.result == std::chrono::local_info::nonexistent)
+    throw std::runtime_error("Time could NOT be converted: skipped by a "
+                             "change of " + std::string(zone->name()));
+  // ambiguous: first is the span before the change, the earlier instant
+  spanZone = zone;
+  span = info.first;
+  return std::chrono::sys_seconds{local.time_since_epoch() - span.offset};
+}
+} // namespace
+
+OrderIdGenerator &Order::getIdGenerator() { return orderIDs; }
+
 TimeStamp Order::getGMTTime()
 {
-  TimeStamp now = std::chrono::system_clock::now(); // returns GMT
-  return now;
+  return Clock::now(); // GMT (installed clock)
 }
 
 std::string
@@ -37,100 +87,85 @@ void Order::printTimeInfo() const
 
 Order::Order(const Symbol symbol, const OrderType::OrderType orderType,
              const Side::Side side, const double price, const Quantity quantity,
-             const ParticipantID &participantID,
-             const std::string &activationTime,
-             const std::string &deactivationTime)
-    : m_symbol{symbol}, m_orderType{orderType}, m_side{side},
-      m_price{static_cast<int>(price * PRICE_MULTIPLIER)},
-      m_remQuantity{quantity}, m_participantID{participantID}
+             const ParticipantID &participantID)
+    : Order(symbol, orderType, side, Order::toTicks(price), quantity,
+            participantID, Constants::Now, Constants::EndOfTime)
 {
+}
 
-  // static_cast: purely compile time explicit inbuilt/custom cast operator
-  // no runtime check -> typecast to parent class, but access child method
-  // above problematic -> solution: dynamic_cast
-  // keep sure all values are in int to avoid round off, precision errors etc
+Order::Order(const Symbol &symbol, const OrderType::OrderType orderType,
+             const Side::Side side, const Price price, const Quantity quantity,
+             const ParticipantID &participantID, TimeStamp activationTime,
+             TimeStamp deactivationTime, std::optional<OrderID> orderID)
+    : m_symbol{symbol}, m_orderType{orderType}, m_side{side}, m_price{price},
+      m_remQuantity{quantity}, m_participantID{participantID},
+      m_timestamp{getGMTTime()}, m_deactivateTime{deactivationTime}
+{
   m_orderStatus = OrderStatus::OrderStatus::NotProcessed;
-  m_orderID =
-      Order::encodeOrderID(m_timestamp, m_price, m_side == Side::Side::Buy);
-
-  // expect time in dd-mm-yyyy hh:mm:ss format
-  m_activateTime = ((activationTime == "" || activationTime == "NOW")
-                        ? getGMTTime()
-                        : convertDateTimeToTimeStamp(activationTime));
-
-  m_deactivateTime = ((deactivationTime == "" || deactivationTime == "EOT")
-                          ? Constants::EndOfTime
-                          : convertDateTimeToTimeStamp(deactivationTime));
-  // std::cout << "activate time: " << returnReadableTime(m_activateTime) << " deactivate time: " << returnReadableTime(m_deactivateTime) << " end of time: " << returnReadableTime(Constants::EndOfTime) << std::endl;
+  m_orderID = (orderID.has_value()) ? orderID.value()
+                                    : Order::getIdGenerator().next();
+  // NOW: active from the moment it is entered
+  m_activateTime =
+      (activationTime == Constants::Now) ? m_timestamp : activationTime;
 }
 
-TimeStamp Order::convertDateTimeToTimeStamp(const std::string &dateTime)
+Order::Order(const Symbol &symbol, const OrderType::OrderType orderType,
+             const Side::Side side, const Price price, const Quantity remaining,
+             const ParticipantID &participantID, ParticipantHandle participant,
+             TimeStamp orderTime, OrderID orderID, TimeStamp activationTime,
+             TimeStamp deactivationTime, OrderStatus::OrderStatus orderStatus)
+    : m_symbol{symbol}, m_orderType{orderType}, m_side{side}, m_price{price},
+      m_remQuantity{remaining}, m_participantID{participantID},
+      m_participantHandle{participant}, m_timestamp{orderTime},
+      m_orderID{orderID}, m_activateTime{activationTime},
+      m_deactivateTime{deactivationTime}, m_orderStatus{orderStatus} {}
+
+// keep sure all values are in int to avoid round off, precision errors etc
+Price Order::toTicks(double price)
 {
-  // dateTime is in local time
-  assert(!dateTime.empty() || dateTime != "NOW" || dateTime != "EOT");
-
-  std::istringstream ss(dateTime); // string as buffer (terminate: white space/fail)
-
-  // https://cplusplus.com/reference/ctime/tm/
-  std::tm time{}; // init to avoid garbage values
-
-  ss >> std::get_time(&time, "%d-%m-%Y %H:%M:%S"); // dateTime format fixed
-  if (ss.fail())
-    throw std::runtime_error("Time could NOT be parsed");
+  return static_cast<Price>(std::lround(price * PRICE_MULTIPLIER));
+}
 
-  time.tm_isdst = -1; // let sys decide if daylight saving applicable
-                      // std::cout << "Parsed local tm: "
-                      //           << "Day=" << time.tm_mday << ", "
-                      //           << "Month=" << time.tm_mon + 1 << ", "
-                      //           << "Year=" << time.tm_year + 1900 << ", "
-                      //           << "Hour=" << time.tm_hour << ", "
-                      //           << "Min=" << time.tm_min << ", "
-                      //           << "Sec=" << time.tm_sec << ", "
-                      //           << "DST: " << time.tm_isdst << std::endl;
-
-  // returns UNIX time (#secs from Jan 1, 1970)
-  // TODO: check out and integrate __time64_t
-  std::time_t tt = std::mktime(&time); // interprets as local time
-  // std::time_t tt = timegm(&time); // interprets as GMT time
-  if (tt == -1)
-    throw std::runtime_error("Failed to convert time to time_t");
-
-  return std::chrono::system_clock::from_time_t(tt);
+TimeStamp Order::parseActivationTime(const std::string &activationTime,
+                                     const std::chrono::time_zone *zone)
+{
+  if (activationTime == "" || activationTime == "NOW")
+    return Constants::Now;
+  return convertDateTimeToTimeStamp(activationTime, zone);
 }
 
-// list initializer (runs before constructor)
-Order::Order(const Order &other)
-    : m_symbol{other.getSymbol()}, m_orderType{other.getOrderType()},
-      m_side{other.getSide()}, m_price{other.getPrice()},
-      m_remQuantity{other.getRemainingQuantity()},
-      m_orderID{other.getOrderID()}, m_activateTime{other.getActivationTime()},
-      m_deactivateTime{other.getDeactivationTime()},
-      m_orderStatus{other.getOrderStatus()} {}
+TimeStamp Order::parseDeactivationTime(const std::string &deactivationTime,
+                                       const std::chrono::time_zone *zone)
+{
+  if (deactivationTime == "" || deactivationTime == "EOT")
+    return Constants::EndOfTime;
+  return convertDateTimeToTimeStamp(deactivationTime, zone);
+}
 
-OrderID Order::encodeOrderID(TimeStamp time, Price intPrice, bool isBid)
+// hand written: no stream, locale or mktime (global tz lock) per call
+TimeStamp Order::convertDateTimeToTimeStamp(const std::string &dateTime,
+                                            const std::chrono::time_zone *zone)
 {
+  int day = 0, month = 0, year = 0, hour = 0, minute = 0, second = 0;
+  bool parsed = dateTime.size() == 19 && digitsAt(dateTime, 0, 2, day) &&
+                dateTime[2] == '-' && digitsAt(dateTime, 3, 2, month) &&
+                dateTime[5] == '-' && digitsAt(dateTime, 6, 4, year) &&
+                dateTime[10] == ' ' && digitsAt(dateTime, 11, 2, hour) &&
+                dateTime[13] == ':' && digitsAt(dateTime, 14, 2, minute) &&
+                dateTime[16] == ':' && digitsAt(dateTime, 17, 2, second);
+  std::chrono::year_month_day date{std::chrono::year{year},
+                                   std::chrono::month{static_cast<unsigned>(month)},
+                                   std::chrono::day{static_cast<unsigned>(day)}};
+  if (!parsed || !date.ok() || hour > 23 || minute > 59 || second > 59)
+    throw std::runtime_error("Time could NOT be parsed");
 
-  // https://stackoverflow.com/a/31553641
-  // steady_clock: stopwatch, system_clock: timestamp
-  // chrono: protects against unsafe type conversions (mostly manual)
-
-  // timestamp at ns scale provides enough uniqueness
-  // hence no random number used in orderID
-  std::uint64_t timestamp = time.time_since_epoch().count();
-
-  // interpretation of encodeOrderID
-  // bit 63-32: timestamp (uniqueness at ns scale)
-  // bit 31-1: store the Price to uint32_t
-  // bit 0: stores side
-
-  // put whole expressions in parenthesis (operator precendence screwed us)
-  // determined by prinitng pre-encoding & post-encoding version of each param
-  OrderID id = 0;
-  id |= ((static_cast<OrderID>(timestamp)) << 32);
-  id |= ((static_cast<OrderID>(intPrice)) << 1);
-  id |= ((isBid) ? static_cast<OrderID>(1) : static_cast<OrderID>(0));
-  return id;
+  // dateTime is wall time in zone
+  return fromLocalTime(std::chrono::local_days{date} + std::chrono::hours(hour) +
+                           std::chrono::minutes(minute) +
+                           std::chrono::seconds(second),
+                       zone);
 }
+
 void Order::FillPartially(Quantity quantity)
 {
   assert(quantity <= m_remQuantity);
@@ -148,9 +183,8 @@ bool Order::operator<(const Order &other) const
       return m_price < other.getPrice();
   }
 
-  if (m_timestamp != other.getOrderTime())
-    return m_timestamp < other.getOrderTime();
-  return m_remQuantity > other.getRemainingQuantity();
+  // ids are handed out in arrival order
+  return m_orderID < other.getOrderID();
 }
 
 bool Order::operator==(const Order &other) const
@@ -10,35 +10,23 @@
 #include "utils/enums/Side.hpp"
 
 #include <cassert>
+#include <span>
 #include <cstdint>
 #include <limits.h>
 #include <memory>
 #include <optional>
 
-Side::Side OrderBook::decodeSideFromOrderID(const OrderID orderID) {
-  return ((orderID & 0x1)
-              ? Side::Side::Buy
-              : Side::Side::Sell); // side is the last bit of orderID
-}
-
-Price OrderBook::decodePriceFromOrderID(const OrderID orderID) {
-  // last bit is not imp for price information
-  // & with all 1s retains on bits (can't store floats: so int)
-  // this mask is not the same as UINT32_MAX
-  std::uint32_t price = (orderID >> 1) & ((static_cast<OrderID>(1) << 31) - 1);
-  return price;
-}
-
-// optional since trade may/may not be possible C++ 17 feature
-// essentially returns 2 values: bool (success/failure) & return val (result)
-// optional is syntactic sugar, no need of ugly manual implementation
-
 // cannot add using orderID before it has been added to the orderbook (silly
 // doubt)
-std::optional<Trade> OrderBook::AddOrder(Order &order) {
+TradeBatch OrderBook::AddOrder(Order &order) {
   if (order.getSymbol() !=
-      m_symbol) {        // order does not belong to this OrderBook
-    return std::nullopt; //  failure indicator
+      m_symbol) {       // order does not belong to this OrderBook
+    m_lastFills.clear(); // failure indicator (no fills)
+    return m_lastFills;
+  }
+  if (isResting(order.getOrderID())) { // avoid readdition of same order
+    m_lastFills.clear();
+    return m_lastFills;
   }
 
   // handling any market order matching (timing by preprocessor)
@@ -50,12 +38,12 @@ std::optional<Trade> OrderBook::AddOrder(Order &order) {
       if (!m_asks.empty()) {
         // make capable enough to match with the worst ask
         // asks above it get fulfilled (may not last till worst)
-        Price newPrice = (*m_asks.rbegin()).first;
+        Price newPrice = m_asks.worst()->getPrice();
         order.setPrice(newPrice);
       }
     } else {
       if (!m_bids.empty()) {
-        Price newPrice = (*m_bids.rbegin()).first; // same logic as bids
+        Price newPrice = m_bids.worst()->getPrice(); // same logic as bids
         order.setPrice(newPrice);
       }
     }
@@ -63,160 +51,338 @@ std::optional<Trade> OrderBook::AddOrder(Order &order) {
     order.setOrderType(OrderType::OrderType::GoodTillCancel);
   }
 
-  Price price = order.getPrice();
-  Side::Side side = order.getSide();
+  // book keeps the compact record (handles, no strings), not the Order
+  OrderBook::restRecord(makeRecord(order));
+  return OrderBook::MatchPotentialOrders(); // check if match possible
+}
+
+// snapshot restore: records arrive in FIFO order of an uncrossed book
+void OrderBook::RestoreResting(const OrderRecord &record) {
+  assert(record.symbol == m_symbolHandle && !isResting(record.orderID));
+  OrderBook::restRecord(record);
+}
+
+void OrderBook::RestoreTrades(std::span<const Trade> trades) {
+  assert(m_trades.empty());
+  m_trades.reserve(trades.size());
+  for (const Trade &trade : trades)
+    m_trades.append(trade);
+}
+
+// tail of its level (created or reused when missing), indexed & chained
+void OrderBook::restRecord(const OrderRecord &record) {
+  Price price = record.price;
+  Side::Side side = record.getSide();
+  Level *restingLevel = nullptr;
+  SlotIndex slot = NullSlot;
 
   if (side == Side::Side::Buy) { // if a bid placed, check on ask (vice-versa)
-    if (m_bids.find(price) == m_bids.end()) { // if price level not exists
-      Level newBidLevel = Level(m_symbol, price, 0); // create level & pointer
-      LevelPointer newBidLevelPointer = std::make_shared<Level>(newBidLevel);
-      m_bids[price] = newBidLevelPointer; // store level on bids side
+    LevelPointer bidLevelPointer = m_bids.find(price);
+    if (bidLevelPointer == nullptr) { // if price level not exists
+      // reuse level parked at this tick, else create level & pointer
+      bidLevelPointer = m_bids.takeSpare(price);
+      if (bidLevelPointer == nullptr || !bidLevelPointer->empty())
+        bidLevelPointer =
+            std::make_shared<Level>(m_symbol, price, 0, m_orderPool);
+      m_bids.insert(price, bidLevelPointer); // store level on bids side
     }
-    m_bids[price]->AddOrder(order); // add order to the level
+    slot = bidLevelPointer->AddOrder(record); // add order to the level
+    restingLevel = bidLevelPointer.get();
+    m_bids.addDepth(price, record.remQuantity);
   } else {
-    if (m_asks.find(price) == m_asks.end()) {
-      Level newAskLevel = Level(m_symbol, price, 0);
-      LevelPointer newAskLevelPointer = std::make_shared<Level>(newAskLevel);
-      m_asks[price] = newAskLevelPointer;
+    LevelPointer askLevelPointer = m_asks.find(price);
+    if (askLevelPointer == nullptr) {
+      askLevelPointer = m_asks.takeSpare(price);
+      if (askLevelPointer == nullptr || !askLevelPointer->empty())
+        askLevelPointer =
+            std::make_shared<Level>(m_symbol, price, 0, m_orderPool);
+      m_asks.insert(price, askLevelPointer);
     }
-    m_asks[price]->AddOrder(order);
+    slot = askLevelPointer->AddOrder(record);
+    restingLevel = askLevelPointer.get();
+    m_asks.addDepth(price, record.remQuantity);
   }
-  return OrderBook::MatchPotentialOrders(); // check if match possible
+  // handle for one probe cancel/modify, chained under its participant
+  m_orderIndex.insert(record.orderID, restingLevel, slot);
+  linkParticipant(slot);
 }
 
-// orderID must exist for existing order, since only it can be deleted
-std::optional<Trade> OrderBook::CancelOrder(OrderID orderID) {
-  Price price = OrderBook::decodePriceFromOrderID(orderID);
-  Side::Side side = OrderBook::decodeSideFromOrderID(orderID);
-
-  // debugging: printed price & trade, before & after: ol size, m_x size
+OrderRecord OrderBook::makeRecord(const Order &order) {
+  OrderRecord record;
+  record.orderID = order.getOrderID();
+  record.remQuantity = order.getRemainingQuantity();
+  record.activateTime = order.getActivationTime();
+  record.deactivateTime = order.getDeactivationTime();
+  record.price = order.getPrice();
+  record.symbol = m_symbolHandle;
+  // stamped by the exchange, else interned here (standalone book)
+  record.participant = (order.getParticipantHandle() != InvalidHandle)
+                           ? order.getParticipantHandle()
+                           : m_participantNames->intern(order.getParticipantID());
+  record.orderType = static_cast<std::uint8_t>(order.getOrderType());
+  record.side = static_cast<std::uint8_t>(order.getSide());
+  record.setOrderStatus(order.getOrderStatus());
+  return record;
+}
 
-  if (side == Side::Side::Buy) {
-    if (m_bids.count(price) == 0) {
-      std::cout << "no such bid level w price " << price << std::endl;
-      return std::nullopt;
-    }
-    m_bids[price]->CancelOrder(orderID); // cancel it
-    if (m_bids[price]->getQuantity() ==
-        0) { // no more volume on level, delete it
-      m_bids.erase(price);
-    }
+ParticipantHandle OrderBook::findParticipant(const Order &order) const {
+  if (order.getParticipantHandle() != InvalidHandle)
+    return order.getParticipantHandle();
+  return m_participantNames->find(order.getParticipantID());
+}
 
-  } else {
-    if (m_asks.count(price) == 0) {
-      std::cout << "no such ask level w price " << price << std::endl;
-      return std::nullopt;
-    }
-    m_asks[price]->CancelOrder(orderID);
-    if (m_asks[price]->getQuantity() == 0) {
-      m_asks.erase(price);
-    }
+// orderID must exist for existing order, since only it can be deleted
+std::optional<Trade> OrderBook::CancelOrder(OrderID orderID) {
+  // one probe: level & slot of the resting order (no orderID decoding)
+  const OrderIndex::Entry *entry = m_orderIndex.find(orderID);
+  if (entry == nullptr) {
+    std::cout << "no resting order w orderID " << orderID << std::endl;
+    return std::nullopt;
   }
+  cancelResting(entry->level, entry->slot);
 
   // cancellation cannot yield a match: if could be matched, would have
   // ends returns std::nullopt
   return std::nullopt;
 }
 
-std::optional<Trade> OrderBook::ModifyOrder(OrderID orderID,
-                                            Order &modifiedOrder) {
-  OrderBook::CancelOrder(orderID);
-  return OrderBook::AddOrder(modifiedOrder);
+void OrderBook::removeDepth(Side::Side side, Price price, Quantity quantity) {
+  if (side == Side::Side::Buy)
+    m_bids.removeDepth(price, quantity);
+  else
+    m_asks.removeDepth(price, quantity);
 }
 
-// https://www.learncpp.com/cpp-tutorial/stdoptional/
-std::optional<Trade> OrderBook::MatchPotentialOrders() {
+Quantity OrderBook::getMatchableQuantity(Side::Side side, Price price) const {
+  // a bid meets asks at or below its price, an ask bids at or above
+  return (side == Side::Side::Buy) ? m_asks.depthThrough(price)
+                                   : m_bids.depthThrough(price);
+}
+
+void OrderBook::cancelResting(Level *level, SlotIndex slot) {
+  Side::Side side = m_orderPool[slot].getSide();
+  Price price = level->getPrice();
 
-  if ((m_bids.empty() || m_asks.empty())) { // bids & asks both must for trade
-    return std::nullopt;                    // failure indicator
+  OrderBook::removeDepth(side, price, m_orderPool[slot].remQuantity);
+  forgetResting(slot);
+  level->CancelOrder(slot); // cancel it
+  if (level->empty()) {     // no more orders on level, delete it
+    if (side == Side::Side::Buy)
+      m_bids.erase(price);
+    else
+      m_asks.erase(price);
   }
+}
 
-  // obtain best levels on each side
-  LevelPointer bestBidLevelPointer = (*m_bids.begin()).second;
-  LevelPointer bestAskLevelPointer = (*m_asks.begin()).second;
+std::size_t
+OrderBook::CancelAllForParticipant(const ParticipantID &participantID) {
+  ParticipantHandle participant = m_participantNames->find(participantID);
+  if (participant == InvalidHandle)
+    return 0;
+  return CancelAllForParticipant(participant);
+}
 
-  if (bestBidLevelPointer->getPrice() <
-      bestAskLevelPointer->getPrice()) { // bidp >= askp for trade
-    return std::nullopt;
+std::size_t OrderBook::CancelAllForParticipant(ParticipantHandle participant) {
+  if (participant >= m_participantOrders.size())
+    return 0;
+
+  // walk the participant's own chain (no scan over levels), head moves on
+  // as each order is unlinked
+  std::size_t cancelled = 0;
+  while (m_participantOrders[participant] != NullSlot) {
+    SlotIndex slot = m_participantOrders[participant];
+    const OrderIndex::Entry *entry =
+        m_orderIndex.find(m_orderPool[slot].orderID);
+    cancelResting(entry->level, slot);
+    cancelled++;
   }
+  return cancelled;
+}
 
-  // get first orders on each sides best level
-  OrderPointer bestBidOrder = bestBidLevelPointer->getOrderList().front();
-  OrderPointer bestAskOrder = bestAskLevelPointer->getOrderList().front();
-
-  // min of both qty can only be filled
-  Quantity filledQuantity = std::min(bestBidOrder->getRemainingQuantity(),
-                                     bestAskOrder->getRemainingQuantity());
-
-  // TODO: confirm correctness? askprice or bidprice
-  // ask: buyer spends less than willing & sellers get desired
-  // bid: buyers spends as much as willing & sellers get more
-  // avg of bid and ask since don't know aggressor & fair
-  double settlementPrice = (1.0 * bestAskLevelPointer->getPrice()) / 100;
-  // Price settlementPrice =
-  // (bestBidLevelPointer->getPrice() + bestAskLevelPointer->getPrice()) / 2;
-  ;
-
-  // update the remaining volume of orders
-  bestBidOrder->FillPartially(filledQuantity);
-  bestAskOrder->FillPartially(filledQuantity);
-  // update volumes of levels of both sides
-  bestBidLevelPointer->UpdateLevelQuantityPostMatch(filledQuantity);
-  bestAskLevelPointer->UpdateLevelQuantityPostMatch(filledQuantity);
-
-  // remove order from level if no remaining Quantity
-  if (bestBidOrder->isFullyFilled()) {
-    OrderID bidOrderID = bestBidOrder->getOrderID();
-    bestBidLevelPointer->removeMatchedOrder(bidOrderID); // remove order
-
-    //    if (bestBidLevelPointer->getOrderList().empty())  equivalent condition
-    if (bestBidLevelPointer->getQuantity() == 0) { // if level empty, remove it
-      m_bids.erase(bestBidLevelPointer->getPrice());
-    }
+void OrderBook::forgetResting(SlotIndex slot) {
+  m_orderIndex.erase(m_orderPool[slot].orderID);
+  unlinkParticipant(slot);
+}
+
+// newest order becomes head of its participant's chain
+void OrderBook::linkParticipant(SlotIndex slot) {
+  OrderPool::Slot &entry = m_orderPool[slot];
+  // handles are dense: heads grow w the table (NullSlot when no orders)
+  if (entry.participant >= m_participantOrders.size())
+    m_participantOrders.resize(entry.participant + 1, NullSlot);
+  SlotIndex &head = m_participantOrders[entry.participant];
+  entry.links.participantPrev = NullSlot;
+  entry.links.participantNext = head;
+  if (head != NullSlot)
+    m_orderPool[head].links.participantPrev = slot;
+  head = slot;
+}
+
+void OrderBook::unlinkParticipant(SlotIndex slot) {
+  OrderRecord::Links &links = m_orderPool[slot].links;
+  if (links.participantPrev != NullSlot)
+    m_orderPool[links.participantPrev].links.participantNext =
+        links.participantNext;
+  else
+    m_participantOrders[m_orderPool[slot].participant] = links.participantNext;
+  if (links.participantNext != NullSlot)
+    m_orderPool[links.participantNext].links.participantPrev =
+        links.participantPrev;
+  links.participantPrev = links.participantNext = NullSlot;
+}
+
+// pure size reduction of the same order (nothing else may change)
+static bool isSizeDown(const OrderRecord &resting, const Order &modifiedOrder,
+                       ParticipantHandle modifiedParticipant) {
+  return modifiedOrder.getSide() == resting.getSide() &&
+         modifiedOrder.getPrice() == resting.price &&
+         modifiedOrder.getOrderType() == resting.getOrderType() &&
+         modifiedParticipant == resting.participant &&
+         modifiedOrder.getRemainingQuantity() > 0 &&
+         modifiedOrder.getRemainingQuantity() <= resting.remQuantity;
+}
+
+bool OrderBook::canAmendInPlace(OrderID orderID,
+                                const Order &modifiedOrder) const {
+  const OrderIndex::Entry *entry = m_orderIndex.find(orderID);
+  return entry != nullptr && modifiedOrder.getSymbol() == m_symbol &&
+         isSizeDown(m_orderPool[entry->slot], modifiedOrder,
+                    findParticipant(modifiedOrder));
+}
+
+TradeBatch OrderBook::ModifyOrder(OrderID orderID, Order &modifiedOrder) {
+  const OrderIndex::Entry *entry = m_orderIndex.find(orderID);
+  if (entry == nullptr || modifiedOrder.getSymbol() != m_symbol ||
+      !isSizeDown(m_orderPool[entry->slot], modifiedOrder,
+                  findParticipant(modifiedOrder))) {
+    OrderBook::CancelOrder(orderID);
+    return OrderBook::AddOrder(modifiedOrder);
   }
-  if (bestAskOrder->isFullyFilled()) {
-    OrderID askOrderID = bestAskOrder->getOrderID();
-    bestAskLevelPointer->removeMatchedOrder(askOrderID);
-    if (bestAskLevelPointer->getQuantity() == 0) {
-      m_asks.erase(bestAskLevelPointer->getPrice());
-    }
+
+  // less size at the same price can't cross: no match, no reallocation
+  Level *level = entry->level;
+  SlotIndex slot = entry->slot;
+  OrderBook::removeDepth(modifiedOrder.getSide(), level->getPrice(),
+                         m_orderPool[slot].remQuantity -
+                             modifiedOrder.getRemainingQuantity());
+  level->AmendOrder(slot, makeRecord(modifiedOrder));
+
+  // same handle answers to the new orderID from now on
+  if (modifiedOrder.getOrderID() != orderID) {
+    m_orderIndex.erase(orderID);
+    m_orderIndex.insert(modifiedOrder.getOrderID(), level, slot);
   }
+  m_lastFills.clear();
+  return m_lastFills;
+}
 
-  // store trade information
-  OrderTraded bidTrade =
-      OrderTraded(m_symbol, bestBidOrder->getOrderID(), settlementPrice,
-                  filledQuantity, bestBidOrder->getParticipantID());
-  OrderTraded askTrade =
-      OrderTraded(m_symbol, bestAskOrder->getOrderID(), settlementPrice,
-                  filledQuantity, bestAskOrder->getParticipantID());
+// aggressor may cross several levels (or several orders at a level)
+// keep matching best bid against best ask till book is neither locked
+// (bidp == askp) nor crossed (bidp > askp), all fills returned as one batch
+TradeBatch OrderBook::MatchPotentialOrders() {
+  m_lastFills.clear();
+
+  // bids & asks both must for trade
+  while (!m_bids.empty() && !m_asks.empty()) {
+    // obtain best levels on each side (cursor in ladder mode)
+    LevelPointer bestBidLevelPointer = m_bids.best();
+    LevelPointer bestAskLevelPointer = m_asks.best();
+
+    if (bestBidLevelPointer->getPrice() <
+        bestAskLevelPointer->getPrice()) { // bidp >= askp for trade
+      break;
+    }
 
-  Trade trade = Trade{bidTrade, askTrade};
-  m_trades.push_back(trade); // store trades
-  return trade;
+    // a spill the log needs fails here, before any order or level moves
+    m_trades.prepareAppend();
+
+    // first orders on each sides best level (viewed in place, no copies)
+    OrderRecord &bestBidOrder = bestBidLevelPointer->front();
+    OrderRecord &bestAskOrder = bestAskLevelPointer->front();
+
+    // min of both qty can only be filled
+    Quantity filledQuantity =
+        std::min(bestBidOrder.remQuantity, bestAskOrder.remQuantity);
+
+    // TODO: confirm correctness? askprice or bidprice
+    // ask: buyer spends less than willing & sellers get desired
+    // bid: buyers spends as much as willing & sellers get more
+    // avg of bid and ask since don't know aggressor & fair
+    double settlementPrice = (1.0 * bestAskLevelPointer->getPrice()) / 100;
+
+    // update the remaining volume of orders
+    bestBidOrder.FillPartially(filledQuantity);
+    bestAskOrder.FillPartially(filledQuantity);
+    // update volumes of levels of both sides
+    bestBidLevelPointer->UpdateLevelQuantityPostMatch(filledQuantity);
+    bestAskLevelPointer->UpdateLevelQuantityPostMatch(filledQuantity);
+    m_bids.removeDepth(bestBidLevelPointer->getPrice(), filledQuantity);
+    m_asks.removeDepth(bestAskLevelPointer->getPrice(), filledQuantity);
+
+    // store trade information (before removal, level owns the orders)
+    // handles only: no string copied per fill
+    OrderTraded bidTrade =
+        OrderTraded(m_symbolHandle, bestBidOrder.orderID, settlementPrice,
+                    filledQuantity, bestBidOrder.participant);
+    OrderTraded askTrade =
+        OrderTraded(m_symbolHandle, bestAskOrder.orderID, settlementPrice,
+                    filledQuantity, bestAskOrder.participant);
+
+    m_lastFills.emplace_back(bidTrade, askTrade);
+    m_trades.append(m_lastFills.back()); // store trades
+    // each side's consumer touches just this fill (no history walk)
+    if (m_bidFillListener)
+      m_bidFillListener(bidTrade);
+    if (m_askFillListener)
+      m_askFillListener(askTrade);
+    if (m_tradeListener)
+      m_tradeListener(m_lastFills.back());
+
+    // remove order from level if no remaining Quantity
+    if (bestBidOrder.isFullyFilled()) {
+      SlotIndex bidSlot = bestBidLevelPointer->frontSlot();
+      forgetResting(bidSlot);
+      bestBidLevelPointer->removeMatchedOrder(bidSlot); // remove order
+
+      //    if (bestBidLevelPointer->getQuantity() == 0)  equivalent condition
+      if (bestBidLevelPointer->empty()) { // level empty, remove it
+        m_bids.erase(bestBidLevelPointer->getPrice());
+      }
+    }
+    if (bestAskOrder.isFullyFilled()) {
+      SlotIndex askSlot = bestAskLevelPointer->frontSlot();
+      forgetResting(askSlot);
+      bestAskLevelPointer->removeMatchedOrder(askSlot);
+      if (bestAskLevelPointer->empty()) {
+        m_asks.erase(bestAskLevelPointer->getPrice());
+      }
+    }
+  }
+  return m_lastFills;
 }
 
 void OrderBook::printOrderBookState(const std::string &message) {
   std::cout << message << std::endl;
 
   std::cout << "----------BID------------" << std::endl;
-  for (auto &ele : OrderBook::getBidLevels()) {
-    auto &lev = ele.second;
+  for (const auto &ele : m_bids) {
+    const auto &lev = ele.second;
     std::cout << lev->getPrice() << " " << lev->getQuantity() << " "
-              << lev->getOrderList().size() << std::endl;
+              << lev->getOrderCount() << std::endl;
   }
   std::cout << "----------DONE------------" << std::endl << std::endl;
 
   std::cout << "----------ASK------------" << std::endl;
 
-  for (auto &ele : OrderBook::getAskLevels()) {
-    auto &lev = ele.second;
+  for (const auto &ele : m_asks) {
+    const auto &lev = ele.second;
     std::cout << lev->getPrice() << " " << lev->getQuantity() << " "
-              << lev->getOrderList().size() << std::endl;
+              << lev->getOrderCount() << std::endl;
   }
   std::cout << "----------DONE------------" << std::endl << std::endl;
 
   std::cout << "---------TRADES-----------" << std::endl;
-  for (auto &MatchedTrade : OrderBook::getTrades()) {
+  for (const auto &MatchedTrade : m_trades) {
     MatchedTrade.printMatchTime();
     std::cout << "price: " << MatchedTrade.getMatchedBid().price
               << " filledqty: " << MatchedTrade.getMatchedBid().quantityFilled
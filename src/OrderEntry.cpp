@@ -0,0 +1,257 @@
+#include "include/OrderEntry.hpp"
+#include "include/Xchange.hpp"
+#include "utils/Constants.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/enums/Actions.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+// byte offsets (after the header: symbol first in every message)
+constexpr std::size_t LengthAt = 0, TypeAt = 2, VersionAt = 3,
+                      ParticipantAt = 4, SymbolAt = 8;
+constexpr std::size_t PriceAt = 12, QuantityAt = 16, SideAt = 24,
+                      OrderTypeAt = 25, ActivationAt = 32,
+                      DeactivationAt = 40, OldOrderIDAt = 48;
+constexpr std::size_t CancelSideAt = 12, CancelOrderTypeAt = 13,
+                      CancelOrderIDAt = 16;
+
+// unaligned little endian field access (plain loads/stores on x86/arm)
+template <typename T> T load(const char *at)
+{
+  T value;
+  std::memcpy(&value, at, sizeof(T));
+  if constexpr (std::endian::native == std::endian::big)
+    value = std::byteswap(value);
+  return value;
+}
+
+template <typename T> void store(char *at, T value)
+{
+  if constexpr (std::endian::native == std::endian::big)
+    value = std::byteswap(value);
+  std::memcpy(at, &value, sizeof(T));
+}
+
+std::int64_t toNanoseconds(TimeStamp time)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+TimeStamp fromNanoseconds(std::int64_t ns)
+{
+  return TimeStamp{std::chrono::duration_cast<TimeStamp::duration>(
+      std::chrono::nanoseconds{ns})};
+}
+
+// body shared by new & replace
+void storeOrder(char *message, SymbolHandle symbol, Side::Side side,
+                OrderType::OrderType orderType, Price price, Quantity quantity,
+                TimeStamp activationTime, TimeStamp deactivationTime)
+{
+  store<std::uint32_t>(message + SymbolAt, symbol);
+  store<std::int32_t>(message + PriceAt, price);
+  store<std::uint64_t>(message + QuantityAt, quantity);
+  store<std::uint8_t>(message + SideAt, static_cast<std::uint8_t>(side));
+  store<std::uint8_t>(message + OrderTypeAt,
+                      static_cast<std::uint8_t>(orderType));
+  store<std::int64_t>(message + ActivationAt, toNanoseconds(activationTime));
+  store<std::int64_t>(message + DeactivationAt,
+                      (deactivationTime == Constants::EndOfTime)
+                          ? 0
+                          : toNanoseconds(deactivationTime));
+}
+
+[[noreturn]] void malformed(const std::string &why)
+{
+  throw std::runtime_error("order entry message could NOT be decoded: " + why);
+}
+
+Side::Side sideAt(const char *at)
+{
+  std::uint8_t side = load<std::uint8_t>(at);
+  if (side > Side::Side::Sell)
+    malformed("side");
+  return static_cast<Side::Side>(side);
+}
+
+OrderType::OrderType orderTypeAt(const char *at)
+{
+  std::uint8_t orderType = load<std::uint8_t>(at);
+  if (orderType > OrderType::OrderType::Market)
+    malformed("order type");
+  return static_cast<OrderType::OrderType>(orderType);
+}
+} // namespace
+
+namespace OrderEntry
+{
+char *Encoder::append(MessageType type, std::size_t bytes,
+                      ParticipantHandle participant)
+{
+  std::size_t offset = m_buffer.size();
+  m_buffer.resize(offset + bytes); // reserved bytes stay zero
+  char *message = m_buffer.data() + offset;
+  store<std::uint16_t>(message + LengthAt, static_cast<std::uint16_t>(bytes));
+  store<std::uint8_t>(message + TypeAt, static_cast<std::uint8_t>(type));
+  store<std::uint8_t>(message + VersionAt, Version);
+  store<std::uint32_t>(message + ParticipantAt, participant);
+  return message;
+}
+
+void Encoder::newOrder(ParticipantHandle participant, SymbolHandle symbol,
+                       Side::Side side, OrderType::OrderType orderType,
+                       Price price, Quantity quantity, TimeStamp activationTime,
+                       TimeStamp deactivationTime)
+{
+  char *message = append(MessageType::NewOrder, NewOrderBytes, participant);
+  storeOrder(message, symbol, side, orderType, price, quantity,
+             activationTime, deactivationTime);
+}
+
+void Encoder::replaceOrder(ParticipantHandle participant, OrderID oldOrderID,
+                           SymbolHandle symbol, Side::Side side,
+                           OrderType::OrderType orderType, Price price,
+                           Quantity quantity, TimeStamp activationTime,
+                           TimeStamp deactivationTime)
+{
+  char *message =
+      append(MessageType::ReplaceOrder, ReplaceOrderBytes, participant);
+  storeOrder(message, symbol, side, orderType, price, quantity,
+             activationTime, deactivationTime);
+  store<std::uint64_t>(message + OldOrderIDAt, oldOrderID);
+}
+
+void Encoder::cancelOrder(ParticipantHandle participant, OrderID orderID,
+                          SymbolHandle symbol, Side::Side side,
+                          OrderType::OrderType orderType)
+{
+  char *message =
+      append(MessageType::CancelOrder, CancelOrderBytes, participant);
+  store<std::uint32_t>(message + SymbolAt, symbol);
+  store<std::uint8_t>(message + CancelSideAt, static_cast<std::uint8_t>(side));
+  store<std::uint8_t>(message + CancelOrderTypeAt,
+                      static_cast<std::uint8_t>(orderType));
+  store<std::uint64_t>(message + CancelOrderIDAt, orderID);
+}
+
+std::size_t Decoder::parse(const char *data, std::size_t size,
+                           OrderRequest &request)
+{
+  if (size < HeaderBytes)
+    return 0;
+  std::size_t length = load<std::uint16_t>(data + LengthAt);
+  MessageType type = static_cast<MessageType>(load<std::uint8_t>(data + TypeAt));
+  std::size_t expected = 0;
+  switch (type)
+  {
+  case MessageType::NewOrder:
+    expected = NewOrderBytes;
+    break;
+  case MessageType::ReplaceOrder:
+    expected = ReplaceOrderBytes;
+    break;
+  case MessageType::CancelOrder:
+    expected = CancelOrderBytes;
+    break;
+  default:
+    malformed("type");
+  }
+  if (load<std::uint8_t>(data + VersionAt) != Version)
+    malformed("version");
+  if (length != expected)
+    malformed("length");
+  if (size < length)
+    return 0;
+
+  request.participant = load<std::uint32_t>(data + ParticipantAt);
+  request.symbol = load<std::uint32_t>(data + SymbolAt);
+  request.orderID.reset();
+  if (type == MessageType::CancelOrder)
+  {
+    request.action = Actions::Actions::Cancel;
+    request.oldOrderID = load<std::uint64_t>(data + CancelOrderIDAt);
+    request.side = sideAt(data + CancelSideAt);
+    request.orderType = orderTypeAt(data + CancelOrderTypeAt);
+    request.price.reset();
+    request.quantity.reset();
+    request.activationTime.reset();
+    request.deactivationTime.reset();
+    return length;
+  }
+
+  request.action = (type == MessageType::NewOrder) ? Actions::Actions::Add
+                                                   : Actions::Actions::Modify;
+  if (type == MessageType::ReplaceOrder)
+    request.oldOrderID = load<std::uint64_t>(data + OldOrderIDAt);
+  else
+    request.oldOrderID.reset();
+  request.side = sideAt(data + SideAt);
+  request.orderType = orderTypeAt(data + OrderTypeAt);
+  request.price = load<std::int32_t>(data + PriceAt);
+  request.quantity = load<std::uint64_t>(data + QuantityAt);
+  // 0 on the wire: NOW / EOT
+  std::int64_t activation = load<std::int64_t>(data + ActivationAt);
+  request.activationTime =
+      (activation == 0) ? Constants::Now : fromNanoseconds(activation);
+  std::int64_t deactivation = load<std::int64_t>(data + DeactivationAt);
+  request.deactivationTime = (deactivation == 0)
+                                 ? Constants::EndOfTime
+                                 : fromNanoseconds(deactivation);
+  return length;
+}
+
+std::size_t Decoder::decode(const char *data, std::size_t size)
+{
+  std::size_t consumed = 0;
+  while (true)
+  {
+    std::size_t length = 0;
+    try
+    {
+      length = Decoder::parse(data + consumed, size - consumed, m_request);
+    }
+    catch (const std::exception &error)
+    {
+      // nothing past it can be framed: ack it (only its header's
+      // participant is known) & hand back what was placed before it
+      m_request = OrderRequest{};
+      m_request.participant =
+          load<std::uint32_t>(data + consumed + ParticipantAt);
+      if (m_acknowledge)
+        m_acknowledge(m_request, std::nullopt, error.what());
+      return consumed;
+    }
+    if (length == 0)
+      break;
+    consumed += length;
+    std::optional<OrderID> orderID;
+    try
+    {
+      orderID = m_xchange.placeOrder(m_request);
+    }
+    catch (const std::exception &error)
+    {
+      if (m_acknowledge)
+        m_acknowledge(m_request, std::nullopt, error.what());
+      continue;
+    }
+    if (m_acknowledge)
+      m_acknowledge(m_request, orderID, {});
+  }
+  return consumed;
+}
+} // namespace OrderEntry
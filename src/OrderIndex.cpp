@@ -0,0 +1,117 @@
+#include "include/OrderIndex.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/alias/OrderRel.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+OrderIndex::OrderIndex(std::size_t capacity)
+{
+  rehash(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity));
+}
+
+std::size_t OrderIndex::home(OrderID orderID) const
+{
+  // fibonacci hashing: orderIDs come from a plain monotonic sequence, the
+  // multiply spreads the consecutive ids & the top bits pick the bucket
+  return static_cast<std::size_t>((orderID * 0x9E3779B97F4A7C15ull) >>
+                                  m_shift);
+}
+
+const OrderIndex::Entry *OrderIndex::find(OrderID orderID) const
+{
+  const std::size_t mask = m_table.size() - 1;
+  for (std::size_t pos = home(orderID);; pos = (pos + 1) & mask)
+  {
+    const Entry &entry = m_table[pos];
+    if (entry.slot == NullSlot)
+    {
+      return nullptr;
+    }
+    if (entry.orderID == orderID)
+    {
+      return &entry;
+    }
+  }
+}
+
+bool OrderIndex::insert(OrderID orderID, Level *level, SlotIndex slot)
+{
+  if (2 * (m_size + 1) > m_table.size())
+  {
+    rehash(2 * m_table.size());
+  }
+  const std::size_t mask = m_table.size() - 1;
+  for (std::size_t pos = home(orderID);; pos = (pos + 1) & mask)
+  {
+    Entry &entry = m_table[pos];
+    if (entry.slot == NullSlot)
+    {
+      entry = Entry{orderID, level, slot};
+      m_size++;
+      return true;
+    }
+    if (entry.orderID == orderID)
+    {
+      return false; // already resting
+    }
+  }
+}
+
+bool OrderIndex::erase(OrderID orderID)
+{
+  const std::size_t mask = m_table.size() - 1;
+  std::size_t hole = home(orderID);
+  for (;; hole = (hole + 1) & mask)
+  {
+    if (m_table[hole].slot == NullSlot)
+    {
+      return false;
+    }
+    if (m_table[hole].orderID == orderID)
+    {
+      break;
+    }
+  }
+
+  // backward shift: pull later entries of the run into the hole if the hole
+  // lies between their home bucket & where they sit now
+  for (std::size_t pos = (hole + 1) & mask; m_table[pos].slot != NullSlot;
+       pos = (pos + 1) & mask)
+  {
+    std::size_t want = home(m_table[pos].orderID);
+    if (((pos - want) & mask) >= ((pos - hole) & mask))
+    {
+      m_table[hole] = m_table[pos];
+      hole = pos;
+    }
+  }
+  m_table[hole] = Entry{};
+  m_size--;
+  return true;
+}
+
+void OrderIndex::reserve(std::size_t count)
+{
+  if (2 * count > m_table.size())
+  {
+    rehash(std::bit_ceil(2 * count));
+  }
+}
+
+void OrderIndex::rehash(std::size_t capacity)
+{
+  std::vector<Entry> old = std::exchange(m_table, std::vector<Entry>(capacity));
+  m_shift = 64 - static_cast<unsigned>(std::countr_zero(capacity));
+  m_size = 0;
+  for (const Entry &entry : old)
+  {
+    if (entry.slot != NullSlot)
+    {
+      insert(entry.orderID, entry.level, entry.slot);
+    }
+  }
+}
@@ -0,0 +1,55 @@
+#include "include/OrderPool.hpp"
+#include "utils/alias/OrderRel.hpp"
+
+#include <cstddef>
+#include <memory>
+
+void OrderPool::carveSlab()
+{
+  SlotIndex first = static_cast<SlotIndex>(getCapacity());
+  m_slabs.push_back(std::make_unique<Slot[]>(SlabSize));
+
+  // chain new slots in index order (lowest handed out first)
+  Slot *slab = m_slabs.back().get();
+  for (std::size_t i = 0; i < SlabSize; i++)
+  {
+    slab[i].links.next = (i + 1 < SlabSize)
+                             ? first + static_cast<SlotIndex>(i + 1)
+                             : m_freeHead;
+  }
+  m_freeHead = first;
+}
+
+SlotIndex OrderPool::acquire(const OrderRecord &record)
+{
+  if (m_freeHead == NullSlot)
+  {
+    carveSlab();
+  }
+  SlotIndex slot = m_freeHead;
+  Slot &entry = (*this)[slot];
+  m_freeHead = entry.links.next;
+
+  // plain 64 byte copy (record holds no strings), links start detached
+  entry = record;
+  entry.links = OrderRecord::Links{};
+  m_liveCount++;
+  return slot;
+}
+
+void OrderPool::release(SlotIndex slot)
+{
+  Slot &entry = (*this)[slot];
+  entry.links.prev = NullSlot;
+  entry.links.next = m_freeHead; // last freed slot reused first (in cache)
+  m_freeHead = slot;
+  m_liveCount--;
+}
+
+void OrderPool::reserve(std::size_t count)
+{
+  while (getCapacity() - m_liveCount < count)
+  {
+    carveSlab();
+  }
+}
@@ -1,5 +1,7 @@
+#include "include/Order.hpp"
 #include "include/OrderTraded.hpp"
 #include "include/Trade.hpp"
+#include "utils/Constants.hpp"
 #include "utils/alias/Fundamental.hpp"
 #include "utils/alias/OrderRel.hpp"
 #include "utils/enums/Actions.hpp"
@@ -7,12 +9,11 @@
 #include "utils/enums/Side.hpp"
 #include <cassert>
 #include <cstddef>
+#include <optional>
 #include <include/Participant.hpp>
 #include <vector>
 
-std::size_t Participant::lastProcessedTradeIndex = 0;
-
-Participant::Participant(const std::string &localTimeZoneOfParticipant) : localTimeZone{localTimeZoneOfParticipant} {}
+Participant::Participant(const std::string &localTimeZoneOfParticipant) : m_symbolNames{std::make_shared<InternTable>()}, localTimeZone{localTimeZoneOfParticipant} {}
 
 Participant::Participant() : Participant("Asia/Kolkata") {};
 
@@ -35,8 +36,19 @@ OrderPointer Participant::recordNonCancelOrder(
     const Actions::Actions action, const Symbol &symbol,
     const OrderType::OrderType orderType, const Side::Side side,
     const double price, const Quantity quantity,
-    const ParticipantID &participantID, const std::string &activationTime,
-    const std::string &deactivationTime)
+    const ParticipantID &participantID)
+{
+  return Participant::recordNonCancelOrder(
+      action, symbol, orderType, side, Order::toTicks(price), quantity,
+      participantID, Constants::Now, Constants::EndOfTime);
+}
+
+OrderPointer Participant::recordNonCancelOrder(
+    const Actions::Actions action, const Symbol &symbol,
+    const OrderType::OrderType orderType, const Side::Side side,
+    const Price price, const Quantity quantity,
+    const ParticipantID &participantID, TimeStamp activationTime,
+    TimeStamp deactivationTime, std::optional<OrderID> assignedID)
 {
 
   assert(action != Actions::Actions::Cancel);
@@ -46,7 +58,10 @@ OrderPointer Participant::recordNonCancelOrder(
   // when an order is seen as a trade, it will be marked as processed
   OrderPointer orderptr =
       std::make_shared<Order>(symbol, orderType, side, price, quantity,
-                              participantID, activationTime, deactivationTime);
+                              participantID, activationTime, deactivationTime,
+                              assignedID);
+  // book keys the resting record by this handle (no string compare)
+  orderptr->setParticipantHandle(m_participantHandle);
   OrderID orderID = orderptr->getOrderID();
   ParticipantOrderInfo partorderinfo =
       ParticipantOrderInfo(orderID, action, symbol, orderType, side);
@@ -56,58 +71,62 @@ OrderPointer Participant::recordNonCancelOrder(
   return orderptr;
 }
 
-void Participant::recordTrades(const std::vector<Trade> &trades)
+// O(1) per trade: only called for trades naming this participant
+// a self trade books nothing (its legs cancel out, only the orders' status
+// moves), a fill of an order no longer tracked is history only
+void Participant::recordTrade(const Trade &trade)
 {
-
-  std::size_t validTrades = 0;
-  for (std::size_t idx = Participant::lastProcessedTradeIndex;
-       idx < trades.size(); idx++)
+  const OrderTraded &bid = trade.getMatchedBid();
+  const OrderTraded &ask = trade.getMatchedAsk();
+  const bool buys = (bid.participant == m_participantHandle);
+  const bool sells = (ask.participant == m_participantHandle);
+  if (buys && sells)
   {
-    Trade trade = trades[idx];
-    ParticipantID buyPartID = trade.getMatchedBid().participantID;
-    ParticipantID sellPartID = trade.getMatchedAsk().participantID;
-
-    if (buyPartID == m_participantID && sellPartID == m_participantID)
-      continue;
-
-    if (buyPartID != m_participantID && sellPartID != m_participantID)
-      continue;
-
-    validTrades++;
-    m_historyOfTrades.push_back(trade);
-
-    OrderID buyOrderID = trade.getMatchedBid().orderID;
-    OrderID sellOrderID = trade.getMatchedAsk().orderID;
-    OrderID matchedID =
-        ((buyPartID == m_participantID) ? buyOrderID : sellOrderID);
-    Side::Side side =
-        ((matchedID == buyOrderID) ? Side::Side::Buy : Side::Side::Sell);
-
-    if (m_orderComposition.count(matchedID) == 0)
-      continue;
-    Participant::updateOrderStatus(matchedID);
-    Participant::updatePortfolio(side, trade);
+    Participant::updateOrderStatus(bid.orderID);
+    Participant::updateOrderStatus(ask.orderID);
+    return;
   }
-  Participant::lastProcessedTradeIndex += validTrades;
+  if (!buys && !sells)
+    return;
+
+  m_historyOfTrades.push_back(trade);
+  const OrderID matchedID = (buys ? bid.orderID : ask.orderID);
+  if (m_orderComposition.count(matchedID) == 0)
+    return;
+  Participant::updateOrderStatus(matchedID);
+  Participant::updatePortfolio((buys ? Side::Side::Buy : Side::Side::Sell),
+                               trade);
+}
+
+void Participant::recordTrades(const std::vector<Trade> &trades)
+{
+  for (const Trade &trade : trades)
+    Participant::recordTrade(trade);
 }
 
 void Participant::updateOrderStatus(const OrderID &matchedID)
 {
-  if (m_orderComposition[matchedID]->isFullyFilled())
-    m_orderComposition[matchedID]->setOrderStatus(
-        OrderStatus::OrderStatus::Fulfilled);
+  auto it = m_orderComposition.find(matchedID);
+  if (it == m_orderComposition.end())
+    return; // cancelled/replaced since, nothing left to mark
+  if (it->second->isFullyFilled())
+    it->second->setOrderStatus(OrderStatus::OrderStatus::Fulfilled);
 }
 
 void Participant::updatePortfolio(const Side::Side &side, const Trade &trade)
 {
   OrderTraded tradedOrder = ((side == Side::Side::Buy) ? trade.getMatchedBid()
                                                        : trade.getMatchedAsk());
-  Amount original = m_portfolio[trade.getSymbol()];
-  Amount updated =
-      original +
+  // portfolio is per name: the tracked order's own symbol (a participant
+  // without an exchange has no names), else resolved by the shared table
+  auto tracked = m_orderComposition.find(tradedOrder.orderID);
+  const Symbol &symbol = (tracked != m_orderComposition.end())
+                             ? tracked->second->getSymbol()
+                             : m_symbolNames->name(trade.getSymbol());
+  Amount &holding = m_portfolio[symbol];
+  holding +=
       ((side == Side::Side::Buy) ? 1 : -1) *
-          static_cast<Amount>(tradedOrder.price * tradedOrder.quantityFilled);
-  m_portfolio[trade.getSymbol()] = updated;
+      static_cast<Amount>(tradedOrder.price * tradedOrder.quantityFilled);
 }
 
 ParticipantID Participant::getParticipantID() const { return m_participantID; }
@@ -180,6 +199,16 @@ void Participant::setParticipantID(const ParticipantID &newID)
   m_participantID = newID;
 }
 
+void Participant::setParticipantHandle(ParticipantHandle handle)
+{
+  m_participantHandle = handle;
+}
+
+void Participant::setSymbolNames(InternTablePointer symbolNames)
+{
+  m_symbolNames = symbolNames;
+}
+
 bool Participant::isSymbolInPortfolio(const std::string &symbol) const
 {
   return (m_portfolio.contains(symbol));
@@ -0,0 +1,106 @@
+#include "include/Pipeline.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <thread>
+#include <utility>
+
+namespace
+{
+// empty polls before a waiting thread yields its core
+constexpr std::size_t SpinsBeforeYield = 256;
+} // namespace
+
+Pipeline::Pipeline(std::size_t capacity, std::vector<Stage> stages)
+    : m_events(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity)),
+      m_mask{m_events.size() - 1}, m_stages{std::move(stages)},
+      m_done{std::make_unique<Cursor[]>(m_stages.size())}
+{
+  for (std::size_t index = 0; index < m_stages.size(); index++)
+    m_threads.emplace_back([this, index]
+                           { Pipeline::runStage(index); });
+}
+
+Pipeline::~Pipeline() { Pipeline::stop(); }
+
+PipelineEvent &Pipeline::claim()
+{
+  Sequence next = m_claimed + 1;
+  Sequence wrap = next - static_cast<Sequence>(m_events.size());
+  // slot still owned by some stage: wait for the last one to move on
+  if (!m_stages.empty() && m_cachedGate < wrap)
+  {
+    const std::atomic<Sequence> &gate = m_done[m_stages.size() - 1].value;
+    std::size_t idle = 0;
+    while ((m_cachedGate = gate.load(std::memory_order_acquire)) < wrap)
+    {
+      if (++idle >= SpinsBeforeYield)
+      {
+        std::this_thread::yield();
+        idle = 0;
+      }
+    }
+  }
+  return m_events[static_cast<std::size_t>(next) & m_mask];
+}
+
+void Pipeline::publish()
+{
+  m_claimed++;
+  m_published.value.store(m_claimed, std::memory_order_release);
+}
+
+void Pipeline::drain() const
+{
+  if (m_stages.empty())
+    return;
+  const std::atomic<Sequence> &gate = m_done[m_stages.size() - 1].value;
+  while (gate.load(std::memory_order_acquire) != m_claimed)
+    std::this_thread::yield();
+}
+
+void Pipeline::stop()
+{
+  if (m_threads.empty())
+    return;
+  Pipeline::drain();
+  m_running.store(false, std::memory_order_release);
+  for (std::thread &thread : m_threads)
+    thread.join();
+  m_threads.clear();
+}
+
+// batches: everything the stage ahead finished is handled in one go & the
+// stage's own sequence published once at the end
+void Pipeline::runStage(std::size_t index)
+{
+  const std::atomic<Sequence> &ahead =
+      (index == 0) ? m_published.value : m_done[index - 1].value;
+  std::atomic<Sequence> &done = m_done[index].value;
+  const Stage &stage = m_stages[index];
+  Sequence next = 0;
+  std::size_t idle = 0;
+  while (true)
+  {
+    Sequence available = ahead.load(std::memory_order_acquire);
+    if (available >= next)
+    {
+      for (Sequence sequence = next; sequence <= available; sequence++)
+        stage(m_events[static_cast<std::size_t>(sequence) & m_mask],
+              sequence == available);
+      done.store(available, std::memory_order_release);
+      next = available + 1;
+      idle = 0;
+      continue;
+    }
+    // stop only comes after a drain, so nothing is left behind
+    if (!m_running.load(std::memory_order_acquire))
+      break;
+    if (++idle >= SpinsBeforeYield)
+    {
+      std::this_thread::yield();
+      idle = 0;
+    }
+  }
+}
@@ -1,9 +1,13 @@
 #include "include/Preprocess.hpp"
+#include "include/Clock.hpp"
 #include "include/OrderBook.hpp"
+#include "include/TimerWheel.hpp"
+#include "utils/Constants.hpp"
 #include "utils/alias/Fundamental.hpp"
 #include "utils/alias/OrderBookRel.hpp"
 #include "utils/alias/OrderRel.hpp"
 #include "utils/enums/Actions.hpp"
+#include "utils/enums/OrderStatus.hpp"
 #include "utils/enums/OrderTypes.hpp"
 #include "utils/enums/Side.hpp"
 
@@ -21,8 +25,7 @@
 TimeStamp PreProcessor::getLocalTime()
 {
   // set to IST at the moment
-  TimeStamp now = std::chrono::system_clock::now();
-  return now;
+  return Clock::now();
 }
 
 //////////////////////////////////////////
@@ -31,54 +34,22 @@ TimeStamp PreProcessor::getLocalTime()
 
 PreProcessor::OrderActionInfo::OrderActionInfo(const OrderID &orderId,
                                                OrderType::OrderType orderType,
-                                               Actions::Actions action)
-    : orderID{orderId}, orderType{orderType}, action{action} {};
-
-Side::Side
-PreProcessor::OrderActionInfo::decodeSideFromOrderID(const OrderID orderID)
-{
-  return ((orderID & 0x1)
-              ? Side::Side::Buy
-              : Side::Side::Sell); // side is the last bit of orderID
-}
-
-Price PreProcessor::OrderActionInfo::decodePriceFromOrderID(
-    const OrderID orderID)
-{
-  auto price = (orderID >> 1) & ((static_cast<OrderID>(1) << 31) - 1);
-  return price;
-}
+                                               Actions::Actions action,
+                                               Side::Side side, Price price)
+    : orderID{orderId}, orderType{orderType}, action{action}, side{side},
+      price{price} {};
 
 bool PreProcessor::OrderActionInfo::operator<(
     const OrderActionInfo &other) const
 {
-  OrderID thisID = this->orderID;
-  OrderID otherID = other.orderID;
-
-  // | 63-32 (timestamp) | 31-1 (price) | 0 (side) |
-  Side::Side thisSide = decodeSideFromOrderID(thisID);
-  assert(thisSide == decodeSideFromOrderID(otherID));
-
-  Price thisPrice = decodePriceFromOrderID(thisID);
-  Price otherPrice = decodePriceFromOrderID(otherID);
-
-  auto thisTime = (thisID >> 32);
-  auto otherTime = (otherID >> 32);
-
-  if (thisPrice == otherPrice)
+  assert(side == other.side);
+  if (price == other.price)
   {
     // must be < not <= since == op works as !(a<b) & !(b<a) in multiset
-    return thisTime < otherTime;
-  }
-
-  if (thisSide == Side::Side::Buy)
-  {
-    return thisPrice > otherPrice;
-  }
-  else
-  {
-    return thisPrice < otherPrice;
+    return orderID < other.orderID;
   }
+  return (side == Side::Side::Buy) ? price > other.price
+                                   : price < other.price;
 }
 
 //////////////////////////////////////////
@@ -90,33 +61,53 @@ PreProcessor::PreProcessor(std::shared_ptr<OrderBook> &orderbookPtr,
                            std::size_t pendingOrdersThreshold,
                            std::chrono::milliseconds pendingDurationThreshold,
                            const std::string &localTimeZone,
-                           const TimeTuple &timeTuple)
+                           const TimeTuple &timeTuple,
+                           SessionCalendarPointer calendar)
     : m_orderbookPtr{orderbookPtr}, m_isBidPreprocessor{isBidPreprocessor}, m_MAX_PENDING_ORDERS_THRESHOLD{pendingOrdersThreshold},
-      m_MAX_PENDING_DURATION{pendingDurationThreshold}, localTimeZone{localTimeZone}, openCloseTime{timeTuple}
+      m_MAX_PENDING_DURATION{pendingDurationThreshold}, localTimeZone{localTimeZone}, openCloseTime{timeTuple}, m_timers{PreProcessor::getLocalTime()}
 {
   int typesz = m_typeRank.size();
   m_laterProcessOrders.resize(typesz);
   m_lastFlushTime = PreProcessor::getLocalTime();
+  if (calendar == nullptr) // standalone: sessions of its own hours
+    calendar = std::make_shared<const SessionCalendar>(
+        openCloseTime, SessionCalendar::defaultHolidays(), m_lastFlushTime);
+  m_session = SessionCalendar::Cursor(std::move(calendar));
+
+  // fills of this side arrive as they happen
+  m_orderbookPtr->setFillListener(
+      (m_isBidPreprocessor ? Side::Side::Buy : Side::Side::Sell),
+      [this](const OrderTraded &fill)
+      { PreProcessor::ClearSeenOrdersWhenMatched(fill); });
 }
 
+PreProcessor::~PreProcessor()
+{
+  // book may outlive its preprocessors (shared_ptr handed out)
+  if (m_orderbookPtr != nullptr)
+    m_orderbookPtr->setFillListener(
+        (m_isBidPreprocessor ? Side::Side::Buy : Side::Side::Sell), nullptr);
+}
+
+// delegating: a temporary built in the body would leave this one empty
 PreProcessor::PreProcessor(OrderBookPointer &orderbookPtr, bool isBidPreProcessor, std::size_t pendingOrderThreshold,
                            std::chrono::milliseconds pendingDurationThreshold)
+    : PreProcessor(orderbookPtr, isBidPreProcessor,
+                   pendingOrderThreshold, pendingDurationThreshold, "Asia/Kolkata", TimeTuple{std::chrono::hours(3) + std::chrono::minutes(45), std::chrono::hours(10) + std::chrono::minutes(0)})
 {
-  PreProcessor(orderbookPtr, isBidPreProcessor,
-               pendingOrderThreshold, pendingDurationThreshold, "Asia/Kolkata", TimeTuple{std::chrono::hours(3) + std::chrono::minutes(45), std::chrono::hours(10) + std::chrono::minutes(0)});
 }
 
 PreProcessor::PreProcessor(OrderBookPointer &orderbookPtr, bool isBidPreprocessor, const std::string &localTimeZone, const TimeTuple &timeTuple)
+    : PreProcessor(orderbookPtr, isBidPreprocessor,
+                   static_cast<std::size_t>(3), static_cast<std::chrono::milliseconds>(100), localTimeZone, timeTuple)
 {
-  PreProcessor(orderbookPtr, isBidPreprocessor,
-               static_cast<std::size_t>(3), static_cast<std::chrono::milliseconds>(100), localTimeZone, timeTuple);
 }
 
 PreProcessor::PreProcessor(OrderBookPointer &orderbookPtr,
                            bool isBidPreprocessor)
+    : PreProcessor(orderbookPtr, isBidPreprocessor,
+                   static_cast<std::size_t>(3), static_cast<std::chrono::milliseconds>(100), "Asia/Kolkata", TimeTuple{std::chrono::hours(3) + std::chrono::minutes(45), std::chrono::hours(10) + std::chrono::minutes(0)})
 {
-  PreProcessor(orderbookPtr, isBidPreprocessor,
-               static_cast<std::size_t>(3), static_cast<std::chrono::milliseconds>(100), "Asia/Kolkata", TimeTuple{std::chrono::hours(3) + std::chrono::minutes(45), std::chrono::hours(10) + std::chrono::minutes(0)});
 }
 
 /*
@@ -128,8 +119,7 @@ Core functionality: Insert, Remove, Modify in PreProcessing
 void PreProcessor::InsertIntoPreprocessing(
     const OrderActionInfo &orderactinfo)
 {
-  int typeId = m_typeRank[orderactinfo.orderType];
-  m_laterProcessOrders[typeId].insert(orderactinfo); // add to specific multiset
+  PreProcessor::bufferAction(orderactinfo); // add to its type's queue
   m_encounteredOrders.insert(orderactinfo.orderID);
 
   m_processingOrderActInfo[orderactinfo.orderID] = orderactinfo;
@@ -181,15 +171,59 @@ void PreProcessor::InsertAddOrderIntoPreprocessing(
   m_orderComposition[currOrderId] = orderptr;
 
   OrderActionInfo orderactinfo = PreProcessor::OrderActionInfo(
-      currOrderId, orderptr->getOrderType(), Actions::Actions::Add);
+      currOrderId, orderptr->getOrderType(), Actions::Actions::Add,
+      orderptr->getSide(), orderptr->getPrice());
+
+  // GAT not active yet: waits on the wheel, not in the set every flush scans
+  if (orderptr->getOrderType() == OrderType::OrderType::GoodAfterTime &&
+      orderptr->getActivationTime() > getLocalTime())
+  {
+    m_encounteredOrders.insert(currOrderId);
+    m_processingOrderActInfo[currOrderId] = orderactinfo;
+    m_orderTimers[currOrderId] =
+        m_timers.schedule(orderptr->getActivationTime(), currOrderId,
+                          TimerWheel::TimerKind::Activate);
+    PreProcessor::lowerNextDue(orderptr->getActivationTime());
+    m_dormantOrders++;
+    PreProcessor::TryFlush();
+    return;
+  }
+  PreProcessor::scheduleExpiry(orderptr);
   PreProcessor::InsertIntoPreprocessing(orderactinfo);
 }
 
+void PreProcessor::scheduleExpiry(const OrderPointer &orderptr)
+{
+  OrderType::OrderType otype = orderptr->getOrderType();
+  if (otype != OrderType::OrderType::GoodForDay &&
+      otype != OrderType::OrderType::GoodTillDate)
+    return;
+  if (orderptr->getDeactivationTime() >= Constants::EndOfTime)
+    return; // EOT: never expires
+  m_orderTimers[orderptr->getOrderID()] =
+      m_timers.schedule(orderptr->getDeactivationTime(), orderptr->getOrderID(),
+                        TimerWheel::TimerKind::Expire);
+  PreProcessor::lowerNextDue(orderptr->getDeactivationTime());
+}
+
+void PreProcessor::cancelOrderTimer(const OrderID &orderID)
+{
+  auto it = m_orderTimers.find(orderID);
+  if (it == m_orderTimers.end())
+    return;
+  m_timers.cancel(it->second);
+  m_orderTimers.erase(it);
+}
+
 void PreProcessor::InsertCancelOrderIntoPreProcessing(
     const OrderID &orderID, const OrderType::OrderType orderType)
 {
+  // sorts with the order it cancels (gone already: nothing left to undo)
+  auto it = m_orderComposition.find(orderID);
+  Price price = (it != m_orderComposition.end()) ? it->second->getPrice() : 0;
   OrderActionInfo orderactinfo = PreProcessor::OrderActionInfo(
-      orderID, orderType, Actions::Actions::Cancel);
+      orderID, orderType, Actions::Actions::Cancel,
+      m_isBidPreprocessor ? Side::Side::Buy : Side::Side::Sell, price);
   PreProcessor::InsertIntoPreprocessing(orderactinfo);
 }
 
@@ -197,6 +231,11 @@ bool PreProcessor::hasOrderEnteredOrderbook(
     const OrderID &orderId, const OrderType::OrderType &orderType)
 {
 
+  // dormant GAT: still buffered, just not in its set yet
+  if (orderType == OrderType::OrderType::GoodAfterTime &&
+      m_orderTimers.contains(orderId))
+    return false;
+
   std::optional<OrderActionInfo> corrordactinfo = std::nullopt;
   if (m_processingOrderActInfo.contains(orderId))
     corrordactinfo = m_processingOrderActInfo.at(orderId);
@@ -209,7 +248,7 @@ bool PreProcessor::hasOrderEnteredOrderbook(
       m_processingOrderActInfo.contains(orderId))
   {
     if (corrordactinfo.has_value() &&
-        m_laterProcessOrders.at(typeId).contains(corrordactinfo.value()))
+        m_laterProcessOrders.at(typeId).contains(orderId))
       intoOrderBookAlready = false;
   }
   return intoOrderBookAlready;
@@ -226,6 +265,8 @@ void PreProcessor::RemoveFromPreprocessing(
 
   if (hasOrderEnteredOrderbook(orderId, orderType))
   {
+    // leaving the book anyway, its expiry has nothing left to do
+    PreProcessor::cancelOrderTimer(orderId);
     // if already into orderbook, preprocess reverse of the original request
     PreProcessor::InsertCancelOrderIntoPreProcessing(orderId, orderType);
     PreProcessor::TryFlush(); // flush to see if PreProcessor can clean up
@@ -233,6 +274,18 @@ void PreProcessor::RemoveFromPreprocessing(
   }
 
   // order still being processed
+  PreProcessor::DropBufferedOrder(orderId, orderType);
+  PreProcessor::TryFlush(); // flush to see if PreProcessor can clean up
+}
+
+// forget an order that never reached the book (no flush triggered)
+void PreProcessor::DropBufferedOrder(const OrderID &orderId,
+                                     const OrderType::OrderType &orderType)
+{
+  if (orderType == OrderType::OrderType::GoodAfterTime &&
+      m_orderTimers.contains(orderId))
+    m_dormantOrders--;
+  PreProcessor::cancelOrderTimer(orderId);
 
   if (m_orderComposition.contains(orderId))
   {
@@ -246,17 +299,8 @@ void PreProcessor::RemoveFromPreprocessing(
     m_processingOrderActInfo.erase(orderId); // orderactinfo
   }
 
-  int typeId = m_typeRank.at(orderType);
   if (ordactinfo.has_value())
-  {
-    auto it = m_laterProcessOrders.at(typeId).find(ordactinfo.value());
-    if (it != m_laterProcessOrders.at(typeId).end())
-    {
-      m_laterProcessOrders.at(typeId).erase(it); // just before exit
-    }
-  }
-
-  PreProcessor::TryFlush(); // flush to see if PreProcessor can clean up
+    PreProcessor::unbufferAction(orderId, orderType); // just before exit
 }
 
 void PreProcessor::ModifyInPreprocessing(const OrderID &oldID,
@@ -264,6 +308,33 @@ void PreProcessor::ModifyInPreprocessing(const OrderID &oldID,
 {
   // modify not shown explicitly since linear combination
 
+  // already resting & only shrinking at the same price: amend straight into
+  // the book (keeps queue priority, can't cross so no need to wait for flush)
+  // closed market: nothing reaches the book, queued like any other modify
+  if (PreProcessor::canTrade() &&
+      hasOrderEnteredOrderbook(oldID, orderptr->getOrderType()) &&
+      m_orderbookPtr->canAmendInPlace(oldID, *orderptr))
+  {
+    UpdateTimeAttributesAccToOrderType(orderptr);
+    m_orderbookPtr->ModifyOrder(oldID, *orderptr);
+
+    // bookkeeping (expiry included) follows the order to its new id
+    PreProcessor::cancelOrderTimer(oldID);
+    PreProcessor::scheduleExpiry(orderptr);
+    OrderID newID = orderptr->getOrderID();
+    m_orderComposition.erase(oldID);
+    m_orderComposition[newID] = orderptr;
+    if (m_processingOrderActInfo.contains(oldID))
+    {
+      m_processingOrderActInfo.erase(oldID);
+      m_processingOrderActInfo[newID] = OrderActionInfo(
+          newID, orderptr->getOrderType(), Actions::Actions::Add,
+          orderptr->getSide(), orderptr->getPrice());
+    }
+    m_encounteredOrders.insert(newID);
+    return;
+  }
+
   // symbol, orderType cannot be modified
   RemoveFromPreprocessing(oldID, orderptr->getOrderType());
   InsertAddOrderIntoPreprocessing(orderptr);
@@ -275,14 +346,28 @@ Flushing out, Queueing in Wait Queue, EmptyWaitQueue
 ////////////////////////////////////////////////
 */
 
-std::size_t PreProcessor::getBufferedOrderCount()
+std::size_t PreProcessor::getBufferedOrderCount() const
 {
-  std::size_t totalBufferedOrders = 0;
-  for (const auto &typeRankedOrders : m_laterProcessOrders)
-  {
-    totalBufferedOrders += typeRankedOrders.size();
-  }
-  return totalBufferedOrders;
+  return m_bufferedOrders + m_dormantOrders;
+}
+
+// every way into / out of the type queues (keeps the count in step)
+bool PreProcessor::bufferAction(const OrderActionInfo &orderactinfo)
+{
+  if (!m_laterProcessOrders[m_typeRank.at(orderactinfo.orderType)].insert(
+          orderactinfo))
+    return false;
+  m_bufferedOrders++;
+  return true;
+}
+
+bool PreProcessor::unbufferAction(const OrderID &orderID,
+                                  const OrderType::OrderType &orderType)
+{
+  if (!m_laterProcessOrders[m_typeRank.at(orderType)].erase(orderID))
+    return false;
+  m_bufferedOrders--;
+  return true;
 }
 
 unsigned long long int
@@ -295,6 +380,8 @@ printTimeStamp(const std::chrono::system_clock::time_point &tt)
 
 void PreProcessor::TryFlush()
 {
+  PreProcessor::AdvanceTimers(); // due activations join, expiries leave
+
   // qty buffered
   std::size_t totalBufferedOrders = getBufferedOrderCount();
 
@@ -305,8 +392,9 @@ void PreProcessor::TryFlush()
                                                             m_lastFlushTime);
 
   // hybrid flush model: qty or time interval (synchronous)
+  // scheduled: the interval is the scheduler's (fires on quiet symbols too)
   if (totalBufferedOrders >= m_MAX_PENDING_ORDERS_THRESHOLD ||
-      durationSinceLastFlush >= m_MAX_PENDING_DURATION)
+      (!m_scheduledFlush && durationSinceLastFlush >= m_MAX_PENDING_DURATION))
   {
     // std::cout << "FLUSH STARTED" << std::endl;
     QueueOrdersForInsertion();
@@ -315,6 +403,35 @@ void PreProcessor::TryFlush()
   }
 }
 
+void PreProcessor::FlushIfDue()
+{
+  PreProcessor::AdvanceTimers(); // due activations join, expiries leave
+
+  auto now = getLocalTime();
+  if (now - m_lastFlushTime >= m_MAX_PENDING_DURATION)
+  {
+    QueueOrdersForInsertion();
+    m_lastFlushTime = now;
+  }
+
+  // the earliest timer (or level change) of the wheel, not every tick
+  TimeStamp next =
+      std::min(m_lastFlushTime + m_MAX_PENDING_DURATION, m_timers.nextDue());
+  m_nextDue.store(next.time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+// a timer due before the scheduler would look next
+void PreProcessor::lowerNextDue(TimeStamp due)
+{
+  TimeStamp::rep ticks = due.time_since_epoch().count();
+  TimeStamp::rep current = m_nextDue.load(std::memory_order_relaxed);
+  while (ticks < current &&
+         !m_nextDue.compare_exchange_weak(current, ticks,
+                                          std::memory_order_relaxed))
+  {
+  }
+}
+
 void PreProcessor::QueueOrdersForInsertion()
 {
   auto now = getLocalTime();
@@ -338,53 +455,23 @@ void PreProcessor::QueueOrdersForInsertion()
 }
 
 void PreProcessor::EmptyTypeRankedOrders(
-    std::set<OrderActionInfo> &typeRankedOrders)
-{
-  if (typeRankedOrders.empty())
-    return;
-
-  std::set<PreProcessor::OrderActionInfo> copyOfTypeRankedOrders =
-      typeRankedOrders;
-
-  for (const PreProcessor::OrderActionInfo &orderactinfo :
-       copyOfTypeRankedOrders)
-  {
-    // cancel order can always be inserted into orderbook
-
-    // use of canInsertOrderIntoOrderbook has RemoveFromPreprocessing embedded
-    // on looping with typeRankedOrders can affect size of typeRankedOrders
-    // (decreases) -> cause of seg fault what causes:
-    // https://stackoverflow.com/a/3719031/19817062 (gdb) why caused:
-    // https://stackoverflow.com/a/3719076/19817062 (valgrind) valgrind
-    // --leak-check=full -s ./bin/orderbook (-s: show error list)
-    // https://docs.google.com/document/d/1OhOvXoePXU5l7TkWUzPs-1HU424P9buZekG7lluupq8/edit?usp=sharing
-
-    // if to be added but can't be matched no sense in putting to wait queue
-    if (orderactinfo.action == Actions::Actions::Add)
-    {
-      if (!PreProcessor::canInsertOrderIntoOrderbook(orderactinfo.orderID))
-        continue;
-    }
-    EmptyOrderIntoOrderbook(orderactinfo);
-    // std::cout << "---------------------------------------------------------"
-    //           << std::endl;
-    // std::cout << "observing " << orderactinfo.orderID << " "
-    //           << getType(orderactinfo.orderType) << " " <<
-    //           orderactinfo.action
-    //           << std::endl;
-    // std::cout << "---------------------------------------------------------"
-    //           << std::endl;
-  }
-  // for (int i = 0; i < (int)m_laterProcessOrders.size(); i++) {
-  //   std::cout << "QUEUE TYPE: " << getType(m_rankType[i]) << std::endl;
-  //   for (const auto &x : m_laterProcessOrders.at(i)) {
-  //     std::cout << "later process: " << x.orderID << " " <<
-  //     getType(x.orderType)
-  //               << " " << x.action << std::endl;
-  //   }
-  // }
-  // std::cout << "-------------------" << std::endl;
+    PendingQueue<OrderActionInfo> &typeRankedOrders)
+{
+  // one pass in priority order: canInsertOrderIntoOrderbook may drop the
+  // order (RemoveFromPreprocessing) & flush again, the queue only marks it
+  // dead & skips a nested drain of itself, so nothing is copied or revisited
+  typeRankedOrders.drain(
+      [this](const OrderActionInfo &orderactinfo)
+      {
+        // cancel order can always be inserted into orderbook
+        // if to be added but can't be matched no sense in putting to wait queue
+        if (orderactinfo.action == Actions::Actions::Add &&
+            !PreProcessor::canInsertOrderIntoOrderbook(orderactinfo.orderID))
+          return;
+        PreProcessor::EmptyOrderIntoOrderbook(orderactinfo);
+      });
 }
+
 void PreProcessor::EmptyOrderIntoOrderbook(const OrderActionInfo &ordactinfo)
 {
 
@@ -395,45 +482,88 @@ void PreProcessor::EmptyOrderIntoOrderbook(const OrderActionInfo &ordactinfo)
   }
 
 
-  auto &[orderID, type, action] = ordactinfo;
+  auto &[orderID, type, action, side, price] = ordactinfo;
   assert(action != Actions::Actions::Modify);
 
-  // forward to orderbook for relevant operation
+  // forward to orderbook for relevant operation (fills come back through
+  // the listeners of both sides while it matches)
   if (action == Actions::Actions::Add && m_orderComposition.count(orderID) > 0)
-    m_orderbookPtr->AddOrder(*m_orderComposition[orderID]);
+  {
+    OrderPointer orderptr = m_orderComposition[orderID]; // may clear on fill
+    m_orderbookPtr->AddOrder(*orderptr);
+  }
   else
     m_orderbookPtr->CancelOrder(orderID);
 
   // change status from to be processed later since added into orderbook
-  m_laterProcessOrders.at(m_typeRank[type]).erase(ordactinfo);
-
-  PreProcessor::ClearSeenOrdersWhenMatched();
+  PreProcessor::unbufferAction(orderID, type);
 }
 
-void PreProcessor::ClearSeenOrdersWhenMatched()
+void PreProcessor::ClearSeenOrdersWhenMatched(const OrderTraded &fill)
 {
+  // trade cannot happen on the basis of a cancel order hence it must be add
+  auto it = m_orderComposition.find(fill.orderID);
+  if (it == m_orderComposition.end())
+    return;
 
-  std::vector<Trade> trades = m_orderbookPtr->getTrades();
+  // book keeps its own record, the edge order learns of the fill here
+  OrderPointer orderptr = it->second;
+  orderptr->FillPartially(fill.quantityFilled);
+  if (orderptr->getRemainingQuantity() != 0)
+    return;
 
-  // iterate only on the latest trades (get appended)
-  for (auto it = trades.rbegin(); it != trades.rend(); it++)
+  m_processingOrderActInfo.erase(fill.orderID);
+  m_orderComposition.erase(it);
+  PreProcessor::cancelOrderTimer(fill.orderID); // filled before expiry
+}
+
+void PreProcessor::AdvanceTimers()
+{
+  // only the due timers come out (no walk over buffered or resting orders)
+  m_dueTimers.clear();
+  m_timers.advance(getLocalTime(), m_dueTimers);
+  for (const TimerWheel::Timer &timer : m_dueTimers)
   {
-    const auto &trade = *it;
-    OrderID bidId = trade.getMatchedBid().orderID;
-    OrderID askId = trade.getMatchedAsk().orderID;
-    OrderID orderId = ((m_isBidPreprocessor == true) ? bidId : askId);
+    m_orderTimers.erase(timer.orderID);
+    if (timer.kind == TimerWheel::TimerKind::Activate)
+      PreProcessor::ActivateOrder(timer.orderID);
+    else
+      PreProcessor::ExpireOrder(timer.orderID);
+  }
+}
 
-    // trade cannot happen on the basis of a cancel order hence it must be
-    // add stop once an trade has been encountered and cleared previously
+// GAT reached its activation time: joins its set, picked up by next flush
+void PreProcessor::ActivateOrder(const OrderID &orderID)
+{
+  m_dormantOrders--;
+  if (m_processingOrderActInfo.count(orderID) == 0)
+    return;
+  const OrderActionInfo &orderactinfo = m_processingOrderActInfo.at(orderID);
+  PreProcessor::bufferAction(orderactinfo);
+}
 
-    if (m_orderComposition.count(orderId) > 0 &&
-        m_orderComposition[orderId]->getRemainingQuantity() == 0)
-    {
-      if (m_processingOrderActInfo.count(orderId) > 0)
-        m_processingOrderActInfo.erase(orderId);
-      m_orderComposition.erase(orderId);
-    }
+// GFD/GTD reached its deactivation time, wherever it currently is
+void PreProcessor::ExpireOrder(const OrderID &orderID)
+{
+  if (m_orderComposition.count(orderID) == 0)
+    return; // filled or cancelled meanwhile
+  OrderPointer orderptr = m_orderComposition.at(orderID);
+  OrderType::OrderType otype = orderptr->getOrderType();
+
+  if (!hasOrderEnteredOrderbook(orderID, otype))
+  {
+    PreProcessor::DropBufferedOrder(orderID, otype);
   }
+  else
+  {
+    // resting: pulled straight from the book (market may be shut by now,
+    // a queued cancel would wait for the next session)
+    if (m_orderbookPtr->isResting(orderID))
+      m_orderbookPtr->CancelOrder(orderID);
+    m_orderComposition.erase(orderID);
+    m_processingOrderActInfo.erase(orderID);
+  }
+  orderptr->setOrderStatus(OrderStatus::OrderStatus::Cancelled);
 }
 
 /*
@@ -445,33 +575,10 @@ Flushing etc UTILITIES
 Quantity qtyAvailableForMatch(const OrderPointer &orderptr,
                               const OrderBook &orderbook)
 {
-  Price price = orderptr->getPrice();
-  Side::Side side = orderptr->getSide();
-
-  Quantity qtyAvailable = 0;
-  if (side == Side::Side::Buy)
-  {
-    // For BUY orders: match against ASK levels (ask_price <= bid_price)
-    const auto &levels = orderbook.getAskLevels();
-    for (const auto &[ask_price, level] : levels)
-    {
-      if (ask_price > price)
-        break; // Stop if ask price exceeds bid price
-      qtyAvailable += level->getQuantity();
-    }
-  }
-  else
-  {
-    // For SELL orders: match against BID levels (bid_price >= ask_price)
-    const auto &levels = orderbook.getBidLevels();
-    for (const auto &[bid_price, level] : levels)
-    {
-      if (bid_price < price)
-        break; // Stop if bid price below ask price
-      qtyAvailable += level->getQuantity();
-    }
-  }
-  return qtyAvailable;
+  // BUY: asks at or below its price, SELL: bids at or above (book's
+  // cumulative depth, no walk over the levels)
+  return orderbook.getMatchableQuantity(orderptr->getSide(),
+                                        orderptr->getPrice());
 }
 
 bool PreProcessor::canInsertOrderIntoOrderbook(const OrderID &orderID)
@@ -534,87 +641,23 @@ bool PreProcessor::canInsertOrderIntoOrderbook(const OrderID &orderID)
   return false; // don't add prevents wrong matching atleast
 }
 
-// check if the market is open currently (between 9:15 to 15:30)
+// check if the market is open currently (a session of the calendar: no
+// weekend, no holiday, between its open & close)
 bool PreProcessor::canTrade()
 {
-  using namespace std::chrono;
-  auto now = PreProcessor::getLocalTime();
-
-  // Check if weekend
-  auto today = floor<days>(now);
-  weekday dow{today};
-  if (dow == Saturday || dow == Sunday)
-  {
-    return false;
-  }
-
-  // Check if holiday
-  if (isHoliday(now))
-  {
-    return false;
-  }
-
-  auto tod = now - today;
-  auto market_open = std::get<0>(openCloseTime);
-  auto market_close = std::get<1>(openCloseTime);
-
-  return tod >= market_open && tod < market_close;
-}
-
-bool PreProcessor::isHoliday(const TimeStamp &time)
-{
-  using namespace std::chrono;
-  auto dp = floor<days>(time);
-  year_month_day ymd{dp};
-
-  for (const auto &[d, m, y] : m_holidays)
-  {
-    if (ymd.day() == day{d} && ymd.month() == month{m} &&
-        ymd.year() == year{y})
-    {
-      return true;
-    }
-  }
-  return false;
+  return m_session.isOpen(PreProcessor::getLocalTime());
 }
 
+// next open/close at or after now (cached session boundaries)
 TimeStamp PreProcessor::getNextMarketTime(bool isOpen)
 {
-  using namespace std::chrono;
-
-  auto market_open = std::get<0>(openCloseTime);
-  auto market_close = std::get<1>(openCloseTime);
-
   TimeStamp now = PreProcessor::getLocalTime();
+  return isOpen ? m_session.nextOpen(now) : m_session.nextClose(now);
+}
 
-  // obtain the date and set time at midnight
-  TimeStamp today = floor<days>(now);
-  // obtain our first guess
-  auto target_time = today + (isOpen ? market_open : market_close);
-
-  // TODO: seems to be fucked up
-  // Adjust for weekends
-  // auto dow = weekday(target_time); type-casting error
-  auto sys_days = floor<days>(target_time); // First convert to days precision
-  weekday dow{sys_days};                    // Then construct weekday from days
-  if (dow == Saturday)
-    target_time += days(2);
-  else if (dow == Sunday)
-    target_time += days(1);
-
-  // If time already passed today, move to next weekday
-  if (target_time < now)
-  {
-    target_time += days(1);
-    auto sys_days = floor<days>(target_time); // First convert to days precision
-    weekday dow{sys_days};                    // Then construct weekday from days
-    if (dow == Saturday)
-      target_time += days(2);
-    else if (dow == Sunday)
-      target_time += days(1);
-  }
-
-  return target_time;
+void PreProcessor::setCalendar(SessionCalendarPointer calendar)
+{
+  m_session = SessionCalendar::Cursor(std::move(calendar));
 }
 
 std::size_t PreProcessor::getNumberOfOrderTypes() { return m_typeRank.size(); }
@@ -685,25 +728,20 @@ void PreProcessor::printPreProcessorStatus()
   // why does std::views::enumerate fail? no member views in std
   for (std::size_t idx = 0; idx < m_laterProcessOrders.size(); idx++)
   {
-    auto ms = m_laterProcessOrders[idx];
+    const auto &ms = m_laterProcessOrders[idx];
     std::cout << "type: " << getType(m_rankType[idx]) << " size: " << ms.size()
               << std::endl;
     std::cout << "ORDERS: " << std::endl;
-    for (auto &info : ms)
+    ms.forEach([](const OrderActionInfo &info)
     {
-
-      OrderID orderID = info.orderID;
       Actions::Actions action = info.action;
       std::cout << "action: "
                 << ((action == Actions::Actions::Add)
                         ? "ADD"
                         : ((action == Actions::Actions::Cancel) ? "CANCEL"
                                                                 : "MODIFY"))
-                << " price: "
-                << PreProcessor::OrderActionInfo::decodePriceFromOrderID(
-                       orderID)
-                << std::endl;
-    }
+                << " price: " << info.price << std::endl;
+    });
   }
 }
 /*
@@ -0,0 +1,125 @@
+#include "include/SessionCalendar.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+SessionCalendar::SessionCalendar(const TimeTuple &hours,
+                                 std::vector<Holiday> holidays, TimeStamp from,
+                                 std::size_t sessions)
+    : m_hours{hours}, m_start{std::chrono::floor<std::chrono::days>(from)},
+      m_holidays{std::move(holidays)}
+{
+  std::sort(m_holidays.begin(), m_holidays.end());
+  m_holidays.erase(std::unique(m_holidays.begin(), m_holidays.end()),
+                   m_holidays.end());
+
+  // day math done here once, readers only compare instants
+  m_sessions.reserve(sessions);
+  std::chrono::sys_days day = m_start - std::chrono::days(1);
+  for (std::size_t idx = 0; idx < sessions; idx++)
+  {
+    m_sessions.push_back(SessionCalendar::sessionAfter(day));
+    day = std::chrono::floor<std::chrono::days>(m_sessions.back().open);
+  }
+}
+
+SessionCalendar::Session SessionCalendar::first() const
+{
+  if (!m_sessions.empty())
+    return m_sessions.front();
+  return SessionCalendar::sessionAfter(m_start - std::chrono::days(1));
+}
+
+SessionCalendar::Session
+SessionCalendar::following(std::size_t index, const Session &session) const
+{
+  if (index + 1 < m_sessions.size())
+    return m_sessions[index + 1];
+  return SessionCalendar::sessionAfter(
+      std::chrono::floor<std::chrono::days>(session.open));
+}
+
+SessionCalendar::Session
+SessionCalendar::sessionAfter(std::chrono::sys_days day) const
+{
+  using namespace std::chrono;
+  while (true)
+  {
+    day += days(1);
+    weekday dow{day};
+    if (dow == Saturday || dow == Sunday)
+      continue;
+    if (SessionCalendar::isHoliday(year_month_day{day}))
+      continue;
+    return Session{day + std::get<0>(m_hours), day + std::get<1>(m_hours)};
+  }
+}
+
+bool SessionCalendar::isHoliday(Holiday day) const
+{
+  return std::binary_search(m_holidays.begin(), m_holidays.end(), day);
+}
+
+std::vector<SessionCalendar::Holiday>
+SessionCalendar::loadHolidays(const std::string &path)
+{
+  std::ifstream file(path);
+  if (!file)
+    throw std::runtime_error("holiday file could NOT be opened: " + path);
+
+  std::vector<Holiday> holidays;
+  std::string line;
+  while (std::getline(file, line))
+  {
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    int year = 0;
+    unsigned month = 0, day = 0;
+    char dash1 = 0, dash2 = 0;
+    if (!(fields >> year))
+    {
+      if (fields.eof()) // blank or comment only
+        continue;
+      throw std::runtime_error("holiday file line is not a date: " + line);
+    }
+    Holiday date{};
+    if (fields >> dash1 >> month >> dash2 >> day && dash1 == '-' &&
+        dash2 == '-')
+      date = Holiday{std::chrono::year{year}, std::chrono::month{month},
+                     std::chrono::day{day}};
+    if (!date.ok())
+      throw std::runtime_error("holiday file line is not a date: " + line);
+    holidays.push_back(date);
+  }
+  return holidays;
+}
+
+std::vector<SessionCalendar::Holiday> SessionCalendar::defaultHolidays()
+{
+  using namespace std::chrono;
+  // maa's idea to also check for public holidays
+  return {
+      2025y / January / 26,  // Republic Day
+      2025y / March / 14,    // Holi
+      2025y / March / 31,    // Idul Fitr
+      2025y / April / 6,     // Ram Navami
+      2025y / April / 18,    // Good Friday
+      2025y / May / 12,      // Buddha Purnima
+      2025y / June / 7,      // Bakrid
+      2025y / July / 6,      // Muharram
+      2025y / August / 15,   // Independence Day
+      2025y / August / 16,   // Janmashtami
+      2025y / October / 2,   // Gandhi Jayanti, Vijaya Dashami
+      2025y / October / 21,  // Diwali
+      2025y / November / 5,  // Guru Nanak Jayanti
+      2025y / December / 25, // Christmas
+  };
+}
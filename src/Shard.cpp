@@ -0,0 +1,91 @@
+#include "include/Shard.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+// empty polls before the worker yields its core
+constexpr std::size_t SpinsBeforeYield = 256;
+
+void pinToCore(std::thread &thread, std::size_t index)
+{
+#if defined(__linux__)
+  unsigned cores = std::thread::hardware_concurrency();
+  if (cores == 0)
+    return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(index % cores, &set);
+  // best effort: an unpinned shard still works, only less predictably
+  pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+  (void)thread;
+  (void)index;
+#endif
+}
+} // namespace
+
+Shard::Shard(std::size_t index, std::size_t capacity, Handler handler)
+    : m_index{index}, m_ring{capacity}, m_handler{std::move(handler)}
+{
+  m_thread = std::thread([this]
+                         { Shard::run(); });
+  pinToCore(m_thread, index);
+}
+
+Shard::~Shard() { Shard::stop(); }
+
+void Shard::submit(OrderRequest &&request)
+{
+  // full ring: back pressure on the producer, the worker catches up
+  while (!m_ring.tryPush(std::move(request)))
+    std::this_thread::yield();
+  m_submitted++;
+}
+
+void Shard::drain() const
+{
+  while (m_executed.load(std::memory_order_acquire) != m_submitted)
+    std::this_thread::yield();
+}
+
+void Shard::stop()
+{
+  if (!m_thread.joinable())
+    return;
+  Shard::drain();
+  m_running.store(false, std::memory_order_release);
+  m_thread.join();
+}
+
+void Shard::run()
+{
+  OrderRequest request;
+  std::size_t idle = 0;
+  while (true)
+  {
+    if (m_ring.tryPop(request))
+    {
+      m_handler(request);
+      m_executed.fetch_add(1, std::memory_order_release);
+      idle = 0;
+      continue;
+    }
+    // stop only comes after a drain, so nothing is left behind
+    if (!m_running.load(std::memory_order_acquire))
+      break;
+    if (++idle >= SpinsBeforeYield)
+    {
+      std::this_thread::yield();
+      idle = 0;
+    }
+  }
+}
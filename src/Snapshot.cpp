@@ -0,0 +1,639 @@
+#include "include/Snapshot.hpp"
+#include "include/Clock.hpp"
+#include "include/Journal.hpp"
+#include "include/Level.hpp"
+#include "include/Order.hpp"
+#include "include/OrderBook.hpp"
+#include "include/OrderRecord.hpp"
+#include "include/Participant.hpp"
+#include "include/Preprocess.hpp"
+#include "include/SymbolInfo.hpp"
+#include "include/TimerWheel.hpp"
+#include "include/Trade.hpp"
+#include "include/Xchange.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/alias/OrderRel.hpp"
+#include "utils/enums/Actions.hpp"
+#include "utils/enums/OrderStatus.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr char Magic[8] = {'X', 'C', 'H', 'S', 'N', 'A', 'P', '\0'};
+constexpr std::size_t Alignment = 64;
+
+enum Section : std::uint32_t
+{
+  Strings,           // char blob
+  SymbolNames,       // StringRef per symbol handle
+  ParticipantNames,  // StringRef per participant handle
+  Participants,      // ParticipantRecord
+  Portfolios,        // PortfolioRecord
+  ParticipantOrders, // OrderSnap
+  ParticipantTrades, // Trade
+  Symbols,           // SymbolRecord
+  PreProcessors,     // PreProcessorRecord (bid, ask per symbol)
+  PreOrders,         // OrderSnap
+  PreActions,        // ActionRecord
+  PreEncountered,    // OrderID
+  BookOrders,        // OrderRecord (bids best first, then asks, FIFO)
+  BookTrades,        // Trade (each book's log in sequence order)
+  SectionCount
+};
+
+struct SectionEntry
+{
+  std::uint64_t offset;
+  std::uint64_t count;
+};
+
+struct FileHeader
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t sectionCount;
+  std::uint64_t fileBytes;
+  JournalSequence sequence;
+  std::int64_t takenAt;
+  OrderID nextOrderID; // ids handed out after restore start here
+  SectionEntry sections[SectionCount];
+};
+
+struct StringRef
+{
+  std::uint64_t offset;
+  std::uint32_t length;
+  std::uint32_t reserved;
+};
+
+// a run of records in some section (first index, count)
+struct Run
+{
+  std::uint64_t first;
+  std::uint64_t count;
+};
+
+struct ParticipantRecord
+{
+  ParticipantHandle handle;
+  std::uint32_t reserved;
+  StringRef govID;
+  StringRef timeZone;
+  Run portfolio;
+  Run orders;
+  Run trades;
+};
+
+struct PortfolioRecord
+{
+  StringRef symbol;
+  Amount amount;
+};
+
+struct OrderSnap
+{
+  OrderID orderID;
+  Quantity remQuantity;
+  std::int64_t orderTime;
+  std::int64_t activateTime;
+  std::int64_t deactivateTime;
+  Price price;
+  SymbolHandle symbol;
+  ParticipantHandle participant;
+  std::uint8_t orderType;
+  std::uint8_t side;
+  std::uint8_t orderStatus;
+  std::uint8_t action; // participant's view (add/modify)
+};
+
+struct SymbolRecord
+{
+  SymbolHandle handle;
+  std::uint32_t reserved;
+  Run book;
+  Run trades;
+  std::uint64_t preprocessors[2]; // bid, ask
+};
+
+struct PreProcessorRecord
+{
+  std::int64_t lastFlushTime;
+  Run orders;
+  Run actions;
+  Run encountered;
+};
+
+// entry of the action map and/or of a type ranked set
+enum ActionState : std::uint8_t
+{
+  InMap = 1 << 0,
+  InSet = 1 << 1,
+  Dormant = 1 << 2 // GAT waiting on its activation timer
+};
+
+struct ActionRecord
+{
+  OrderID orderID;
+  Price price;
+  std::uint8_t orderType;
+  std::uint8_t action;
+  std::uint8_t state;
+  std::uint8_t side;
+};
+
+static_assert(std::is_trivially_copyable_v<OrderRecord>);
+static_assert(std::is_trivially_copyable_v<Trade>);
+
+std::int64_t ticks(TimeStamp time) { return time.time_since_epoch().count(); }
+TimeStamp stamp(std::int64_t ticks) { return TimeStamp{TimeStamp::duration{ticks}}; }
+
+std::size_t alignUp(std::size_t bytes)
+{
+  return (bytes + Alignment - 1) / Alignment * Alignment;
+}
+
+// sections accumulated in memory, then laid out & written in one pass
+struct Builder
+{
+  std::vector<char> strings;
+  std::vector<StringRef> symbolNames, participantNames;
+  std::vector<ParticipantRecord> participants;
+  std::vector<PortfolioRecord> portfolios;
+  std::vector<OrderSnap> participantOrders;
+  std::vector<Trade> participantTrades;
+  std::vector<SymbolRecord> symbols;
+  std::vector<PreProcessorRecord> preprocessors;
+  std::vector<OrderSnap> preOrders;
+  std::vector<ActionRecord> preActions;
+  std::vector<OrderID> preEncountered;
+  std::vector<OrderRecord> bookOrders;
+  std::vector<Trade> bookTrades;
+
+  StringRef addString(const std::string &text)
+  {
+    StringRef ref{strings.size(), static_cast<std::uint32_t>(text.size()), 0};
+    strings.insert(strings.end(), text.begin(), text.end());
+    return ref;
+  }
+};
+
+OrderSnap snapOrder(const Order &order, SymbolHandle symbol,
+                    Actions::Actions action)
+{
+  OrderSnap snap{};
+  snap.orderID = order.getOrderID();
+  snap.remQuantity = order.getRemainingQuantity();
+  snap.orderTime = ticks(order.getOrderTime());
+  snap.activateTime = ticks(order.getActivationTime());
+  snap.deactivateTime = ticks(order.getDeactivationTime());
+  snap.price = order.getPrice();
+  snap.symbol = symbol;
+  snap.participant = order.getParticipantHandle();
+  snap.orderType = static_cast<std::uint8_t>(order.getOrderType());
+  snap.side = static_cast<std::uint8_t>(order.getSide());
+  snap.orderStatus = static_cast<std::uint8_t>(order.getOrderStatus());
+  snap.action = static_cast<std::uint8_t>(action);
+  return snap;
+}
+
+// read only mapping of the whole file, sections viewed in place
+class Mapping
+{
+public:
+  explicit Mapping(const std::string &path)
+  {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      throw std::runtime_error("snapshot could NOT be opened: " + path);
+    struct stat info;
+    if (::fstat(fd, &info) != 0 ||
+        static_cast<std::size_t>(info.st_size) < sizeof(FileHeader))
+    {
+      ::close(fd);
+      throw std::runtime_error("snapshot is truncated: " + path);
+    }
+    m_size = static_cast<std::size_t>(info.st_size);
+    void *data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+      throw std::runtime_error("snapshot could NOT be mapped: " + path);
+    m_data = static_cast<const char *>(data);
+    ::madvise(data, m_size, MADV_SEQUENTIAL);
+  }
+  Mapping(const Mapping &) = delete;
+  Mapping &operator=(const Mapping &) = delete;
+  ~Mapping() { ::munmap(const_cast<char *>(m_data), m_size); }
+
+  const FileHeader &header() const
+  {
+    return *reinterpret_cast<const FileHeader *>(m_data);
+  }
+  template <typename Record> std::span<const Record> view(Section section) const
+  {
+    const SectionEntry &entry = header().sections[section];
+    if (entry.offset % alignof(Record) != 0 ||
+        entry.offset + entry.count * sizeof(Record) > m_size)
+      throw std::runtime_error("snapshot section out of bounds");
+    return {reinterpret_cast<const Record *>(m_data + entry.offset),
+            static_cast<std::size_t>(entry.count)};
+  }
+  std::string string(const StringRef &ref) const
+  {
+    std::span<const char> blob = view<char>(Strings);
+    if (ref.offset + ref.length > blob.size())
+      throw std::runtime_error("snapshot string out of bounds");
+    return std::string(blob.data() + ref.offset, ref.length);
+  }
+  std::size_t size() const { return m_size; }
+
+private:
+  const char *m_data{nullptr};
+  std::size_t m_size{0};
+};
+} // namespace
+
+void Snapshot::write(const Xchange &xchange, const std::string &path,
+                     JournalSequence sequence)
+{
+  Builder out;
+  const InternTable &symbolNames = *xchange.m_symbolNames;
+  const InternTable &participantNames = *xchange.m_participantNames;
+  for (std::size_t handle = 0; handle < symbolNames.size(); handle++)
+    out.symbolNames.push_back(
+        out.addString(symbolNames.name(static_cast<InternHandle>(handle))));
+  for (std::size_t handle = 0; handle < participantNames.size(); handle++)
+    out.participantNames.push_back(out.addString(
+        participantNames.name(static_cast<InternHandle>(handle))));
+
+  for (const auto &[govID, participantID] : xchange.govID_partIDMap)
+  {
+    ParticipantHandle handle = xchange.findParticipant(participantID);
+    if (handle == InvalidHandle)
+      continue;
+    const Participant &participant = *xchange.m_participants[handle];
+    ParticipantRecord record{};
+    record.handle = handle;
+    record.govID = out.addString(govID);
+    record.timeZone = out.addString(participant.localTimeZone);
+
+    record.portfolio.first = out.portfolios.size();
+    for (const auto &[symbol, amount] : participant.m_portfolio)
+      out.portfolios.push_back(PortfolioRecord{out.addString(symbol), amount});
+    record.portfolio.count = out.portfolios.size() - record.portfolio.first;
+
+    record.orders.first = out.participantOrders.size();
+    for (const auto &[orderID, info] : participant.m_placedOrders)
+    {
+      auto order = participant.m_orderComposition.find(orderID);
+      if (order == participant.m_orderComposition.end())
+        continue;
+      out.participantOrders.push_back(snapOrder(
+          *order->second, symbolNames.find(info.symbol), info.action));
+    }
+    record.orders.count = out.participantOrders.size() - record.orders.first;
+
+    record.trades.first = out.participantTrades.size();
+    out.participantTrades.insert(out.participantTrades.end(),
+                                 participant.m_historyOfTrades.begin(),
+                                 participant.m_historyOfTrades.end());
+    record.trades.count = out.participantTrades.size() - record.trades.first;
+    out.participants.push_back(record);
+  }
+
+  for (const SymbolInfoPointer &symbolInfo : xchange.m_symbolInfos)
+  {
+    if (symbolInfo == nullptr)
+      continue;
+    const OrderBook &book = *symbolInfo->m_orderbook;
+    SymbolRecord record{};
+    record.handle = book.getSymbolHandle();
+
+    record.book.first = out.bookOrders.size();
+    for (const auto &[price, level] : book.getBidLevels())
+      for (const OrderRecord &resting : *level)
+        out.bookOrders.push_back(resting);
+    for (const auto &[price, level] : book.getAskLevels())
+      for (const OrderRecord &resting : *level)
+        out.bookOrders.push_back(resting);
+    record.book.count = out.bookOrders.size() - record.book.first;
+
+    // spilled part read back in one go, sequences restart at 0 on load
+    const TradeLog &trades = book.getTrades();
+    record.trades.first = out.bookTrades.size();
+    record.trades.count = trades.size();
+    out.bookTrades.resize(out.bookTrades.size() + trades.size());
+    trades.read(0, std::span<Trade>{out.bookTrades}.subspan(record.trades.first));
+
+    const PreProcessorPointer sides[2] = {symbolInfo->m_bidprepro,
+                                          symbolInfo->m_askprepro};
+    for (std::size_t side = 0; side < 2; side++)
+    {
+      const PreProcessor &pre = *sides[side];
+      PreProcessorRecord preRecord{};
+      preRecord.lastFlushTime = ticks(pre.m_lastFlushTime);
+
+      preRecord.orders.first = out.preOrders.size();
+      for (const auto &[orderID, order] : pre.m_orderComposition)
+        out.preOrders.push_back(
+            snapOrder(*order, record.handle, Actions::Actions::Add));
+      preRecord.orders.count = out.preOrders.size() - preRecord.orders.first;
+
+      preRecord.actions.first = out.preActions.size();
+      for (const auto &[orderID, info] : pre.m_processingOrderActInfo)
+      {
+        ActionRecord action{};
+        action.orderID = orderID;
+        action.orderType = static_cast<std::uint8_t>(info.orderType);
+        action.action = static_cast<std::uint8_t>(info.action);
+        action.side = static_cast<std::uint8_t>(info.side);
+        action.price = info.price;
+        action.state = InMap;
+        if (info.orderType == OrderType::OrderType::GoodAfterTime &&
+            pre.m_orderTimers.contains(orderID) &&
+            !pre.m_laterProcessOrders[PreProcessor::m_typeRank.at(info.orderType)]
+                 .contains(orderID))
+          action.state |= Dormant;
+        out.preActions.push_back(action);
+      }
+      for (const auto &typeRankedOrders : pre.m_laterProcessOrders)
+      {
+        typeRankedOrders.forEach(
+            [&out](const PreProcessor::OrderActionInfo &info)
+            {
+              ActionRecord action{};
+              action.orderID = info.orderID;
+              action.orderType = static_cast<std::uint8_t>(info.orderType);
+              action.action = static_cast<std::uint8_t>(info.action);
+              action.side = static_cast<std::uint8_t>(info.side);
+              action.price = info.price;
+              action.state = InSet;
+              out.preActions.push_back(action);
+            });
+      }
+      preRecord.actions.count = out.preActions.size() - preRecord.actions.first;
+
+      preRecord.encountered.first = out.preEncountered.size();
+      out.preEncountered.insert(out.preEncountered.end(),
+                                pre.m_encounteredOrders.begin(),
+                                pre.m_encounteredOrders.end());
+      preRecord.encountered.count =
+          out.preEncountered.size() - preRecord.encountered.first;
+
+      record.preprocessors[side] = out.preprocessors.size();
+      out.preprocessors.push_back(preRecord);
+    }
+    out.symbols.push_back(record);
+  }
+
+  // layout: header, then every section on its own 64 byte boundary
+  FileHeader header{};
+  std::memcpy(header.magic, Magic, sizeof(Magic));
+  header.version = Snapshot::Version;
+  header.sectionCount = SectionCount;
+  header.sequence = sequence;
+  header.takenAt = ticks(Clock::now());
+  header.nextOrderID = Order::getIdGenerator().peek();
+
+  struct Chunk
+  {
+    const void *data;
+    std::size_t bytes;
+  };
+  std::vector<Chunk> chunks(SectionCount);
+  auto place = [&](Section section, const auto &records)
+  {
+    using Record = typename std::decay_t<decltype(records)>::value_type;
+    header.sections[section].count = records.size();
+    chunks[section] = Chunk{records.data(), records.size() * sizeof(Record)};
+  };
+  place(Strings, out.strings);
+  place(SymbolNames, out.symbolNames);
+  place(ParticipantNames, out.participantNames);
+  place(Participants, out.participants);
+  place(Portfolios, out.portfolios);
+  place(ParticipantOrders, out.participantOrders);
+  place(ParticipantTrades, out.participantTrades);
+  place(Symbols, out.symbols);
+  place(PreProcessors, out.preprocessors);
+  place(PreOrders, out.preOrders);
+  place(PreActions, out.preActions);
+  place(PreEncountered, out.preEncountered);
+  place(BookOrders, out.bookOrders);
+  place(BookTrades, out.bookTrades);
+
+  std::size_t offset = alignUp(sizeof(FileHeader));
+  for (std::size_t section = 0; section < SectionCount; section++)
+  {
+    header.sections[section].offset = offset;
+    offset = alignUp(offset + chunks[section].bytes);
+  }
+  header.fileBytes = offset;
+
+  const std::string staging = path + ".tmp";
+  std::FILE *file = std::fopen(staging.c_str(), "wb");
+  if (file == nullptr)
+    throw std::runtime_error("snapshot could NOT be written: " + staging);
+  static const char zeros[Alignment] = {};
+  bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+  std::size_t written = sizeof(header);
+  for (std::size_t section = 0; ok && section < SectionCount; section++)
+  {
+    std::size_t padding = header.sections[section].offset - written;
+    ok = std::fwrite(zeros, 1, padding, file) == padding &&
+         std::fwrite(chunks[section].data, 1, chunks[section].bytes, file) ==
+             chunks[section].bytes;
+    written += padding + chunks[section].bytes;
+  }
+  std::size_t tail = header.fileBytes - written;
+  ok = ok && std::fwrite(zeros, 1, tail, file) == tail;
+  ok = (std::fflush(file) == 0) && ok && (::fsync(::fileno(file)) == 0);
+  ok = (std::fclose(file) == 0) && ok;
+  if (!ok || std::rename(staging.c_str(), path.c_str()) != 0)
+  {
+    std::remove(staging.c_str());
+    throw std::runtime_error("snapshot could NOT be written: " + path);
+  }
+}
+
+JournalSequence Snapshot::load(Xchange &xchange, const std::string &path)
+{
+  Mapping file(path);
+  const FileHeader &header = file.header();
+  if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+    throw std::runtime_error("not a snapshot: " + path);
+  if (header.version != Snapshot::Version ||
+      header.sectionCount != SectionCount)
+    throw std::runtime_error("snapshot version " +
+                             std::to_string(header.version) +
+                             " not supported: " + path);
+  if (header.fileBytes != file.size())
+    throw std::runtime_error("snapshot is truncated: " + path);
+
+  // no id of the saved state is handed out again
+  Order::getIdGenerator().advanceTo(header.nextOrderID);
+
+  // same names in the same order: every handle in the file stays valid
+  for (const StringRef &name : file.view<StringRef>(SymbolNames))
+    xchange.m_symbolNames->intern(file.string(name));
+  for (const StringRef &name : file.view<StringRef>(ParticipantNames))
+    xchange.m_participantNames->intern(file.string(name));
+  const InternTable &symbolNames = *xchange.m_symbolNames;
+  const InternTable &participantNames = *xchange.m_participantNames;
+
+  // order as saved (names are short: the string copies stay inline)
+  auto restored = [&](const OrderSnap &snap)
+  {
+    return Order(
+        symbolNames.name(snap.symbol),
+        static_cast<OrderType::OrderType>(snap.orderType),
+        static_cast<Side::Side>(snap.side), snap.price, snap.remQuantity,
+        participantNames.name(snap.participant), snap.participant,
+        stamp(snap.orderTime), snap.orderID, stamp(snap.activateTime),
+        stamp(snap.deactivateTime),
+        static_cast<OrderStatus::OrderStatus>(snap.orderStatus));
+  };
+
+  std::span<const PortfolioRecord> portfolios =
+      file.view<PortfolioRecord>(Portfolios);
+  std::span<const OrderSnap> participantOrders =
+      file.view<OrderSnap>(ParticipantOrders);
+  std::span<const Trade> participantTrades = file.view<Trade>(ParticipantTrades);
+  xchange.m_participants.resize(participantNames.size());
+  for (const ParticipantRecord &record : file.view<ParticipantRecord>(Participants))
+  {
+    auto participant =
+        std::make_shared<Participant>(file.string(record.timeZone));
+    participant->m_participantID = participantNames.name(record.handle);
+    participant->m_participantHandle = record.handle;
+    participant->m_symbolNames = xchange.m_symbolNames;
+
+    for (const PortfolioRecord &holding :
+         portfolios.subspan(record.portfolio.first, record.portfolio.count))
+      participant->m_portfolio[file.string(holding.symbol)] = holding.amount;
+
+    participant->m_placedOrders.reserve(record.orders.count);
+    participant->m_orderComposition.reserve(record.orders.count);
+    // one allocation for all its orders: each OrderPointer aliases its
+    // slot & keeps the block alive (freed once the last order is dropped)
+    auto block = std::make_shared<std::vector<Order>>();
+    block->reserve(record.orders.count); // never reallocates below
+    for (const OrderSnap &snap :
+         participantOrders.subspan(record.orders.first, record.orders.count))
+    {
+      participant->m_placedOrders[snap.orderID] =
+          Participant::ParticipantOrderInfo(
+              snap.orderID, static_cast<Actions::Actions>(snap.action),
+              symbolNames.name(snap.symbol),
+              static_cast<OrderType::OrderType>(snap.orderType),
+              static_cast<Side::Side>(snap.side));
+      block->push_back(restored(snap));
+      participant->m_orderComposition[snap.orderID] =
+          OrderPointer(block, &block->back());
+    }
+    std::span<const Trade> trades =
+        participantTrades.subspan(record.trades.first, record.trades.count);
+    participant->m_historyOfTrades.assign(trades.begin(), trades.end());
+
+    std::string govID = file.string(record.govID);
+    xchange.m_govIDs.insert(govID);
+    xchange.govID_partIDMap[govID] = participant->m_participantID;
+    xchange.m_participants[record.handle] = participant;
+    xchange.m_participantCount++;
+  }
+
+  std::span<const PreProcessorRecord> preprocessors =
+      file.view<PreProcessorRecord>(PreProcessors);
+  std::span<const OrderSnap> preOrders = file.view<OrderSnap>(PreOrders);
+  std::span<const ActionRecord> preActions = file.view<ActionRecord>(PreActions);
+  std::span<const OrderID> preEncountered = file.view<OrderID>(PreEncountered);
+  std::span<const OrderRecord> bookOrders = file.view<OrderRecord>(BookOrders);
+  std::span<const Trade> bookTrades = file.view<Trade>(BookTrades);
+  for (const SymbolRecord &record : file.view<SymbolRecord>(Symbols))
+  {
+    xchange.tradeNewSymbol(symbolNames.name(record.handle));
+    const SymbolInfoPointer &symbolInfo = xchange.m_symbolInfos[record.handle];
+
+    OrderBook &book = *symbolInfo->m_orderbook;
+    book.reserveOrders(record.book.count);
+    for (const OrderRecord &resting :
+         bookOrders.subspan(record.book.first, record.book.count))
+      book.RestoreResting(resting);
+    book.RestoreTrades(
+        bookTrades.subspan(record.trades.first, record.trades.count));
+
+    const PreProcessorPointer sides[2] = {symbolInfo->m_bidprepro,
+                                          symbolInfo->m_askprepro};
+    for (std::size_t side = 0; side < 2; side++)
+    {
+      PreProcessor &pre = *sides[side];
+      const PreProcessorRecord &preRecord =
+          preprocessors[record.preprocessors[side]];
+      pre.m_lastFlushTime = stamp(preRecord.lastFlushTime);
+
+      // participant & preprocessor share the order object (fills seen once)
+      pre.m_orderComposition.reserve(preRecord.orders.count);
+      for (const OrderSnap &snap :
+           preOrders.subspan(preRecord.orders.first, preRecord.orders.count))
+      {
+        OrderPointer order = nullptr;
+        ParticipantPointer owner = xchange.getParticipantInfo(snap.participant);
+        if (owner != nullptr)
+          order = owner->getOrder(snap.orderID);
+        pre.m_orderComposition[snap.orderID] =
+            (order != nullptr) ? order : std::make_shared<Order>(restored(snap));
+      }
+
+      pre.m_processingOrderActInfo.reserve(preRecord.actions.count);
+      for (const ActionRecord &action :
+           preActions.subspan(preRecord.actions.first, preRecord.actions.count))
+      {
+        PreProcessor::OrderActionInfo info(
+            action.orderID, static_cast<OrderType::OrderType>(action.orderType),
+            static_cast<Actions::Actions>(action.action),
+            static_cast<Side::Side>(action.side), action.price);
+        if (action.state & InSet)
+          pre.bufferAction(info);
+        if (!(action.state & InMap))
+          continue;
+        pre.m_processingOrderActInfo[action.orderID] = info;
+        if ((action.state & Dormant) &&
+            pre.m_orderComposition.contains(action.orderID))
+        {
+          pre.m_orderTimers[action.orderID] = pre.m_timers.schedule(
+              pre.m_orderComposition.at(action.orderID)->getActivationTime(),
+              action.orderID, TimerWheel::TimerKind::Activate);
+          pre.m_dormantOrders++;
+        }
+      }
+      // expiry timers are derived: every live, non dormant order
+      for (const auto &[orderID, order] : pre.m_orderComposition)
+      {
+        if (!pre.m_orderTimers.contains(orderID))
+          pre.scheduleExpiry(order);
+      }
+
+      std::span<const OrderID> encountered = preEncountered.subspan(
+          preRecord.encountered.first, preRecord.encountered.count);
+      pre.m_encounteredOrders.insert(encountered.begin(), encountered.end());
+    }
+  }
+  return header.sequence;
+}
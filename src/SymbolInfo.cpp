@@ -1,10 +1,11 @@
 #include "include/SymbolInfo.hpp"
+#include "utils/Constants.hpp"
 #include <chrono>
 #include <memory>
 #include <string>
 
 SymbolInfo::SymbolInfo(const std::string &symbol) : m_symbol{symbol} {
-  m_orderbook = std::make_shared<OrderBook>(symbol);
+  m_orderbook = std::make_shared<OrderBook>(symbol, Constants::LadderTicks);
   m_bidprepro = std::make_shared<PreProcessor>(m_orderbook, true);
   m_askprepro = std::make_shared<PreProcessor>(m_orderbook, false);
 }
@@ -13,11 +14,15 @@ SymbolInfo::SymbolInfo(const std::string &symbol,
                        const std::size_t &orderThresold,
                        const std::chrono::milliseconds &durationThreshold,
                       const std::string& localTimeZone,
-                    const TimeTuple& timeTuple)
+                    const TimeTuple& timeTuple,
+                    InternTablePointer symbolNames,
+                    InternTablePointer participantNames,
+                    SessionCalendarPointer calendar)
     : m_symbol{symbol} {
-  m_orderbook = std::make_shared<OrderBook>(symbol);
+  m_orderbook = std::make_shared<OrderBook>(symbol, Constants::LadderTicks,
+                                            symbolNames, participantNames);
   m_bidprepro = std::make_shared<PreProcessor>(m_orderbook, true, orderThresold,
-                                               durationThreshold, localTimeZone, timeTuple);
+                                               durationThreshold, localTimeZone, timeTuple, calendar);
   m_askprepro = std::make_shared<PreProcessor>(
-      m_orderbook, false, orderThresold, durationThreshold, localTimeZone, timeTuple);
+      m_orderbook, false, orderThresold, durationThreshold, localTimeZone, timeTuple, calendar);
 }
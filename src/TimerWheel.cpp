@@ -0,0 +1,219 @@
+#include "include/TimerWheel.hpp"
+#include "utils/alias/Fundamental.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+TimerWheel::TimerWheel(TimeStamp origin, std::chrono::milliseconds tick)
+    : m_origin{origin}, m_tick{tick}
+{
+  assert(tick.count() > 0);
+  m_buckets.fill(NullNode);
+}
+
+// rounded up: a timer never fires before its timestamp
+TimerWheel::Tick TimerWheel::tickCeil(TimeStamp time) const
+{
+  if (time <= m_origin)
+    return 0;
+  auto units =
+      std::chrono::ceil<std::chrono::milliseconds>(time - m_origin).count();
+  auto tick = m_tick.count();
+  return static_cast<Tick>((units + tick - 1) / tick);
+}
+
+TimerWheel::Tick TimerWheel::tickFloor(TimeStamp time) const
+{
+  if (time <= m_origin)
+    return 0;
+  auto units =
+      std::chrono::floor<std::chrono::milliseconds>(time - m_origin).count();
+  return static_cast<Tick>(units / m_tick.count());
+}
+
+TimerWheel::TimerHandle TimerWheel::schedule(TimeStamp due, OrderID orderID,
+                                             TimerKind kind)
+{
+  std::uint32_t node = m_freeHead;
+  if (node != NullNode)
+  {
+    m_freeHead = m_nodes[node].next;
+  }
+  else
+  {
+    node = static_cast<std::uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+  }
+  m_nodes[node].dueTick = tickCeil(due);
+  m_nodes[node].orderID = orderID;
+  m_nodes[node].kind = kind;
+  m_size++;
+
+  if (m_nodes[node].dueTick <= m_currentTick)
+    link(node, ReadyBucket); // already due, handed out on next advance
+  else
+    place(node);
+  return node;
+}
+
+void TimerWheel::cancel(TimerHandle handle)
+{
+  unlink(handle);
+  release(handle);
+}
+
+// lowest level whose span covers the distance, slot picked by due tick bits
+void TimerWheel::place(std::uint32_t node)
+{
+  Tick due = m_nodes[node].dueTick;
+  Tick delta = due - m_currentTick;
+  for (std::size_t level = 0; level < Levels; level++)
+  {
+    if (delta < (Tick{1} << (LevelBits * (level + 1))))
+    {
+      std::size_t slot = (due >> (LevelBits * level)) & (SlotsPerLevel - 1);
+      link(node, static_cast<std::uint16_t>(level * SlotsPerLevel + slot));
+      return;
+    }
+  }
+  // beyond the horizon: park in the farthest top level slot, re-filed there
+  Tick parked = m_currentTick + (Tick{1} << (LevelBits * Levels)) - 1;
+  std::size_t slot =
+      (parked >> (LevelBits * (Levels - 1))) & (SlotsPerLevel - 1);
+  link(node, static_cast<std::uint16_t>((Levels - 1) * SlotsPerLevel + slot));
+}
+
+void TimerWheel::link(std::uint32_t node, std::uint16_t bucket)
+{
+  Node &entry = m_nodes[node];
+  entry.bucket = bucket;
+  entry.prev = NullNode;
+  entry.next = m_buckets[bucket];
+  if (entry.next != NullNode)
+    m_nodes[entry.next].prev = node;
+  m_buckets[bucket] = node;
+  if (bucket != ReadyBucket)
+    m_levelCount[bucket >> LevelBits]++;
+}
+
+void TimerWheel::unlink(std::uint32_t node)
+{
+  Node &entry = m_nodes[node];
+  if (entry.prev != NullNode)
+    m_nodes[entry.prev].next = entry.next;
+  else
+    m_buckets[entry.bucket] = entry.next;
+  if (entry.next != NullNode)
+    m_nodes[entry.next].prev = entry.prev;
+  if (entry.bucket != ReadyBucket)
+    m_levelCount[entry.bucket >> LevelBits]--;
+}
+
+void TimerWheel::release(std::uint32_t node)
+{
+  m_nodes[node].next = m_freeHead;
+  m_freeHead = node;
+  m_size--;
+}
+
+// current slot of a level came round: its timers move down a level (or more)
+void TimerWheel::cascade(std::size_t level)
+{
+  std::size_t slot =
+      (m_currentTick >> (LevelBits * level)) & (SlotsPerLevel - 1);
+  std::size_t bucket = level * SlotsPerLevel + slot;
+  std::uint32_t node = m_buckets[bucket];
+  m_buckets[bucket] = NullNode;
+  while (node != NullNode)
+  {
+    std::uint32_t next = m_nodes[node].next;
+    m_levelCount[level]--;
+    place(node);
+    node = next;
+  }
+}
+
+void TimerWheel::fireSlot(std::size_t slot, std::vector<Timer> &due)
+{
+  std::uint32_t node = m_buckets[slot];
+  m_buckets[slot] = NullNode;
+  while (node != NullNode)
+  {
+    std::uint32_t next = m_nodes[node].next;
+    assert(m_nodes[node].dueTick == m_currentTick);
+    due.push_back(Timer{m_nodes[node].orderID, m_nodes[node].kind});
+    m_levelCount[0]--;
+    release(node);
+    node = next;
+  }
+}
+
+void TimerWheel::advance(TimeStamp now, std::vector<Timer> &due)
+{
+  // overdue when scheduled
+  while (m_buckets[ReadyBucket] != NullNode)
+  {
+    std::uint32_t node = m_buckets[ReadyBucket];
+    due.push_back(Timer{m_nodes[node].orderID, m_nodes[node].kind});
+    unlink(node);
+    release(node);
+  }
+
+  Tick target = tickFloor(now);
+  while (m_currentTick < target)
+  {
+    if (m_size == 0)
+    { // nothing pending, wheel position is free to jump
+      m_currentTick = target;
+      break;
+    }
+
+    // empty low levels: nothing can fire before the next boundary above them
+    std::size_t emptyLevels = 0;
+    while (emptyLevels < Levels && m_levelCount[emptyLevels] == 0)
+      emptyLevels++;
+    Tick next = m_currentTick + 1;
+    if (emptyLevels > 0)
+    {
+      std::size_t bits = LevelBits * emptyLevels;
+      next = std::min(target, ((m_currentTick >> bits) + 1) << bits);
+    }
+    m_currentTick = next;
+
+    for (std::size_t level = Levels - 1; level > 0; level--)
+    {
+      if ((m_currentTick & ((Tick{1} << (LevelBits * level)) - 1)) == 0)
+        cascade(level);
+    }
+    fireSlot(m_currentTick & (SlotsPerLevel - 1), due);
+  }
+}
+
+// lowest non-empty level first: its nearest occupied slot (a whole turn
+// ahead at most) starts before anything filed in the levels above
+TimeStamp TimerWheel::nextDue() const
+{
+  if (m_size == 0)
+    return TimeStamp::max();
+  if (m_buckets[ReadyBucket] != NullNode)
+    return m_origin + m_tick * static_cast<std::int64_t>(m_currentTick);
+  for (std::size_t level = 0; level < Levels; level++)
+  {
+    if (m_levelCount[level] == 0)
+      continue;
+    std::size_t bits = LevelBits * level;
+    Tick position = m_currentTick >> bits;
+    for (Tick step = 1; step <= SlotsPerLevel; step++)
+    {
+      std::size_t slot = (position + step) & (SlotsPerLevel - 1);
+      if (m_buckets[level * SlotsPerLevel + slot] != NullNode)
+        return m_origin +
+               m_tick * static_cast<std::int64_t>((position + step) << bits);
+    }
+  }
+  return TimeStamp::max(); // not reached: m_size counts a filed timer
+}
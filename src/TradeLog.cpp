@@ -0,0 +1,120 @@
+#include "include/TradeLog.hpp"
+#include "include/Trade.hpp"
+#include "utils/alias/TradeRel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+TradeLog::TradeLog(std::size_t segmentTrades, std::size_t residentSegments,
+                   std::string spillPath)
+    : m_segmentTrades{segmentTrades}, m_residentSegments{residentSegments},
+      m_spillPath{std::move(spillPath)}
+{
+  assert(segmentTrades > 0 && residentSegments > 0);
+}
+
+TradeSequence TradeLog::append(const Trade &trade)
+{
+  TradeLog::prepareAppend(); // no-op when the caller already did
+  m_segments[(m_size / m_segmentTrades) % m_residentSegments]
+            [m_size % m_segmentTrades] = trade;
+  return m_size++;
+}
+
+void TradeLog::prepareAppend()
+{
+  if (m_size % m_segmentTrades != 0)
+    return;
+  // opening a segment: reuse the oldest buffer once the ring is full
+  if (m_size - m_firstResident == m_segmentTrades * m_residentSegments)
+    TradeLog::spillOldest();
+  if ((m_size / m_segmentTrades) % m_residentSegments == m_segments.size())
+    m_segments.push_back(std::make_unique<Trade[]>(m_segmentTrades));
+}
+
+void TradeLog::reserve(std::size_t count)
+{
+  std::size_t segments = (count + m_segmentTrades - 1) / m_segmentTrades;
+  segments = std::min(segments, m_residentSegments);
+  while (m_segments.size() < segments)
+    m_segments.push_back(std::make_unique<Trade[]>(m_segmentTrades));
+}
+
+// oldest resident segment is always full & follows the spilled ones on disk
+void TradeLog::spillOldest()
+{
+  std::FILE *file = TradeLog::spillFile();
+  const Trade *records = &TradeLog::resident(m_firstResident);
+  if (std::fseek(file, 0, SEEK_END) != 0 ||
+      std::fwrite(records, sizeof(Trade), m_segmentTrades, file) !=
+          m_segmentTrades)
+    throw std::runtime_error("trade log could NOT spill to disk");
+  m_firstResident += m_segmentTrades;
+}
+
+std::FILE *TradeLog::spillFile()
+{
+  if (m_spill == nullptr)
+  {
+    m_spill.reset(m_spillPath.empty() ? std::tmpfile()
+                                      : std::fopen(m_spillPath.c_str(), "w+b"));
+    if (m_spill == nullptr)
+      throw std::runtime_error("trade log could NOT open spill file " +
+                               m_spillPath);
+  }
+  return m_spill.get();
+}
+
+Trade TradeLog::at(TradeSequence sequence) const
+{
+  if (sequence >= m_size)
+    throw std::out_of_range("no trade at sequence " + std::to_string(sequence));
+  if (sequence >= m_firstResident)
+    return TradeLog::resident(sequence);
+  Trade trade;
+  TradeLog::read(sequence, std::span<Trade>{&trade, 1});
+  return trade;
+}
+
+std::size_t TradeLog::read(TradeSequence from, std::span<Trade> out) const
+{
+  if (from >= m_size)
+    return 0;
+  std::size_t count = std::min<std::size_t>(out.size(), m_size - from);
+  std::size_t copied = 0;
+
+  if (from < m_firstResident)
+  { // spilled part: one seek, one read
+    std::size_t onDisk = std::min<std::size_t>(count, m_firstResident - from);
+    std::FILE *file = m_spill.get();
+    if (std::fseek(file, static_cast<long>(from * sizeof(Trade)), SEEK_SET) !=
+            0 ||
+        std::fread(out.data(), sizeof(Trade), onDisk, file) != onDisk)
+      throw std::runtime_error("trade log could NOT read spill file");
+    copied = onDisk;
+  }
+  // resident part, segment by segment
+  while (copied < count)
+  {
+    TradeSequence sequence = from + copied;
+    std::size_t run = std::min(count - copied,
+                               m_segmentTrades - sequence % m_segmentTrades);
+    const Trade *records = &TradeLog::resident(sequence);
+    std::copy(records, records + run, out.begin() + copied);
+    copied += run;
+  }
+  return copied;
+}
+
+TradeLog::Range TradeLog::since(TradeSequence from) const
+{
+  from = std::min<TradeSequence>(from, m_size);
+  return Range{Iterator{this, from}, Iterator{this, m_size}};
+}
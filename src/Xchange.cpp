@@ -1,4 +1,10 @@
 #include "include/Xchange.hpp"
+#include "include/Clock.hpp"
+#include "include/FlushScheduler.hpp"
+#include "include/Order.hpp"
+#include "include/SessionCalendar.hpp"
+#include "include/Shard.hpp"
+#include "include/Snapshot.hpp"
 #include "include/SymbolInfo.hpp"
 #include "utils/alias/Fundamental.hpp"
 #include "utils/alias/OrderRel.hpp"
@@ -12,11 +18,36 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <exception>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <utility>
+
+namespace
+{
+// id of the order a request creates (none for cancels & incomplete ones),
+// known before it runs: the journaled one on replay, else the next in line
+std::optional<OrderID>
+orderIDFor(const std::optional<OrderID> &journaled,
+           const Actions::Actions action, const std::optional<Side::Side> side,
+           const std::optional<Price> price,
+           const std::optional<Quantity> quantity,
+           const std::optional<TimeStamp> &activationTime,
+           const std::optional<TimeStamp> &deactivationTime)
+{
+  if (action == Actions::Actions::Cancel || !side.has_value() ||
+      !price.has_value() || !quantity.has_value() ||
+      !activationTime.has_value() || !deactivationTime.has_value())
+    return std::nullopt;
+  if (journaled.has_value())
+    return journaled;
+  return Order::getIdGenerator().next();
+}
+} // namespace
 
 //////////////////////////////////////
 ////// Constructors of Xchange //////
@@ -24,7 +55,7 @@
 
 std::unique_ptr<Xchange> Xchange::m_instance = nullptr;
 
-Xchange::Xchange(std::size_t orderThreshold, std::chrono::milliseconds durationThreshold, const std::string &localTimeZone) : m_MAX_PENDING_ORDERS_THRESHOLD{orderThreshold}, m_MAX_PENDING_DURATION{durationThreshold}, localTimeZone{localTimeZone} {}
+Xchange::Xchange(std::size_t orderThreshold, std::chrono::milliseconds durationThreshold, const std::string &localTimeZone) : m_symbolNames{std::make_shared<InternTable>()}, m_participantNames{std::make_shared<InternTable>()}, m_MAX_PENDING_ORDERS_THRESHOLD{orderThreshold}, m_MAX_PENDING_DURATION{durationThreshold}, localTimeZone{localTimeZone}, m_zone{std::chrono::locate_zone(localTimeZone)}, m_calendar{std::make_shared<const SessionCalendar>(Xchange::tradingHoursGMT.at(localTimeZone), SessionCalendar::defaultHolidays(), PreProcessor::getLocalTime())} {}
 
 Xchange::Xchange(std::size_t orderThreshold,
                  std::chrono::milliseconds durationThreshold)
@@ -47,6 +78,19 @@ Xchange &Xchange::getInstance(int pendingThreshold, int pendingDuration)
   return Xchange::getInstance(pendingThreshold, pendingDuration, "Asia/Kolkata");
 }
 
+Xchange::~Xchange()
+{
+  // nothing may run on the state torn down below
+  Xchange::stopFlushScheduler();
+  Xchange::stopPipeline();
+  Xchange::stopShards();
+  for (const SymbolInfoPointer &symbolInfo : m_symbolInfos)
+  {
+    if (symbolInfo != nullptr)
+      symbolInfo->m_orderbook->setTradeListener(nullptr);
+  }
+}
+
 // no need to use static here
 // since static here would indicate internal linkage and not it belongs to class
 void Xchange::destroyInstance() { m_instance.reset(nullptr); }
@@ -65,28 +109,47 @@ ParticipantID Xchange::generateParticipantID(const std::string &govId)
   return partID;
 }
 
-ParticipantID Xchange::addParticipant(const std::string &govID)
+ParticipantHandle Xchange::registerParticipant(const std::string &govID)
 {
+  std::unique_lock<std::mutex> paused = Xchange::quiesce();
   if (m_govIDs.count(govID) > 0 && govID_partIDMap.count(govID) > 0)
-    return govID_partIDMap.at(govID);
+    return Xchange::findParticipant(govID_partIDMap.at(govID));
+  if (m_journal != nullptr)
+    m_journal->appendName(Journal::EventType::RegisterParticipant, govID);
   m_govIDs.insert(govID);
   ParticipantID partID = Xchange::generateParticipantID(govID);
+  ParticipantHandle handle = m_participantNames->intern(partID);
   ParticipantPointer freshParticipant = std::make_shared<Participant>();
   freshParticipant->setParticipantID(partID);
-  m_participants[partID] = freshParticipant;
+  freshParticipant->setParticipantHandle(handle);
+  freshParticipant->setSymbolNames(m_symbolNames);
+  if (handle >= m_participants.size())
+    m_participants.resize(handle + 1);
+  if (m_participants[handle] == nullptr)
+    m_participantCount++;
+  m_participants[handle] = freshParticipant;
   govID_partIDMap[govID] = partID;
-  return partID;
+  return handle;
+}
+
+ParticipantID Xchange::addParticipant(const std::string &govID)
+{
+  return m_participantNames->name(Xchange::registerParticipant(govID));
 }
 
 void Xchange::removeParticipant(const ParticipantID &participantID)
 {
-  if (m_participants.count(participantID) == 0)
+  std::unique_lock<std::mutex> paused = Xchange::quiesce();
+  ParticipantHandle handle = Xchange::findParticipant(participantID);
+  if (handle == InvalidHandle)
     return;
+  if (m_journal != nullptr)
+    m_journal->appendName(Journal::EventType::RemoveParticipant, participantID);
   // lot to learn about smart pointers
-  // removes ParticipantPointer from map (shared_ptr destructor called)
+  // resets ParticipantPointer in its slot (shared_ptr destructor called)
   // if ref count reaches zero, Participant is deleted
-  m_participants.erase(participantID); // what about ParticipantPointer will it
-                                       // be cleared immeadiately?
+  m_participants[handle] = nullptr; // handle itself is never handed out again
+  m_participantCount--;
   std::string partGovID = "";
   for (auto it = participantID.rbegin(); it != participantID.rend(); it++)
   {
@@ -102,7 +165,7 @@ void Xchange::removeParticipant(const ParticipantID &participantID)
   govID_partIDMap.erase(partGovID);
 }
 
-// unified interface for placing order on the exchange
+// unified interface for placing order on the exchange (names resolved once)
 std::optional<OrderID> Xchange::placeOrder(
     const ParticipantID &participantID, const Actions::Actions action,
     const std::optional<OrderID> &oldOrderID,
@@ -112,34 +175,153 @@ std::optional<OrderID> Xchange::placeOrder(
     const std::optional<std::string> &activationTime,
     const std::optional<std::string> &deactivationTime)
 {
-
-  if (m_participants.count(participantID) == 0)
+  ParticipantHandle participant = Xchange::findParticipant(participantID);
+  if (participant == InvalidHandle)
     return std::nullopt; // participant must exist
+  if (!symbol.has_value())
+    return std::nullopt;
+  return Xchange::placeOrder(participant, action, oldOrderID,
+                             Xchange::findSymbol(symbol.value()), side,
+                             orderType, price, quantity, activationTime,
+                             deactivationTime);
+}
+
+// handle fast path: participant & symbol are plain vector indices
+std::optional<OrderID> Xchange::placeOrder(
+    const ParticipantHandle participant, const Actions::Actions action,
+    const std::optional<OrderID> &oldOrderID, const SymbolHandle symbol,
+    const std::optional<Side::Side> side,
+    const std::optional<OrderType::OrderType> orderType,
+    const std::optional<double> price, const std::optional<Quantity> quantity,
+    const std::optional<std::string> &activationTime,
+    const std::optional<std::string> &deactivationTime)
+{
+  // the string edge: parsed once here, the engine runs on ticks & instants
+  std::optional<Price> ticks;
+  if (price.has_value())
+    ticks = Order::toTicks(price.value());
+  std::optional<TimeStamp> activation, deactivation;
+  if (activationTime.has_value())
+    activation = Order::parseActivationTime(activationTime.value(), m_zone);
+  if (deactivationTime.has_value())
+    deactivation =
+        Order::parseDeactivationTime(deactivationTime.value(), m_zone);
+  return Xchange::acceptOrder(participant, action, oldOrderID, symbol, side,
+                              orderType, ticks, quantity, activation,
+                              deactivation, std::nullopt);
+}
+
+// typed entry (binary order entry decodes straight into it)
+std::optional<OrderID> Xchange::placeOrder(const OrderRequest &request)
+{
+  return Xchange::acceptOrder(request.participant, request.action,
+                              request.oldOrderID, request.symbol, request.side,
+                              request.orderType, request.price,
+                              request.quantity, request.activationTime,
+                              request.deactivationTime, std::nullopt);
+}
+
+std::optional<OrderID> Xchange::acceptOrder(
+    const ParticipantHandle participant, const Actions::Actions action,
+    const std::optional<OrderID> &oldOrderID, const SymbolHandle symbol,
+    const std::optional<Side::Side> side,
+    const std::optional<OrderType::OrderType> orderType,
+    const std::optional<Price> price, const std::optional<Quantity> quantity,
+    const std::optional<TimeStamp> &activationTime,
+    const std::optional<TimeStamp> &deactivationTime,
+    const std::optional<OrderID> &journaledID)
+{
+  Clock::refresh(); // one batch: reads below (journal, order, fills) share it
+  if (m_pipeline != nullptr)
+  { // validation is the pipeline's first stage (a rejected id stays unused)
+    std::optional<OrderID> orderID =
+        orderIDFor(journaledID, action, side, price, quantity, activationTime,
+                   deactivationTime);
+    Xchange::pipelineOrder(participant, action, oldOrderID, symbol, side,
+                           orderType, price, quantity, activationTime,
+                           deactivationTime, orderID);
+    return orderID;
+  }
+  if (!Xchange::isAcceptable(participant, action, oldOrderID, symbol, side,
+                             orderType))
+    return std::nullopt;
+  std::optional<OrderID> orderID =
+      orderIDFor(journaledID, action, side, price, quantity, activationTime,
+                 deactivationTime);
+
+  // due snapshot taken first: it then covers exactly the journal so far
+  if (m_snapshotEvents > 0 && m_journal != nullptr &&
+      m_journal->getLastSequence() - m_snapshotSequence >= m_snapshotEvents)
+    Xchange::writeSnapshot(m_snapshotPath);
+
+  // accepted: logged before any state changes (replay takes the same path)
+  if (m_journal != nullptr)
+    m_journal->appendOrder(participant, action, oldOrderID, symbol, side,
+                           orderType, price, quantity, activationTime,
+                           deactivationTime, orderID);
+
+  if (!m_shards.empty())
+  { // id drawn here, the rest runs on the symbol's shard
+    m_shards[symbol % m_shards.size()]->submit(OrderRequest{
+        participant, action, oldOrderID, symbol, side, orderType, price,
+        quantity, activationTime, deactivationTime, orderID});
+    return orderID;
+  }
+  return Xchange::executeOrder(participant, action, oldOrderID, symbol, side,
+                               orderType, price, quantity, activationTime,
+                               deactivationTime, orderID);
+}
+
+bool Xchange::isAcceptable(
+    const ParticipantHandle participant, const Actions::Actions action,
+    const std::optional<OrderID> &oldOrderID, const SymbolHandle symbol,
+    const std::optional<Side::Side> side,
+    const std::optional<OrderType::OrderType> orderType) const
+{
+  if (Xchange::getParticipantInfo(participant) == nullptr)
+    return false; // participant must exist
 
-  if (!symbol.has_value() || !orderType.has_value() || !side.has_value())
-    return std::nullopt; // presence must (not modifiable: explicit c+a)
+  if (!orderType.has_value() || !side.has_value())
+    return false; // presence must (not modifiable: explicit c+a)
+
+  if (symbol >= m_symbolInfos.size() || m_symbolInfos[symbol] == nullptr)
+    return false; // symbol must be traded
 
   if (action != Actions::Actions::Add && !oldOrderID.has_value())
-    return std::nullopt; // cancel/modify must have oldOrderID for deletion
+    return false; // cancel/modify must have oldOrderID for deletion
+  return true;
+}
+
+// request already validated & journaled (caller's thread or its shard)
+std::optional<OrderID> Xchange::executeOrder(
+    const ParticipantHandle participant, const Actions::Actions action,
+    const std::optional<OrderID> &oldOrderID, const SymbolHandle symbol,
+    const std::optional<Side::Side> side,
+    const std::optional<OrderType::OrderType> orderType,
+    const std::optional<Price> price, const std::optional<Quantity> quantity,
+    const std::optional<TimeStamp> &activationTime,
+    const std::optional<TimeStamp> &deactivationTime,
+    const std::optional<OrderID> &orderID)
+{
+  ParticipantPointer participantPointer = m_participants[participant];
+  SymbolInfoPointer symbolInfoPointer = m_symbolInfos[symbol];
+  // symbol before participant, as on the scheduler's flush
+  std::unique_lock<std::mutex> symbolLock =
+      Xchange::lockSymbol(*symbolInfoPointer);
 
   OrderPointer orderptr{nullptr};
-  bool canNOTplaceOrder =
-      (!price.has_value() || !quantity.has_value() ||
-       !activationTime.has_value() || !deactivationTime.has_value());
 
-  // create the new order that will be created in this call
-  if (!canNOTplaceOrder)
+  // create the new order that will be created in this call (id given on
+  // acceptance exactly when the request carries everything for one)
+  if (orderID.has_value())
   {
-    orderptr = m_participants[participantID]->recordNonCancelOrder(
-        action, symbol.value(), orderType.value(), side.value(), price.value(),
-        quantity.value(), participantID, activationTime.value(),
-        deactivationTime.value());
+    std::unique_lock<std::mutex> lock = Xchange::lockParticipant(participant);
+    orderptr = participantPointer->recordNonCancelOrder(
+        action, symbolInfoPointer->m_symbol, orderType.value(), side.value(),
+        price.value(), quantity.value(), participantPointer->getParticipantID(),
+        activationTime.value(), deactivationTime.value(), orderID);
   }
 
-  SymbolInfoPointer symbolInfoPointer = m_symbolInfos.at(symbol.value());
-  if (symbolInfoPointer == nullptr)
-    return std::nullopt;
-
   PreProcessorPointer prePtr =
       ((side == Side::Side::Buy) ? symbolInfoPointer->m_bidprepro
                                  : symbolInfoPointer->m_askprepro);
@@ -152,10 +334,11 @@ std::optional<OrderID> Xchange::placeOrder(
     return orderptr->getOrderID();
   }
 
+  std::unique_lock<std::mutex> lock = Xchange::lockParticipant(participant);
   auto const oldOrderInfo =
-      m_participants.at(participantID)->getOrderInformation(oldOrderID.value());
+      participantPointer->getOrderInformation(oldOrderID.value());
   if (oldOrderInfo.side != side || oldOrderInfo.otype != orderType ||
-      oldOrderInfo.symbol != symbol)
+      oldOrderInfo.symbol != symbolInfoPointer->m_symbol)
   {
     throw std::logic_error("can NOT alter side, ordertype, symbol while "
                            "modifying a previous order");
@@ -167,9 +350,10 @@ std::optional<OrderID> Xchange::placeOrder(
 
   // getParticipantInfo(participantID)->recordCancelOrder(oldOrderID.value());
   if (!hasEntered)
-    getParticipantInfo(participantID)->recordCancelOrder(oldOrderID.value());
+    participantPointer->recordCancelOrder(oldOrderID.value());
   else
     std::cout << "WHY NOT FUCKING CANCEL RECORDED!" << std::endl;
+  lock = {}; // preprocessor below may match (trades lock participants)
 
   if (action == Actions::Actions::Modify)
   {
@@ -188,43 +372,512 @@ std::optional<OrderID> Xchange::placeOrder(
   return std::nullopt;
 }
 
+// a throwing request must not take the shard down: reported instead
+void Xchange::executeOnShard(OrderRequest &request)
+{
+  ExecutionReport report;
+  report.participant = request.participant;
+  report.symbol = request.symbol;
+  report.action = request.action;
+  try
+  {
+    report.orderID = Xchange::executeOrder(
+        request.participant, request.action, request.oldOrderID,
+        request.symbol, request.side, request.orderType, request.price,
+        request.quantity, request.activationTime, request.deactivationTime,
+        request.orderID);
+  }
+  catch (const std::exception &error)
+  {
+    report.accepted = false;
+    report.reason = error.what();
+  }
+  if (m_executionListener)
+    m_executionListener(report);
+}
+
+std::unique_lock<std::mutex>
+Xchange::lockParticipant(ParticipantHandle participant) const
+{
+  if (m_participantLocks == nullptr)
+    return {};
+  return std::unique_lock<std::mutex>(
+      m_participantLocks[participant % ParticipantLockStripes]);
+}
+
+// participants not (or no longer) registered are skipped
+void Xchange::routeTrade(const Trade &trade) const
+{
+  ParticipantHandle buyer = trade.getMatchedBid().participant;
+  ParticipantHandle seller = trade.getMatchedAsk().participant;
+  if (ParticipantPointer participant = Xchange::getParticipantInfo(buyer))
+  {
+    std::unique_lock<std::mutex> lock = Xchange::lockParticipant(buyer);
+    participant->recordTrade(trade);
+  }
+  if (seller == buyer)
+    return; // self trade: seen once above (nothing booked)
+  if (ParticipantPointer participant = Xchange::getParticipantInfo(seller))
+  {
+    std::unique_lock<std::mutex> lock = Xchange::lockParticipant(seller);
+    participant->recordTrade(trade);
+  }
+}
+
 //////////////////////////////////////
-///////// SYMBOL FUNCTIONALITY //////
+///////// SHARD FUNCTIONALITY ///////
 ////////////////////////////////////
 
-void Xchange::tradeNewSymbol(const std::string &SYMBOL)
+void Xchange::startShards(std::size_t shardCount, std::size_t ringCapacity)
 {
-  if (m_symbolInfos.count(SYMBOL) > 0)
+  if (m_pipeline != nullptr)
+    throw std::logic_error("can NOT shard while pipelined");
+  Xchange::stopShards();
+  if (shardCount == 0)
     return;
+  if (m_participantLocks == nullptr)
+    m_participantLocks =
+        std::make_unique<std::mutex[]>(ParticipantLockStripes);
+  for (std::size_t index = 0; index < shardCount; index++)
+    m_shards.push_back(std::make_unique<Shard>(
+        index, ringCapacity,
+        [this](OrderRequest &request)
+        { Xchange::executeOnShard(request); }));
+}
+
+void Xchange::stopShards()
+{
+  m_shards.clear(); // each drains & joins
+  if (m_flushScheduler == nullptr)
+    m_participantLocks.reset(nullptr);
+}
+
+// idle shards only poll their rings: shared state is the caller's again
+void Xchange::drainShards() const
+{
+  for (const ShardPointer &shard : m_shards)
+    shard->drain();
+}
+
+void Xchange::setExecutionListener(ExecutionListener listener)
+{
+  std::unique_lock<std::mutex> paused = Xchange::quiesce();
+  m_executionListener = std::move(listener); // next submit publishes it
+}
+
+std::unique_lock<std::mutex> Xchange::quiesce() const
+{
+  Xchange::drainShards();
+  Xchange::drainPipeline();
+  if (m_flushScheduler == nullptr)
+    return {};
+  return m_flushScheduler->pause();
+}
+
+std::unique_lock<std::mutex> Xchange::lockSymbol(SymbolInfo &symbolInfo) const
+{
+  if (m_flushScheduler == nullptr)
+    return {};
+  return std::unique_lock<std::mutex>(symbolInfo.m_lock);
+}
+
+//////////////////////////////////////
+///////// FLUSH SCHEDULER ///////////
+////////////////////////////////////
+
+void Xchange::startFlushScheduler(std::chrono::milliseconds tick)
+{
+  Xchange::quiesce(); // lockSymbol sees the scheduler from the next request
+  if (m_flushScheduler != nullptr)
+    return;
+  // participants now hear of trades from two threads at least
+  if (m_participantLocks == nullptr)
+    m_participantLocks =
+        std::make_unique<std::mutex[]>(ParticipantLockStripes);
+  m_flushScheduler = std::make_unique<FlushScheduler>(tick);
+  for (const SymbolInfoPointer &symbolInfo : m_symbolInfos)
+  {
+    if (symbolInfo != nullptr)
+      m_flushScheduler->add(symbolInfo);
+  }
+}
+
+void Xchange::stopFlushScheduler()
+{
+  Xchange::quiesce();
+  m_flushScheduler.reset(nullptr); // joins, flush on insert again
+  if (m_shards.empty())
+    m_participantLocks.reset(nullptr);
+}
+
+//////////////////////////////////////
+///////// PIPELINE FUNCTIONALITY ////
+////////////////////////////////////
+
+void Xchange::startPipeline(std::size_t ringCapacity)
+{
+  if (!m_shards.empty())
+    throw std::logic_error("can NOT pipeline while sharded");
+  Xchange::stopPipeline();
+  std::vector<Pipeline::Stage> stages;
+  stages.emplace_back([this](PipelineEvent &event, bool)
+                      { Xchange::validateEvent(event); });
+  stages.emplace_back([this](PipelineEvent &event, bool endOfBatch)
+                      { Xchange::journalEvent(event, endOfBatch); });
+  stages.emplace_back([this](PipelineEvent &event, bool)
+                      { Xchange::executeEvent(event); });
+  stages.emplace_back([this](PipelineEvent &event, bool)
+                      { Xchange::publishEvent(event); });
+  m_pipeline = std::make_unique<Pipeline>(ringCapacity, std::move(stages));
+  m_pipelinedSinceSnapshot = 0;
+}
+
+void Xchange::stopPipeline() { m_pipeline.reset(nullptr); }
+
+void Xchange::drainPipeline() const
+{
+  if (m_pipeline != nullptr)
+    m_pipeline->drain();
+}
+
+// slots are filled in place (plain values, nothing allocated per request)
+void Xchange::pipelineOrder(
+    const ParticipantHandle participant, const Actions::Actions action,
+    const std::optional<OrderID> &oldOrderID, const SymbolHandle symbol,
+    const std::optional<Side::Side> side,
+    const std::optional<OrderType::OrderType> orderType,
+    const std::optional<Price> price, const std::optional<Quantity> quantity,
+    const std::optional<TimeStamp> &activationTime,
+    const std::optional<TimeStamp> &deactivationTime,
+    const std::optional<OrderID> &orderID)
+{
+  // due snapshot: only once the requests since the last one could add up
+  // to it (the journal is the journal stage's until the pipeline drains)
+  if (m_snapshotEvents > 0 && m_journal != nullptr &&
+      ++m_pipelinedSinceSnapshot >= m_snapshotEvents)
+  {
+    m_pipeline->drain();
+    if (m_journal->getLastSequence() - m_snapshotSequence >= m_snapshotEvents)
+    {
+      Xchange::writeSnapshot(m_snapshotPath);
+      m_pipelinedSinceSnapshot = 0;
+    }
+  }
+
+  PipelineEvent &event = m_pipeline->claim();
+  OrderRequest &request = event.request;
+  request.participant = participant;
+  request.action = action;
+  request.oldOrderID = oldOrderID;
+  request.symbol = symbol;
+  request.side = side;
+  request.orderType = orderType;
+  request.price = price;
+  request.quantity = quantity;
+  request.activationTime = activationTime;
+  request.deactivationTime = deactivationTime;
+  request.orderID = orderID;
+  m_pipeline->publish();
+}
+
+void Xchange::validateEvent(PipelineEvent &event) const
+{
+  const OrderRequest &request = event.request;
+  ExecutionReport &report = event.report;
+  report.participant = request.participant;
+  report.symbol = request.symbol;
+  report.action = request.action;
+  report.orderID.reset();
+  report.reason.clear();
+  report.accepted =
+      Xchange::isAcceptable(request.participant, request.action,
+                            request.oldOrderID, request.symbol, request.side,
+                            request.orderType);
+  if (!report.accepted)
+    report.reason = "invalid request";
+}
+
+// group commit at the end of every batch: the busier the exchange, the
+// more requests share one fdatasync
+// a failed append or commit rolls the journal back to its last commit: every
+// event of the batch not covered by it is rejected (none of it executes, so
+// live state & journal agree), the stage ahead still owns them all
+void Xchange::journalEvent(PipelineEvent &event, bool endOfBatch)
+{
+  if (m_journal == nullptr)
+    return;
+  const OrderRequest &request = event.request;
+  ExecutionReport &report = event.report;
+  try
+  {
+    if (report.accepted)
+      m_journalBatch.emplace_back(
+          &event, m_journal->appendOrder(
+                      request.participant, request.action, request.oldOrderID,
+                      request.symbol, request.side, request.orderType,
+                      request.price, request.quantity, request.activationTime,
+                      request.deactivationTime, request.orderID));
+    if (endOfBatch)
+      m_journal->commit();
+  }
+  catch (const std::exception &error)
+  {
+    std::string reason = error.what();
+    try
+    {
+      m_journal->rollback();
+    }
+    catch (const std::exception &rollbackError)
+    {
+      reason += std::string("; ") + rollbackError.what();
+    }
+    JournalSequence committed = m_journal->getCommittedSequence();
+    for (auto &[uncommitted, sequence] : m_journalBatch)
+    {
+      if (sequence <= committed)
+        continue;
+      uncommitted->report.accepted = false;
+      uncommitted->report.reason = reason;
+    }
+    m_journalBatch.clear();
+    report.accepted = false;
+    report.reason = reason;
+  }
+  if (endOfBatch)
+    m_journalBatch.clear();
+}
+
+void Xchange::executeEvent(PipelineEvent &event)
+{
+  const OrderRequest &request = event.request;
+  ExecutionReport &report = event.report;
+  if (!report.accepted)
+    return;
+  try
+  {
+    report.orderID = Xchange::executeOrder(
+        request.participant, request.action, request.oldOrderID,
+        request.symbol, request.side, request.orderType, request.price,
+        request.quantity, request.activationTime, request.deactivationTime,
+        request.orderID);
+  }
+  catch (const std::exception &error)
+  {
+    report.accepted = false;
+    report.reason = error.what();
+  }
+}
+
+void Xchange::publishEvent(const PipelineEvent &event) const
+{
+  if (m_executionListener)
+    m_executionListener(event.report);
+}
+
+//////////////////////////////////////
+///////// JOURNAL FUNCTIONALITY /////
+////////////////////////////////////
+
+void Xchange::startJournal(const std::string &path, JournalOptions options)
+{
+  // the pipeline's journal stage lets go of it
+  std::unique_lock<std::mutex> paused = Xchange::quiesce();
+  m_journal = std::make_unique<Journal>(path, options);
+}
+
+void Xchange::stopJournal()
+{
+  std::unique_lock<std::mutex> paused = Xchange::quiesce();
+  m_journal.reset(nullptr);
+}
+
+// handles are handed out in arrival order, so the same events in the same
+// order land on the same participants, symbols & order ids
+JournalSequence Xchange::replayJournal(const std::string &path,
+                                       JournalSequence after)
+{
+  Xchange::quiesce(); // drained only: replayed requests pause for themselves
+  std::unique_ptr<Journal> live = std::move(m_journal); // no re-logging
+  // expiries, activations & flushes are judged on journal time: a clock
+  // that doesn't follow events is swapped for a simulated one meanwhile
+  ClockPointer previous = Clock::installed();
+  const bool follows =
+      dynamic_cast<SimulatedClock *>(previous.get()) != nullptr;
+  bool swapped = false;
+  auto swapBack = [this, &previous, &swapped]()
+  {
+    if (!swapped)
+      return;
+    std::unique_lock<std::mutex> paused = Xchange::quiesce();
+    Clock::install(previous);
+    Xchange::switchCalendar(std::make_shared<const SessionCalendar>(
+        m_calendar->getHours(), m_calendar->getHolidays(), Clock::now()));
+  };
+  JournalSequence last = 0;
+  try
+  {
+    last = Journal::replay(
+        path, [this, follows, &swapped](const Journal::Event &event)
+        {
+          if (!follows && !swapped)
+          { // starts at the first event (sessions counted from there)
+            std::unique_lock<std::mutex> paused = Xchange::quiesce();
+            Clock::install(std::make_shared<SimulatedClock>(event.time));
+            Xchange::switchCalendar(std::make_shared<const SessionCalendar>(
+                m_calendar->getHours(), m_calendar->getHolidays(), event.time));
+            swapped = true;
+          }
+          Clock::follow(event.time); // runs on journal time
+          switch (event.type)
+          {
+          case Journal::EventType::RegisterParticipant:
+            Xchange::registerParticipant(event.name);
+            break;
+          case Journal::EventType::RemoveParticipant:
+            Xchange::removeParticipant(event.name);
+            break;
+          case Journal::EventType::TradeSymbol:
+            Xchange::tradeNewSymbol(event.name);
+            break;
+          case Journal::EventType::RetireSymbol:
+            Xchange::retireOldSymbol(event.name);
+            break;
+          case Journal::EventType::PlaceOrder:
+            if (event.orderID.has_value()) // never handed out again
+              Order::getIdGenerator().advanceTo(event.orderID.value() + 1);
+            try
+            {
+              Xchange::acceptOrder(event.participant, event.action,
+                                   event.oldOrderID, event.symbol, event.side,
+                                   event.orderType, event.price, event.quantity,
+                                   event.activationTime, event.deactivationTime,
+                                   event.orderID);
+            }
+            catch (const std::logic_error &)
+            {
+              // rejected live as well (after being logged), same outcome
+            }
+            break;
+          }
+        },
+        after);
+  }
+  catch (...)
+  {
+    Xchange::quiesce();
+    swapBack();
+    m_journal = std::move(live);
+    throw;
+  }
+  Xchange::quiesce(); // sharded/pipelined: replayed orders ran to completion
+  swapBack();         // timers due since the last event fire on the next pass
+  m_journal = std::move(live);
+  return last;
+}
+
+void Xchange::writeSnapshot(const std::string &path)
+{
+  std::unique_lock<std::mutex> paused = Xchange::quiesce();
+  JournalSequence sequence = 0;
+  if (m_journal != nullptr)
+  { // snapshot never claims more than the journal made durable
+    m_journal->commit();
+    sequence = m_journal->getLastSequence();
+  }
+  Snapshot::write(*this, path, sequence);
+  m_snapshotSequence = sequence;
+}
+
+void Xchange::setSnapshotPolicy(const std::string &path,
+                                std::uint64_t everyEvents)
+{
+  m_snapshotPath = path;
+  m_snapshotEvents = everyEvents;
+}
+
+JournalSequence Xchange::restore(const std::string &snapshotPath,
+                                 const std::string &journalPath)
+{
+  Xchange::quiesce(); // drained only: load trades symbols (pausing) itself
+  JournalSequence covered = Snapshot::load(*this, snapshotPath);
+  m_snapshotSequence = covered;
+  JournalSequence last = Xchange::replayJournal(journalPath, covered);
+  return (last > covered) ? last : covered;
+}
+
+//////////////////////////////////////
+///////// SYMBOL FUNCTIONALITY //////
+////////////////////////////////////
+
+SymbolHandle Xchange::tradeNewSymbol(const std::string &SYMBOL)
+{
+  std::unique_lock<std::mutex> paused = Xchange::quiesce();
+  SymbolHandle handle = m_symbolNames->intern(SYMBOL);
+  if (handle >= m_symbolInfos.size())
+    m_symbolInfos.resize(handle + 1);
+  if (m_symbolInfos[handle] != nullptr)
+    return handle;
+  if (m_journal != nullptr)
+    m_journal->appendName(Journal::EventType::TradeSymbol, SYMBOL);
   SymbolInfoPointer symPtr{std::make_shared<SymbolInfo>(
-      SYMBOL, m_MAX_PENDING_ORDERS_THRESHOLD, m_MAX_PENDING_DURATION, localTimeZone, Xchange::tradingHoursGMT.at(localTimeZone))};
+      SYMBOL, m_MAX_PENDING_ORDERS_THRESHOLD, m_MAX_PENDING_DURATION, localTimeZone, Xchange::tradingHoursGMT.at(localTimeZone), m_symbolNames, m_participantNames, m_calendar)};
+
+  symPtr->m_orderbook->setTradeListener(
+      [this](const Trade &trade)
+      { Xchange::routeTrade(trade); });
 
-  m_symbolInfos[SYMBOL] = symPtr;
+  m_symbolInfos[handle] = symPtr;
+  m_symbolCount++;
+  if (m_flushScheduler != nullptr)
+    m_flushScheduler->add(symPtr);
+  return handle;
 }
 
 void Xchange::retireOldSymbol(const std::string &SYMBOL)
 {
-  if (m_symbolInfos.count(SYMBOL) == 0)
+  std::unique_lock<std::mutex> paused = Xchange::quiesce();
+  SymbolHandle handle = Xchange::findSymbol(SYMBOL);
+  if (handle == InvalidHandle)
     return;
-  m_symbolInfos.erase(SYMBOL);
+  if (m_journal != nullptr)
+    m_journal->appendName(Journal::EventType::RetireSymbol, SYMBOL);
+  m_symbolInfos[handle]->m_orderbook->setTradeListener(nullptr);
+  if (m_flushScheduler != nullptr)
+    m_flushScheduler->remove(m_symbolInfos[handle]);
+  m_symbolInfos[handle] = nullptr; // handle comes back if traded again
+  m_symbolCount--;
+}
+
+SymbolHandle Xchange::findSymbol(const Symbol &SYMBOL) const
+{
+  SymbolHandle handle = m_symbolNames->find(SYMBOL);
+  if (handle >= m_symbolInfos.size() || m_symbolInfos[handle] == nullptr)
+    return InvalidHandle;
+  return handle;
 }
 
 OrderBookPointer Xchange::getOrderBook(const Symbol &SYMBOL) const
 {
-  if (m_symbolInfos.count(SYMBOL) == 0)
+  return Xchange::getOrderBook(Xchange::findSymbol(SYMBOL));
+}
+
+OrderBookPointer Xchange::getOrderBook(SymbolHandle symbol) const
+{
+  if (symbol >= m_symbolInfos.size() || m_symbolInfos[symbol] == nullptr)
     return nullptr;
-  return m_symbolInfos.at(SYMBOL)->m_orderbook;
+  return m_symbolInfos[symbol]->m_orderbook;
 }
 
 PreProcessorPointer Xchange::getPreProcessor(const Symbol &SYMBOL,
                                              const Side::Side &side) const
 {
-  if (m_symbolInfos.count(SYMBOL) == 0)
+  SymbolHandle handle = Xchange::findSymbol(SYMBOL);
+  if (handle == InvalidHandle)
     return nullptr;
   if (side == Side::Side::Buy)
-    return m_symbolInfos.at(SYMBOL)->m_bidprepro;
+    return m_symbolInfos[handle]->m_bidprepro;
   else
-    return m_symbolInfos.at(SYMBOL)->m_askprepro;
+    return m_symbolInfos[handle]->m_askprepro;
 }
 
 std::size_t Xchange::getOrderThreshold() const
@@ -242,6 +895,39 @@ const std::string &Xchange::getTimeZone() const
   return localTimeZone;
 }
 
+void Xchange::loadHolidays(const std::string &path)
+{
+  // read before pausing anything (throws on a bad file, nothing changed)
+  SessionCalendarPointer calendar = std::make_shared<const SessionCalendar>(
+      Xchange::tradingHoursGMT.at(localTimeZone),
+      SessionCalendar::loadHolidays(path), PreProcessor::getLocalTime());
+  std::unique_lock<std::mutex> paused = Xchange::quiesce();
+  Xchange::switchCalendar(calendar);
+}
+
+void Xchange::switchCalendar(SessionCalendarPointer calendar)
+{
+  m_calendar = std::move(calendar);
+  for (const SymbolInfoPointer &symbolInfo : m_symbolInfos)
+  {
+    if (symbolInfo == nullptr)
+      continue;
+    symbolInfo->m_bidprepro->setCalendar(m_calendar);
+    symbolInfo->m_askprepro->setCalendar(m_calendar);
+  }
+}
+
+void Xchange::setClock(ClockPointer clock)
+{
+  std::unique_lock<std::mutex> paused = Xchange::quiesce();
+  TimeStamp from = (clock != nullptr) ? clock->read() : WallClock{}.read();
+  if (m_symbolCount > 0 && from < Clock::now())
+    throw std::logic_error("clock can NOT run backwards while symbols trade");
+  Clock::install(std::move(clock));
+  Xchange::switchCalendar(std::make_shared<const SessionCalendar>(
+      m_calendar->getHours(), m_calendar->getHolidays(), from));
+}
+
 bool Xchange::isGovIDPresent(const std::string &govID) const
 {
   return (m_govIDs.count(govID) > 0);
@@ -262,30 +948,44 @@ Xchange::getParticipantIDFromGovID(const std::string &govID) const
 
 std::size_t Xchange::getParticipantCount() const
 {
-  return m_participants.size();
+  return m_participantCount;
+}
+
+ParticipantHandle Xchange::findParticipant(const ParticipantID &partID) const
+{
+  ParticipantHandle handle = m_participantNames->find(partID);
+  if (handle >= m_participants.size() || m_participants[handle] == nullptr)
+    return InvalidHandle;
+  return handle;
 }
 
 bool Xchange::isParticipantIDPresent(const std::string &partID) const
 {
-  return (m_participants.count(partID) > 0);
+  return (Xchange::findParticipant(partID) != InvalidHandle);
 }
 
 ParticipantPointer
 Xchange::getParticipantInfo(const std::string &partID) const
 {
-  if (!isParticipantIDPresent(partID))
+  return Xchange::getParticipantInfo(Xchange::findParticipant(partID));
+}
+
+ParticipantPointer
+Xchange::getParticipantInfo(ParticipantHandle participant) const
+{
+  if (participant >= m_participants.size())
     return nullptr;
-  return m_participants.at(partID);
+  return m_participants[participant];
 }
 
 std::size_t Xchange::getSymbolsTradedCount() const
 {
-  return m_symbolInfos.size();
+  return m_symbolCount;
 }
 
 bool Xchange::isSymbolTraded(const std::string &symbol) const
 {
-  return (m_symbolInfos.count(symbol) > 0);
+  return (Xchange::findSymbol(symbol) != InvalidHandle);
 }
 
 // https://www.cmcmarkets.com/en-gb/trading-guides/stock-market-trading-hours
@@ -0,0 +1,579 @@
+#include "include/InternTable.hpp"
+#include "include/Order.hpp"
+#include "include/OrderBook.hpp"
+#include "include/OrderIndex.hpp"
+#include "include/OrderRecord.hpp"
+#include "include/TradeLog.hpp"
+#include "utils/alias/Fundamental.hpp"
+#include "utils/alias/InternRel.hpp"
+#include "utils/alias/TradeRel.hpp"
+#include "utils/enums/OrderTypes.hpp"
+#include "utils/enums/Side.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <new>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// counts heap allocations made while counting is switched on
+// (global operator new replaced for this test binary only)
+static bool g_countAllocations = false;
+static std::size_t g_allocationCount = 0;
+
+static void *countedAllocate(std::size_t size)
+{
+  if (g_countAllocations)
+    g_allocationCount++;
+  if (void *ptr = std::malloc(size == 0 ? 1 : size))
+    return ptr;
+  throw std::bad_alloc();
+}
+static void countedRelease(void *ptr) noexcept { std::free(ptr); }
+
+void *operator new(std::size_t size) { return countedAllocate(size); }
+void *operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void *ptr) noexcept { countedRelease(ptr); }
+void operator delete[](void *ptr) noexcept { countedRelease(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { countedRelease(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { countedRelease(ptr); }
+
+template <typename Fn> std::size_t countAllocations(Fn &&fn)
+{
+  g_allocationCount = 0;
+  g_countAllocations = true;
+  fn();
+  g_countAllocations = false;
+  return g_allocationCount;
+}
+
+// (price, quantity, #orders) of every level on a side, best to worst
+template <typename Ladder>
+std::vector<std::tuple<Price, Quantity, std::size_t>>
+flattenLevels(const Ladder &ladder)
+{
+  std::vector<std::tuple<Price, Quantity, std::size_t>> levels;
+  for (const auto &[price, level] : ladder)
+    levels.emplace_back(price, level->getQuantity(), level->getOrderCount());
+  return levels;
+}
+
+OrderID addLimitOrder(OrderBook &ob, Side::Side side, double price,
+                      Quantity quantity)
+{
+  Order order("SPY", OrderType::OrderType::GoodTillCancel, side, price,
+              quantity, "0_NUB");
+  ob.AddOrder(order);
+  return order.getOrderID();
+}
+
+TEST(OrderBook, LadderLevelsMatchSparseBook)
+{
+  OrderBook sparse("SPY");
+  // 64 ticks around 100.00: 99.68 - 100.31 dense, rest in tree
+  OrderBook ladder("SPY", 10000, 64);
+
+  std::vector<std::tuple<Side::Side, double, Quantity>> orders = {
+      {Side::Side::Buy, 99.95, 4},  {Side::Side::Buy, 99.90, 7},
+      {Side::Side::Buy, 97.00, 3},  {Side::Side::Buy, 99.99, 1},
+      {Side::Side::Buy, 12.50, 9},  {Side::Side::Sell, 100.05, 2},
+      {Side::Side::Sell, 100.30, 5}, {Side::Side::Sell, 180.00, 8},
+      {Side::Side::Sell, 100.01, 6}, {Side::Side::Sell, 100.45, 3}};
+  for (const auto &[side, price, qty] : orders)
+  {
+    addLimitOrder(sparse, side, price, qty);
+    addLimitOrder(ladder, side, price, qty);
+  }
+
+  ASSERT_EQ(flattenLevels(ladder.getBidLevels()),
+            flattenLevels(sparse.getBidLevels()));
+  ASSERT_EQ(flattenLevels(ladder.getAskLevels()),
+            flattenLevels(sparse.getAskLevels()));
+  ASSERT_EQ(ladder.getBidLevels().best()->getPrice(), 9999);
+  ASSERT_EQ(ladder.getBidLevels().worst()->getPrice(), 1250);
+  ASSERT_EQ(ladder.getAskLevels().best()->getPrice(), 10001);
+  ASSERT_EQ(ladder.getAskLevels().worst()->getPrice(), 18000);
+}
+
+// quantity at or better than price, level by level (reference)
+template <typename Ladder>
+Quantity walkDepth(const Ladder &levels, Price price, bool bids)
+{
+  Quantity depth = 0;
+  for (const auto &[levelPrice, level] : levels)
+  {
+    if (bids ? levelPrice < price : levelPrice > price)
+      break;
+    depth += level->getQuantity();
+  }
+  return depth;
+}
+
+TEST(OrderBook, MatchableQuantityFollowsBook)
+{
+  // 64 ticks around 100.00, prices spread past both edges (tree levels too)
+  OrderBook ob("SPY", 10000, 64);
+  std::mt19937_64 rng(5);
+  std::vector<Order> orders;
+  for (int step = 0; step < 4000; step++)
+  {
+    std::size_t op = rng() % 4;
+    if (op <= 1 || orders.empty())
+    {
+      Side::Side side = (rng() % 2) ? Side::Side::Buy : Side::Side::Sell;
+      Price price = 9900 + static_cast<Price>(rng() % 200);
+      orders.emplace_back("SPY", OrderType::OrderType::GoodTillCancel, side,
+                          price / 100.0, 1 + rng() % 20, "0_NUB");
+      ob.AddOrder(orders.back()); // may match (fills, partial fills)
+    }
+    else if (op == 2)
+    {
+      ob.CancelOrder(orders[rng() % orders.size()].getOrderID());
+    }
+    else
+    {
+      Order &order = orders[rng() % orders.size()];
+      if (order.getRemainingQuantity() > 1)
+      {
+        Order smaller = order;
+        smaller.setQuantity(order.getRemainingQuantity() - 1);
+        if (ob.canAmendInPlace(order.getOrderID(), smaller))
+        {
+          ob.ModifyOrder(order.getOrderID(), smaller);
+          order = smaller;
+        }
+      }
+    }
+
+    Price probe = 9880 + static_cast<Price>(rng() % 240);
+    ASSERT_EQ(ob.getMatchableQuantity(Side::Side::Buy, probe),
+              walkDepth(ob.getAskLevels(), probe, false));
+    ASSERT_EQ(ob.getMatchableQuantity(Side::Side::Sell, probe),
+              walkDepth(ob.getBidLevels(), probe, true));
+  }
+}
+
+TEST(OrderBook, LadderCursorsFollowCancel)
+{
+  // window centered on the first order (99.00 - 100.99)
+  OrderBook ob("SPY", 200);
+  OrderID best = addLimitOrder(ob, Side::Side::Buy, 100.00, 4);
+  addLimitOrder(ob, Side::Side::Buy, 99.50, 2);
+  OrderID worst = addLimitOrder(ob, Side::Side::Buy, 99.25, 1);
+  ASSERT_EQ(ob.getBidLevels().isCentered(), true);
+  ASSERT_EQ(ob.getBidLevels().getReferencePrice(), 10000);
+
+  ob.CancelOrder(best);
+  ASSERT_EQ(ob.getBidLevels().size(), 2);
+  ASSERT_EQ(ob.getBidLevels().best()->getPrice(), 9950);
+
+  // better than the window, lives in tree but still wins the cursor
+  addLimitOrder(ob, Side::Side::Buy, 105.00, 3);
+  ASSERT_EQ(ob.getBidLevels().isDense(10500), false);
+  ASSERT_EQ(ob.getBidLevels().best()->getPrice(), 10500);
+
+  ob.CancelOrder(worst);
+  ASSERT_EQ(ob.getBidLevels().worst()->getPrice(), 9950);
+
+  // market sell priced at the worst bid, sweeps the best (tree) level first
+  Order market("SPY", OrderType::OrderType::Market, Side::Side::Sell, 0, 3,
+               "1_NUB");
+  ob.AddOrder(market);
+  ASSERT_EQ(ob.getTrades().size(), 1);
+  ASSERT_EQ(ob.getTrades().back().getMatchedBid().quantityFilled, 3);
+  ASSERT_EQ(ob.getBidLevels().best()->getPrice(), 9950);
+}
+
+TEST(OrderBook, LadderRecentersOnceSideEmpties)
+{
+  OrderBook ob("SPY", 200);
+  // a market buy on an empty book rests unpriced: not a reference
+  Order market("SPY", OrderType::OrderType::Market, Side::Side::Buy, 0, 1,
+               "1_NUB");
+  ob.AddOrder(market);
+  ASSERT_EQ(ob.getBidLevels().isCentered(), false);
+  ob.CancelOrder(market.getOrderID());
+
+  OrderID first = addLimitOrder(ob, Side::Side::Buy, 100.00, 4);
+  ASSERT_EQ(ob.getBidLevels().getReferencePrice(), 10000);
+  ob.CancelOrder(first);
+
+  // the price moved away while the side was empty: window follows it
+  OrderID moved = addLimitOrder(ob, Side::Side::Buy, 150.00, 2);
+  ASSERT_EQ(ob.getBidLevels().getReferencePrice(), 15000);
+  ASSERT_EQ(ob.getBidLevels().isDense(15000), true);
+  // while it holds levels the window stays put (far prices in the tree)
+  addLimitOrder(ob, Side::Side::Buy, 200.00, 1);
+  ASSERT_EQ(ob.getBidLevels().getReferencePrice(), 15000);
+  ASSERT_EQ(ob.getBidLevels().isDense(20000), false);
+  ob.CancelOrder(moved);
+  ASSERT_EQ(ob.getBidLevels().best()->getPrice(), 20000);
+  ASSERT_EQ(ob.getMatchableQuantity(Side::Side::Sell, 15000), 1);
+}
+
+TEST(OrderBook, SweepUncrossesBookInOneCall)
+{
+  OrderBook ob("SPY", 10000, 64);
+  addLimitOrder(ob, Side::Side::Sell, 100.01, 2);
+  addLimitOrder(ob, Side::Side::Sell, 100.02, 3);
+  addLimitOrder(ob, Side::Side::Sell, 100.03, 4);
+
+  // crosses two levels, leftover rests at its limit
+  Order aggressor("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Buy,
+                  100.02, 6, "1_NUB");
+  TradeBatch fills = ob.AddOrder(aggressor);
+  ASSERT_EQ(fills.size(), 2);
+  ASSERT_EQ(fills[0].getMatchedAsk().quantityFilled, 2);
+  ASSERT_EQ(fills[0].getMatchedAsk().price, 100.01);
+  ASSERT_EQ(fills[1].getMatchedAsk().quantityFilled, 3);
+  ASSERT_EQ(fills[1].getMatchedAsk().price, 100.02);
+  ASSERT_EQ(ob.getTrades().size(), 2);
+
+  // neither locked nor crossed after the call
+  ASSERT_LT(ob.getBidLevels().best()->getPrice(),
+            ob.getAskLevels().best()->getPrice());
+  ASSERT_EQ(ob.getBidLevels().best()->getQuantity(), 1);
+
+  // passive order produces an empty batch
+  Order passive("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Sell,
+                100.10, 1, "1_NUB");
+  ASSERT_EQ(ob.AddOrder(passive).empty(), true);
+}
+
+TEST(OrderBook, LevelViewDoesNotCopy)
+{
+  OrderBook ob("SPY", 10000, 64);
+  addLimitOrder(ob, Side::Side::Buy, 99.90, 5);
+  const LevelPointer level = ob.getLevelFromSideAndPrice(Side::Side::Buy, 9990);
+  const OrderRecord *front = &level->front();
+
+  Quantity seen = 0;
+  std::size_t allocations = countAllocations([&]() {
+    for (const OrderRecord &record : *level)
+      seen += record.remQuantity;
+    seen += level->getOrderCount();
+  });
+  ASSERT_EQ(allocations, 0);
+  ASSERT_EQ(seen, 5 + 1);
+  ASSERT_EQ(&*level->begin(), front); // viewed inside its pool slot
+  ASSERT_EQ(ob.getParticipantNames().name(front->participant), "0_NUB");
+}
+
+TEST(OrderBook, PoolRecyclesSlotsAndLevels)
+{
+  OrderBook ob("SPY", 10000, 64);
+  Order order("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Sell,
+              100.10, 7, "0_NUB");
+  ob.AddOrder(order);
+  const LevelPointer level = ob.getLevelFromSideAndPrice(Side::Side::Sell, 10010);
+  const OrderRecord *slot = &level->front();
+  ob.CancelOrder(order.getOrderID());
+  ASSERT_EQ(ob.getOrderPool().getLiveCount(), 0);
+
+  const std::size_t cycles = 100;
+  std::size_t allocations = countAllocations([&]() {
+    for (std::size_t i = 0; i < cycles; i++)
+    {
+      ob.AddOrder(order);
+      ob.CancelOrder(order.getOrderID());
+    }
+  });
+  ob.AddOrder(order);
+
+  // same level object & same slot handed back, no slab carved
+  ASSERT_EQ(ob.getLevelFromSideAndPrice(Side::Side::Sell, 10010), level);
+  ASSERT_EQ(&level->front(), slot);
+  ASSERT_EQ(ob.getOrderPool().getLiveCount(), 1);
+  ASSERT_EQ(ob.getOrderPool().getCapacity(), OrderPool::SlabSize);
+  ASSERT_EQ(allocations, 0);
+}
+
+TEST(OrderBook, OrderIndexMatchesReferenceMap)
+{
+  OrderIndex index(4); // small table: forces growth & long probe runs
+  std::unordered_map<OrderID, SlotIndex> reference;
+  std::mt19937_64 rng(11);
+  for (SlotIndex step = 0; step < 20000; step++)
+  {
+    OrderID orderID = rng() % 512; // dense ids, lots of collisions & reuse
+    if (rng() % 3 == 0)
+    {
+      ASSERT_EQ(index.erase(orderID), reference.erase(orderID) == 1);
+    }
+    else
+    {
+      ASSERT_EQ(index.insert(orderID, nullptr, step),
+                reference.emplace(orderID, step).second);
+    }
+  }
+  ASSERT_EQ(index.size(), reference.size());
+  for (OrderID orderID = 0; orderID < 512; orderID++)
+  {
+    const OrderIndex::Entry *entry = index.find(orderID);
+    auto it = reference.find(orderID);
+    ASSERT_EQ(entry != nullptr, it != reference.end());
+    if (entry != nullptr)
+    {
+      ASSERT_EQ(entry->slot, it->second);
+    }
+  }
+}
+
+TEST(OrderBook, CancelAllForParticipant)
+{
+  OrderBook ob("SPY", 10000, 64);
+  std::vector<Order> orders = {
+      Order("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Buy,
+            99.90, 3, "0_MM"),
+      Order("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Buy,
+            99.80, 4, "1_NUB"),
+      Order("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Sell,
+            100.10, 5, "0_MM"),
+      Order("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Sell,
+            100.40, 6, "0_MM")};
+  for (Order &order : orders)
+    ob.AddOrder(order);
+
+  ob.CancelOrder(orders[2].getOrderID()); // middle of the chain
+  ASSERT_EQ(ob.CancelAllForParticipant("0_MM"), 2);
+  ASSERT_EQ(ob.CancelAllForParticipant("0_MM"), 0);
+  ASSERT_EQ(ob.CancelAllForParticipant("2_NONE"), 0);
+
+  // other participant untouched, emptied levels gone
+  ASSERT_EQ(ob.getOrderPool().getLiveCount(), 1);
+  ASSERT_EQ(ob.isResting(orders[1].getOrderID()), true);
+  ASSERT_EQ(ob.isResting(orders[0].getOrderID()), false);
+  ASSERT_EQ(ob.getBidLevels().size(), 1);
+  ASSERT_EQ(ob.getAskLevels().empty(), true);
+
+  // chain is rebuilt on the next order
+  ob.AddOrder(orders[3]);
+  ASSERT_EQ(ob.CancelAllForParticipant("0_MM"), 1);
+}
+
+TEST(OrderBook, AmendDownKeepsSlot)
+{
+  OrderBook ob("SPY", 10000, 64);
+  addLimitOrder(ob, Side::Side::Buy, 100.00, 5);
+  Order resting("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Sell,
+                100.10, 10, "0_MM");
+  ob.AddOrder(resting);
+  const LevelPointer level = ob.getLevelFromSideAndPrice(Side::Side::Sell, 10010);
+  const OrderRecord *slot = &level->front();
+
+  // size down: rewritten in its slot, nothing allocated, nothing matched
+  Order smaller("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Sell,
+                100.10, 4, "0_MM");
+  ASSERT_EQ(ob.canAmendInPlace(resting.getOrderID(), smaller), true);
+  TradeBatch fills;
+  std::size_t allocations = countAllocations(
+      [&]() { fills = ob.ModifyOrder(resting.getOrderID(), smaller); });
+  ASSERT_EQ(allocations, 0);
+  ASSERT_EQ(fills.empty(), true);
+  ASSERT_EQ(level->getQuantity(), 4);
+  ASSERT_EQ(&level->front(), slot);
+  ASSERT_EQ(slot->remQuantity, 4);
+
+  // size up is cancel/replace (loses priority)
+  Order bigger("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Sell,
+               100.10, 8, "0_MM");
+  ASSERT_EQ(ob.canAmendInPlace(smaller.getOrderID(), bigger), false);
+  ob.ModifyOrder(smaller.getOrderID(), bigger);
+  ASSERT_EQ(ob.getLevelFromSideAndPrice(Side::Side::Sell, 10010)->getQuantity(),
+            8);
+
+  // price change is cancel/replace & may cross
+  Order crossing("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Sell,
+                 100.00, 8, "0_MM");
+  ASSERT_EQ(ob.canAmendInPlace(bigger.getOrderID(), crossing), false);
+  fills = ob.ModifyOrder(bigger.getOrderID(), crossing);
+  ASSERT_EQ(fills.size(), 1);
+  ASSERT_EQ(fills[0].getMatchedAsk().quantityFilled, 5);
+  ASSERT_EQ(ob.getAskLevels().size(), 1);
+  ASSERT_EQ(ob.getAskLevels().best()->getQuantity(), 3);
+}
+
+// 50 resting asks (one per level) & trade storage reserved
+void fillDeepAskBook(OrderBook &ob)
+{
+  for (int tick = 1; tick <= 50; tick++)
+    addLimitOrder(ob, Side::Side::Sell, (10000 + tick) / 100.0, 1);
+  ob.reserveTrades(64);
+}
+
+TEST(OrderBook, MatchPathDoesNotAllocate)
+{
+  OrderBook shallow("SPY", 10000, 128);
+  OrderBook deep("SPY", 10000, 128);
+  fillDeepAskBook(shallow);
+  fillDeepAskBook(deep);
+  Order takeOne("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Buy,
+                100.01, 1, "1_NUB");
+  Order takeAll("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Buy,
+                100.50, 50, "1_NUB");
+
+  std::size_t oneFill = countAllocations([&]() { shallow.AddOrder(takeOne); });
+  std::size_t fiftyFills = countAllocations([&]() { deep.AddOrder(takeAll); });
+
+  ASSERT_EQ(shallow.getTrades().size(), 1);
+  ASSERT_EQ(deep.getTrades().size(), 50);
+  // resting the aggressor allocates, the sweep itself does not (per fill)
+  ASSERT_GT(oneFill, 0);
+  ASSERT_EQ(fiftyFills, oneFill);
+}
+
+TEST(OrderBook, TradesSinceSequence)
+{
+  OrderBook ob("SPY", 10000, 128);
+  fillDeepAskBook(ob);
+  ASSERT_EQ(ob.getTradeSequence(), 0);
+
+  Order first("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Buy,
+              100.02, 2, "1_NUB");
+  ob.AddOrder(first);
+  TradeSequence cursor = ob.getTradeSequence();
+  ASSERT_EQ(cursor, 2);
+
+  Order second("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Buy,
+               100.05, 3, "2_NUB");
+  ob.AddOrder(second);
+
+  // only the page appended after the cursor is handed out
+  TradeLog::Range page = ob.getTradesSince(cursor);
+  ASSERT_EQ(page.size(), 3);
+  ASSERT_EQ((*page.begin()).getMatchedAsk().price, 100.03);
+  ASSERT_EQ(page.begin().sequence(), cursor);
+  ASSERT_EQ(ob.getTradesSince(ob.getTradeSequence()).empty(), true);
+  ASSERT_EQ(ob.getTradesSince(1000).empty(), true);
+}
+
+TEST(OrderBook, TradeLogSpillsOldSegments)
+{
+  OrderBook ob("SPY", 10000, 128);
+  ob.setTradeLog(TradeLog(4, 2)); // 8 trades in memory at most
+  fillDeepAskBook(ob);
+  Order sweep("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Buy,
+              100.50, 50, "1_NUB");
+  ob.AddOrder(sweep);
+
+  const TradeLog &trades = ob.getTrades();
+  ASSERT_EQ(trades.size(), 50);
+  ASSERT_EQ(trades.firstResident(), 44); // 11 segments spilled
+  ASSERT_EQ(trades.isResident(43), false);
+  ASSERT_EQ(trades.back().getMatchedAsk().price, 100.50);
+
+  // one sequence space across disk & memory, in match order
+  TradeSequence expected = 0;
+  for (const Trade &trade : trades)
+  {
+    ASSERT_EQ(trade.getMatchedAsk().price, (10001 + expected) / 100.0);
+    expected++;
+  }
+  ASSERT_EQ(expected, 50);
+  Trades page(10);
+  ASSERT_EQ(trades.read(40, page), 10); // straddles the spill boundary
+  ASSERT_EQ(page.front().getMatchedAsk().price, 100.41);
+  ASSERT_EQ(page.back().getMatchedAsk().price, 100.50);
+  ASSERT_EQ(trades.at(0).getMatchedBid().quantityFilled, 1);
+  ASSERT_THROW(trades.at(50), std::out_of_range);
+}
+
+TEST(OrderBook, FailedSpillLeavesBookWhole)
+{
+  OrderBook ob("SPY", 10000, 128);
+  // one trade in memory, the spill file can't be opened
+  ob.setTradeLog(TradeLog(1, 1, "/nonexistent-dir/trades.spill"));
+  OrderID first = addLimitOrder(ob, Side::Side::Sell, 100.01, 1);
+  OrderID second = addLimitOrder(ob, Side::Side::Sell, 100.02, 1);
+  Order sweep("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Buy,
+              100.02, 2, "1_NUB");
+  ASSERT_THROW(ob.AddOrder(sweep), std::runtime_error);
+
+  // first fill complete, the second never started
+  ASSERT_EQ(ob.getTrades().size(), 1);
+  ASSERT_EQ(ob.isResting(first), false);
+  ASSERT_EQ(ob.isResting(second), true);
+  ASSERT_EQ(ob.getMatchableQuantity(Side::Side::Buy, 10002), 1);
+  ASSERT_EQ(ob.getMatchableQuantity(Side::Side::Sell, 10002), 1);
+}
+
+TEST(OrderBook, FillListenersSeeOwnSide)
+{
+  OrderBook ob("SPY", 10000, 128);
+  fillDeepAskBook(ob);
+  std::vector<OrderID> bidFills, askFills;
+  ob.setFillListener(Side::Side::Buy, [&](const OrderTraded &fill)
+                     { bidFills.push_back(fill.orderID); });
+  ob.setFillListener(Side::Side::Sell, [&](const OrderTraded &fill)
+                     { askFills.push_back(fill.orderID); });
+
+  Order sweep("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Buy,
+              100.05, 5, "1_NUB");
+  TradeBatch fills = ob.AddOrder(sweep);
+
+  // pushed per fill while matching, each side only its own order
+  ASSERT_EQ(bidFills.size(), fills.size());
+  ASSERT_EQ(askFills.size(), fills.size());
+  for (std::size_t i = 0; i < fills.size(); i++)
+  {
+    ASSERT_EQ(bidFills[i], sweep.getOrderID());
+    ASSERT_EQ(askFills[i], fills[i].getMatchedAsk().orderID);
+  }
+
+  // unsubscribed side hears nothing more
+  ob.setFillListener(Side::Side::Buy, nullptr);
+  Order more("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Buy,
+             100.10, 1, "2_NUB");
+  ob.AddOrder(more);
+  ASSERT_EQ(bidFills.size(), fills.size());
+  ASSERT_EQ(askFills.size(), fills.size() + 1);
+}
+
+TEST(OrderBook, FillsCarryInternedHandles)
+{
+  ASSERT_EQ(sizeof(OrderRecord), 64); // one cache line per resting order
+  ASSERT_EQ(std::is_trivially_copyable_v<Trade>, true);
+
+  // tables shared across books (as the exchange does): same handle per name
+  InternTablePointer symbols = std::make_shared<InternTable>();
+  InternTablePointer participants = std::make_shared<InternTable>();
+  OrderBook spy("SPY", 10000, 64, symbols, participants);
+  OrderBook qqq("QQQ", 10000, 64, symbols, participants);
+  ASSERT_NE(spy.getSymbolHandle(), qqq.getSymbolHandle());
+
+  Order ask("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Sell,
+            100.10, 3, "0_SELLER");
+  Order bid("SPY", OrderType::OrderType::GoodTillCancel, Side::Side::Buy,
+            100.10, 3, "1_BUYER");
+  spy.AddOrder(ask);
+  TradeBatch fills = spy.AddOrder(bid);
+  ASSERT_EQ(fills.size(), 1);
+
+  // names resolved only when asked for
+  ASSERT_EQ(symbols->name(fills[0].getSymbol()), "SPY");
+  ASSERT_EQ(participants->name(fills[0].getMatchedBid().participant),
+            "1_BUYER");
+  ASSERT_EQ(participants->name(fills[0].getMatchedAsk().participant),
+            "0_SELLER");
+
+  Order other("QQQ", OrderType::OrderType::GoodTillCancel, Side::Side::Sell,
+              100.10, 1, "1_BUYER");
+  qqq.AddOrder(other);
+  ASSERT_EQ(qqq.getLevelFromSideAndPrice(Side::Side::Sell, 10010)
+                ->front()
+                .participant,
+            fills[0].getMatchedBid().participant);
+  ASSERT_EQ(participants->size(), 2);
+}
+
+int main()
+{
+  testing::InitGoogleTest();
+  return RUN_ALL_TESTS();
+}
@@ -1,8 +1,13 @@
+#include "include/InternTable.hpp"
+#include "include/Order.hpp"
 #include "include/OrderTraded.hpp"
+#include "include/Participant.hpp"
 #include "include/Trade.hpp"
 #include "include/Xchange.hpp"
 #include "utils/alias/Fundamental.hpp"
 #include "utils/alias/ParticipantRel.hpp"
+#include "utils/enums/Actions.hpp"
+#include "utils/enums/OrderTypes.hpp"
 #include "utils/enums/Side.hpp"
 #include <gtest/gtest.h>
 #include <vector>
@@ -120,21 +125,36 @@ TEST(Participant, RecordExecutedTrades)
 {
   Xchange &xchange = Xchange::getInstance(3, 100);
   ParticipantID partId1 = xchange.addParticipant("ID1");
-  // mock functionality of xchange returning trades
-  std::vector<Trade> recentTrades = {
-      Trade(OrderTraded("SPY", 131221, 12.32, 4, partId1),
-            OrderTraded("SPY", 842393, 12.32, 4, "20_INIF")),
-      Trade(OrderTraded("APL", 1322421221, 4.97, 14, "23_NINIEV"),
-            OrderTraded("APL", 842393122442424, 4.97, 14, partId1)),
-      Trade(OrderTraded("PXL", 132242121221221, 15.68, 33, "2331_NINIEV"),
-            OrderTraded("PXL", 842393121212424, 15.68, 33, "13_IDA"))};
   const ParticipantPointer partPtr = xchange.getParticipantInfo(partId1);
-  partPtr->lastProcessedTradeIndex = 0;
-
-  // comment out in recordTrades while mocking
-  // if (m_orderComposition.count(matchedID) == 0)
-  //   return;
-  // Participant::updateOrderStatus(matchedID);
+  // orders the participant tracks, filled by the mocked trades below
+  const OrderID bought =
+      partPtr
+          ->recordNonCancelOrder(Actions::Actions::Add, "SPY",
+                                 OrderType::OrderType::GoodTillCancel,
+                                 Side::Side::Buy, 12.32, 4, partId1)
+          ->getOrderID();
+  const OrderID sold =
+      partPtr
+          ->recordNonCancelOrder(Actions::Actions::Add, "APL",
+                                 OrderType::OrderType::GoodTillCancel,
+                                 Side::Side::Sell, 4.97, 14, partId1)
+          ->getOrderID();
+  // mock functionality of xchange returning trades (fills carry handles)
+  InternTable &symbols = *xchange.getSymbolNames();
+  InternTable &parts = *xchange.getParticipantNames();
+  std::vector<Trade> recentTrades = {
+      Trade(OrderTraded(symbols.intern("SPY"), bought, 12.32, 4,
+                        parts.intern(partId1)),
+            OrderTraded(symbols.intern("SPY"), 842393, 12.32, 4,
+                        parts.intern("20_INIF"))),
+      Trade(OrderTraded(symbols.intern("APL"), 1322421221, 4.97, 14,
+                        parts.intern("23_NINIEV")),
+            OrderTraded(symbols.intern("APL"), sold, 4.97, 14,
+                        parts.intern(partId1))),
+      Trade(OrderTraded(symbols.intern("PXL"), 132242121221221, 15.68, 33,
+                        parts.intern("2331_NINIEV")),
+            OrderTraded(symbols.intern("PXL"), 842393121212424, 15.68, 33,
+                        parts.intern("13_IDA")))};
 
   partPtr->recordTrades(recentTrades);
 
@@ -148,10 +168,40 @@ TEST(Participant, RecordExecutedTrades)
   ASSERT_EQ(partPtr->getValuationOfSymbol("PXL"), 0);
   ASSERT_EQ(partPtr->getValuationOfSymbol("APL"), -14 * 4.97);
   ASSERT_NEAR(partPtr->getValuationOfPortfolio(), 4 * 12.32 - 14 * 4.97, 0.01);
-  ASSERT_EQ(partPtr->lastProcessedTradeIndex, partPtr->getNumberOfTrades());
+
+  // a self trade is not booked, a fill of an untracked order is history only
+  partPtr->recordTrades(
+      {Trade(OrderTraded(symbols.intern("MSF"), bought, 30.10, 2,
+                         parts.intern(partId1)),
+             OrderTraded(symbols.intern("MSF"), sold, 30.10, 2,
+                         parts.intern(partId1))),
+       Trade(OrderTraded(symbols.intern("MSF"), 131221, 30.10, 5,
+                         parts.intern(partId1)),
+             OrderTraded(symbols.intern("MSF"), 842394, 30.10, 5,
+                         parts.intern("20_INIF")))});
+  ASSERT_EQ(partPtr->getNumberOfTrades(), 3);
+  ASSERT_EQ(partPtr->isSymbolInPortfolio("MSF"), false);
+  ASSERT_NEAR(partPtr->getValuationOfPortfolio(), 4 * 12.32 - 14 * 4.97, 0.01);
   Xchange::destroyInstance();
 }
 
+TEST(Participant, StandaloneBooksTrades)
+{
+  // no exchange: no shared symbol names, no handle of its own
+  Participant participant;
+  const OrderID bought =
+      participant
+          .recordNonCancelOrder(Actions::Actions::Add, "SPY",
+                                OrderType::OrderType::GoodTillCancel,
+                                Side::Side::Buy, 12.32, 4, "ID1")
+          ->getOrderID();
+  participant.recordTrade(
+      Trade(OrderTraded(0, bought, 12.32, 4, InvalidHandle),
+            OrderTraded(0, 842393, 12.32, 4, 7)));
+  ASSERT_EQ(participant.getNumberOfTrades(), 1);
+  ASSERT_EQ(participant.getValuationOfSymbol("SPY"), 4 * 12.32);
+}
+
 void verifyAddOrderInformation(const ParticipantPointer &partPtr,
                                const OrderID &orderId, const Symbol &symbol,
                                const Side::Side &side,
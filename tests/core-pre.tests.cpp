@@ -1,13 +1,33 @@
+#include "include/Order.hpp"
+#include "include/OrderBook.hpp"
+#include "include/PendingQueue.hpp"
+#include "include/Preprocess.hpp"
+#include "include/SessionCalendar.hpp"
+#include "include/TimerWheel.hpp"
 #include "include/Xchange.hpp"
 #include "utils/alias/Fundamental.hpp"
+#include "utils/alias/OrderBookRel.hpp"
+#include "utils/alias/OrderRel.hpp"
 #include "utils/alias/PreProcessorRel.hpp"
+#include "utils/enums/OrderStatus.hpp"
 #include "utils/enums/OrderTypes.hpp"
 #include "utils/enums/Side.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
+#include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <unistd.h>
+#include <unordered_map>
+#include <vector>
 
 TEST(PreProcessor, SetUpCheck)
 {
@@ -43,6 +63,26 @@ TEST(PreProcessor, SetUpCheck)
     Xchange::destroyInstance();
 }
 
+TEST(PreProcessor, ShortConstructorsDelegate)
+{
+    OrderBookPointer book = std::make_shared<OrderBook>("SPY");
+    const PreProcessor defaults(book, true);
+    ASSERT_EQ(defaults.getMaxPendingOrdersThreshold(), 3);
+    ASSERT_EQ(defaults.getMaxPendingDuration().count(), 100);
+    ASSERT_EQ(defaults.getTimeZone(), "Asia/Kolkata");
+
+    const PreProcessor thresholds(book, false, 7, std::chrono::milliseconds(250));
+    ASSERT_EQ(thresholds.getMaxPendingOrdersThreshold(), 7);
+    ASSERT_EQ(thresholds.getMaxPendingDuration().count(), 250);
+    ASSERT_EQ(thresholds.getTimeZone(), "Asia/Kolkata");
+
+    const PreProcessor zoned(
+        book, true, "Europe/Paris",
+        TimeTuple{std::chrono::hours(8), std::chrono::hours(16) + std::chrono::minutes(30)});
+    ASSERT_EQ(zoned.getMaxPendingOrdersThreshold(), 3);
+    ASSERT_EQ(zoned.getTimeZone(), "Europe/Paris");
+}
+
 // Insertion into / Removal from PreProcessor verified during Xchange testing
 // for Order Addition, Cancellation and Modification
 
@@ -188,6 +228,194 @@ TEST(PreProcessor, MarketOnOpenAttributesUpdated)
     Xchange::destroyInstance();
 }
 
+TEST(PreProcessor, TimerWheelFiresExactlyDue)
+{
+    using namespace std::chrono;
+    const TimeStamp origin = system_clock::from_time_t(1750000000);
+    TimerWheel wheel(origin);
+    std::mt19937_64 rng(7);
+
+    // spread over every level & past the horizon (~49 days at 1 ms)
+    std::unordered_map<OrderID, TimeStamp> pending;
+    std::vector<TimerWheel::TimerHandle> handles;
+    for (OrderID id = 0; id < 4000; id++)
+    {
+        milliseconds offset{rng() % (1ull << (8 + 6 * (id % 5)))};
+        TimeStamp due = origin + offset + microseconds(rng() % 1000);
+        handles.push_back(
+            wheel.schedule(due, id, TimerWheel::TimerKind::Expire));
+        pending[id] = due;
+    }
+    // cancelled ones never fire
+    for (OrderID id = 0; id < 4000; id += 7)
+    {
+        wheel.cancel(handles[id]);
+        pending.erase(id);
+    }
+
+    std::vector<TimerWheel::Timer> due;
+    TimeStamp now = origin;
+    while (!pending.empty())
+    {
+        now += milliseconds(rng() % (1ull << (rng() % 34)));
+        due.clear();
+        wheel.advance(now, due);
+        for (const TimerWheel::Timer &timer : due)
+        {
+            ASSERT_EQ(pending.contains(timer.orderID), true);
+            ASSERT_LE(pending[timer.orderID], now); // never early
+            pending.erase(timer.orderID);
+        }
+        for (const auto &[id, when] : pending)
+            ASSERT_GT(when, now - milliseconds(1)); // never late by a tick
+    }
+    ASSERT_EQ(wheel.empty(), true);
+
+    // already due when scheduled: handed out on the next advance
+    wheel.schedule(origin, 1, TimerWheel::TimerKind::Activate);
+    due.clear();
+    wheel.advance(now, due);
+    ASSERT_EQ(due.size(), 1);
+    ASSERT_EQ(due[0].kind, TimerWheel::TimerKind::Activate);
+}
+
+TEST(PreProcessor, PendingQueueDrainsOnceInOrder)
+{
+    struct Pending
+    {
+        OrderID orderID;
+        bool operator<(const Pending &other) const
+        {
+            return orderID < other.orderID;
+        }
+    };
+    PendingQueue<Pending> queue;
+    std::vector<OrderID> ids(1000);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), std::mt19937_64(11));
+    for (OrderID id : ids)
+        ASSERT_EQ(queue.insert(Pending{id}), true);
+    ASSERT_EQ(queue.insert(Pending{ids[0]}), false); // one entry per order
+    for (OrderID id = 0; id < 1000; id += 3)
+        queue.erase(id);
+
+    // visitor drops a later order & queues a new one (mid flush cancel)
+    std::vector<OrderID> seen;
+    queue.drain([&](const Pending &pending)
+                {
+        seen.push_back(pending.orderID);
+        queue.drain([](const Pending &) { FAIL(); }); // nested: no-op
+        if (pending.orderID == 10)
+        {
+            queue.erase(500);
+            queue.insert(Pending{5000});
+        }
+        if (pending.orderID % 2 == 1)
+            queue.erase(pending.orderID); });
+    ASSERT_EQ(std::is_sorted(seen.begin(), seen.end()), true);
+    ASSERT_EQ(std::find(seen.begin(), seen.end(), 500), seen.end());
+    ASSERT_EQ(std::find(seen.begin(), seen.end(), 5000), seen.end());
+    ASSERT_EQ(seen.size(), 665u); // 666 live, 500 dropped before its turn
+
+    // survivors (even, not 500) merged with what came in meanwhile
+    seen.clear();
+    queue.drain([&](const Pending &pending)
+                { seen.push_back(pending.orderID); });
+    ASSERT_EQ(queue.size(), seen.size());
+    ASSERT_EQ(std::is_sorted(seen.begin(), seen.end()), true);
+    ASSERT_EQ(seen.back(), 5000u);
+    ASSERT_EQ(seen.size(), 333u);
+}
+
+TEST(PreProcessor, SessionCalendarSkipsWeekendsAndHolidays)
+{
+    using namespace std::chrono;
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "xchange-holidays.test").string();
+    {
+        std::ofstream file(path);
+        file << "# BSE\n\n2025-03-14 # Holi\n2025-03-18\n";
+    }
+    std::vector<SessionCalendar::Holiday> holidays =
+        SessionCalendar::loadHolidays(path);
+    ASSERT_EQ(holidays.size(), 2u);
+    {
+        std::ofstream file(path);
+        file << "2025-02-30\n";
+    }
+    ASSERT_THROW(SessionCalendar::loadHolidays(path), std::runtime_error);
+    std::filesystem::remove(path);
+
+    // thursday 13 march 2025, 4 sessions laid out: 13, 17, 19, 20 (friday
+    // 14 & tuesday 18 holidays), the rest computed when reached
+    const TimeTuple bse{hours(3) + minutes(45), hours(10)};
+    const sys_days thursday = 2025y / March / 13;
+    auto calendar = std::make_shared<const SessionCalendar>(
+        bse, holidays, thursday + hours(1), 4);
+    SessionCalendar::Cursor cursor(calendar);
+
+    ASSERT_EQ(cursor.isOpen(thursday + hours(3)), false);
+    ASSERT_EQ(cursor.nextOpen(thursday + hours(3)), thursday + hours(3) + minutes(45));
+    ASSERT_EQ(cursor.isOpen(thursday + hours(4)), true);
+    ASSERT_EQ(cursor.nextClose(thursday + hours(4)), thursday + hours(10));
+    // running session's open has passed: the next one's
+    const sys_days monday = 2025y / March / 17;
+    ASSERT_EQ(cursor.nextOpen(thursday + hours(4)), monday + hours(3) + minutes(45));
+    ASSERT_EQ(cursor.isOpen(thursday + hours(10)), false);
+    ASSERT_EQ(cursor.isOpen(thursday + days(1) + hours(5)), false); // holiday
+    ASSERT_EQ(cursor.isOpen(thursday + days(2) + hours(5)), false); // weekend
+    ASSERT_EQ(cursor.nextClose(thursday + days(2)), monday + hours(10));
+    ASSERT_EQ(cursor.isOpen(monday + hours(5)), true);
+    ASSERT_EQ(cursor.isOpen(monday + days(1) + hours(5)), false); // holiday
+    ASSERT_EQ(cursor.isOpen(monday + days(2) + hours(5)), true);
+    // past the table: friday 21, monday 24
+    ASSERT_EQ(cursor.isOpen(monday + days(4) + hours(5)), true);
+    ASSERT_EQ(cursor.nextOpen(monday + days(4) + hours(11)),
+              monday + days(7) + hours(3) + minutes(45));
+}
+
+TEST(PreProcessor, TimedOrdersFollowWheel)
+{
+    Xchange &xchange = Xchange::getInstance(30, 1000000);
+    xchange.tradeNewSymbol("SPY");
+    const PreProcessorPointer preBid =
+        xchange.getPreProcessor("SPY", Side::Side::Buy);
+    const TimeStamp now = std::chrono::system_clock::now();
+
+    // GAT waits on the wheel (counted as buffered, not scanned) till active
+    OrderPointer gat = std::make_shared<Order>(
+        "SPY", OrderType::OrderType::GoodAfterTime, Side::Side::Buy, 120.10, 3,
+        "0_NUB");
+    gat->setActivationTime(now + std::chrono::milliseconds(30));
+    preBid->InsertAddOrderIntoPreprocessing(gat);
+    ASSERT_EQ(preBid->getBufferedOrderCount(), 1);
+    ASSERT_EQ(preBid->NumberOfOrdersBeingProcessed(
+                  OrderType::OrderType::GoodAfterTime),
+              0);
+    ASSERT_EQ(preBid->hasOrderEnteredOrderbook(
+                  gat->getOrderID(), OrderType::OrderType::GoodAfterTime),
+              false);
+
+    // GTD leaves preprocessing on its own once deactivated
+    OrderPointer gtd = std::make_shared<Order>(
+        "SPY", OrderType::OrderType::GoodTillDate, Side::Side::Buy, 120.20, 2,
+        "0_NUB");
+    gtd->setDeactivationTime(now + std::chrono::milliseconds(30));
+    preBid->InsertAddOrderIntoPreprocessing(gtd);
+    ASSERT_EQ(preBid->getPendingTimerCount(), 2);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    preBid->AdvanceTimers();
+    ASSERT_EQ(preBid->getPendingTimerCount(), 0);
+    ASSERT_EQ(preBid->NumberOfOrdersBeingProcessed(
+                  OrderType::OrderType::GoodAfterTime),
+              1);
+    ASSERT_EQ(preBid->getOrder(gtd->getOrderID()), nullptr);
+    ASSERT_EQ(gtd->getOrderStatus(), OrderStatus::OrderStatus::Cancelled);
+    ASSERT_EQ(preBid->getBufferedOrderCount(), 1);
+    Xchange::destroyInstance();
+}
+
 // //
 // TEST(PreProcessor, AreOrdersRanked) {
 //   Xchange &xchange = Xchange::getInstance(9, 1000);
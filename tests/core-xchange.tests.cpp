@@ -1,18 +1,33 @@
+#include "include/Clock.hpp"
+#include "include/Journal.hpp"
 #include "include/Order.hpp"
+#include "include/OrderEntry.hpp"
+#include "include/OrderRequest.hpp"
 #include "include/Preprocess.hpp"
+#include "include/Shard.hpp"
 #include "include/Xchange.hpp"
+#include "utils/Constants.hpp"
 #include "utils/alias/Fundamental.hpp"
 #include "utils/alias/OrderRel.hpp"
 #include "utils/alias/ParticipantRel.hpp"
 #include "utils/alias/PreProcessorRel.hpp"
 #include "utils/enums/Actions.hpp"
+#include "utils/enums/OrderStatus.hpp"
 #include "utils/enums/OrderTypes.hpp"
 #include "utils/enums/Side.hpp"
 #include <chrono>
 #include <ctime>
+#include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 TEST(Xchange, SetUpCheck)
 {
@@ -96,6 +111,346 @@ TEST(Xchange, RetireOldSymbol)
   Xchange::destroyInstance();
 }
 
+TEST(Xchange, HandlesIndexSameEntities)
+{
+  Xchange &xchange = Xchange::getInstance(30, 1000000);
+  ParticipantHandle part = xchange.registerParticipant("ID1");
+  ParticipantID partId = xchange.getParticipantNames()->name(part);
+  ASSERT_EQ(xchange.addParticipant("ID1"), partId); // same participant
+  ASSERT_EQ(xchange.findParticipant(partId), part);
+  ASSERT_EQ(xchange.getParticipantInfo(part), xchange.getParticipantInfo(partId));
+  ASSERT_EQ(xchange.getParticipantInfo(part)->getParticipantHandle(), part);
+
+  SymbolHandle spy = xchange.tradeNewSymbol("SPY");
+  ASSERT_EQ(xchange.tradeNewSymbol("SPY"), spy);
+  ASSERT_EQ(xchange.getOrderBook(spy), xchange.getOrderBook("SPY"));
+  ASSERT_EQ(xchange.getOrderBook(spy)->getSymbolHandle(), spy);
+
+  std::optional<OrderID> orderId = xchange.placeOrder(
+      part, Actions::Actions::Add, std::nullopt, spy, Side::Side::Buy,
+      OrderType::OrderType::GoodTillCancel, 124.32, 4, "NOW", "EOT");
+  ASSERT_EQ(orderId.has_value(), true);
+  ASSERT_EQ(xchange.getParticipantInfo(partId)->isParticularOrderPlacedByParticipant(
+                orderId.value()),
+            true);
+
+  // stale handles resolve to nothing, names come back w the same handle
+  xchange.retireOldSymbol("SPY");
+  ASSERT_EQ(xchange.findSymbol("SPY"), InvalidHandle);
+  ASSERT_EQ(xchange.getOrderBook(spy), nullptr);
+  ASSERT_EQ(xchange.placeOrder(part, Actions::Actions::Add, std::nullopt, spy,
+                               Side::Side::Buy,
+                               OrderType::OrderType::GoodTillCancel, 124.32, 4,
+                               "NOW", "EOT")
+                .has_value(),
+            false);
+  ASSERT_EQ(xchange.tradeNewSymbol("SPY"), spy);
+  xchange.removeParticipant(partId);
+  ASSERT_EQ(xchange.getParticipantInfo(part), nullptr);
+  Xchange::destroyInstance();
+}
+
+TEST(Xchange, TradesReachBothParticipants)
+{
+  Xchange &xchange = Xchange::getInstance(30, 1000000);
+  ParticipantPointer buyer =
+      xchange.getParticipantInfo(xchange.registerParticipant("ID1"));
+  ParticipantPointer seller =
+      xchange.getParticipantInfo(xchange.registerParticipant("ID2"));
+  ParticipantPointer bystander =
+      xchange.getParticipantInfo(xchange.registerParticipant("ID3"));
+  OrderBookPointer ob = xchange.getOrderBook(xchange.tradeNewSymbol("SPY"));
+
+  // straight into the book: the match itself drives attribution
+  OrderPointer ask = seller->recordNonCancelOrder(
+      Actions::Actions::Add, "SPY", OrderType::OrderType::GoodTillCancel,
+      Side::Side::Sell, 10.00, 5, seller->getParticipantID());
+  OrderPointer bid = buyer->recordNonCancelOrder(
+      Actions::Actions::Add, "SPY", OrderType::OrderType::GoodTillCancel,
+      Side::Side::Buy, 10.00, 3, buyer->getParticipantID());
+  ob->AddOrder(*ask);
+  ob->AddOrder(*bid);
+
+  ASSERT_EQ(buyer->getNumberOfTrades(), 1);
+  ASSERT_EQ(seller->getNumberOfTrades(), 1);
+  ASSERT_EQ(bystander->getNumberOfTrades(), 0);
+  ASSERT_EQ(buyer->getValuationOfSymbol("SPY"), 3 * 10.00);
+  ASSERT_EQ(seller->getValuationOfSymbol("SPY"), -3 * 10.00);
+
+  // removed participants are skipped, the rest still hear of their fills
+  xchange.removeParticipant(buyer->getParticipantID());
+  OrderPointer late = buyer->recordNonCancelOrder(
+      Actions::Actions::Add, "SPY", OrderType::OrderType::GoodTillCancel,
+      Side::Side::Buy, 10.00, 2, buyer->getParticipantID());
+  ob->AddOrder(*late);
+  ASSERT_EQ(buyer->getNumberOfTrades(), 1);
+  ASSERT_EQ(seller->getNumberOfTrades(), 2);
+  ASSERT_EQ(seller->getValuationOfSymbol("SPY"), -5 * 10.00);
+  Xchange::destroyInstance();
+
+  // books handed out outlive the exchange without calling back into it
+  ob->AddOrder(*late);
+  ASSERT_EQ(ob->AddOrder(*ask).size(), 1);
+  ASSERT_EQ(seller->getNumberOfTrades(), 2);
+}
+
+TEST(Xchange, JournalReplayRebuildsState)
+{
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "xchange-journal.test").string();
+  std::filesystem::remove(path);
+
+  Xchange &live = Xchange::getInstance(30, 1000000);
+  live.startJournal(path, JournalOptions{4, std::chrono::microseconds(1000000)});
+  ParticipantID partId1 = live.addParticipant("ID1");
+  ParticipantID partId2 = live.addParticipant("ID2");
+  live.tradeNewSymbol("SPY");
+  live.tradeNewSymbol("APL");
+  live.retireOldSymbol("APL");
+  std::optional<OrderID> bid = live.placeOrder(
+      partId1, Actions::Actions::Add, std::nullopt, "SPY", Side::Side::Buy,
+      OrderType::OrderType::Market, 124.32, 4, "01-07-2025 19:12:27", "");
+  live.placeOrder(partId2, Actions::Actions::Add, std::nullopt, "SPY",
+                  Side::Side::Sell, OrderType::OrderType::AllOrNone, 130.00, 43,
+                  "09-07-2025 19:12:27", "");
+  live.placeOrder(partId1, Actions::Actions::Cancel, bid.value(), "SPY",
+                  Side::Side::Buy, OrderType::OrderType::Market, std::nullopt,
+                  std::nullopt, std::nullopt, std::nullopt);
+  ASSERT_EQ(live.getJournal()->getLastSequence(), 8);
+  ASSERT_EQ(live.getJournal()->getCommittedSequence(), 8); // 2 groups of 4
+
+  std::size_t orders1 = live.getParticipantInfo(partId1)->getNumberOfOrdersPlaced();
+  std::size_t orders2 = live.getParticipantInfo(partId2)->getNumberOfOrdersPlaced();
+  std::size_t buffered =
+      live.getPreProcessor("SPY", Side::Side::Sell)->getBufferedOrderCount();
+  Xchange::destroyInstance(); // commits the tail
+
+  { // crash mid write: half a header at the end
+    std::ofstream torn(path, std::ios::binary | std::ios::app);
+    torn.write("\x20\x00\x00\x00\x04", 5);
+  }
+
+  Xchange &rebuilt = Xchange::getInstance(30, 1000000);
+  ASSERT_EQ(rebuilt.replayJournal(path), 8);
+  ASSERT_EQ(rebuilt.getParticipantCount(), 2);
+  ASSERT_EQ(rebuilt.isSymbolTraded("SPY"), true);
+  ASSERT_EQ(rebuilt.isSymbolTraded("APL"), false);
+  ASSERT_EQ(rebuilt.getParticipantInfo(partId1)->getNumberOfOrdersPlaced(), orders1);
+  ASSERT_EQ(rebuilt.getParticipantInfo(partId2)->getNumberOfOrdersPlaced(), orders2);
+  ASSERT_EQ(rebuilt.getPreProcessor("SPY", Side::Side::Sell)->getBufferedOrderCount(),
+            buffered);
+
+  // reopened: torn tail cut, sequences carry on
+  rebuilt.startJournal(path);
+  ASSERT_EQ(rebuilt.getJournal()->getLastSequence(), 8);
+  rebuilt.addParticipant("ID3");
+  rebuilt.stopJournal();
+  ASSERT_EQ(Journal::replay(path, [](const Journal::Event &) {}), 9);
+  Xchange::destroyInstance();
+  std::filesystem::remove(path);
+}
+
+TEST(Xchange, JournalReplaysOnJournalTime)
+{
+  using namespace std::chrono;
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "xchange-time.test").string();
+  std::filesystem::remove(path);
+  const TimeStamp start = sys_days{2025y / July / 21} + hours(4) + minutes(15);
+
+  Clock::install(std::make_shared<SimulatedClock>(start));
+  Xchange &live = Xchange::getInstance(30, 1000000);
+  live.startJournal(path);
+  ParticipantID partId1 = live.addParticipant("ID1");
+  live.tradeNewSymbol("SPY");
+  std::optional<OrderID> orderId = live.placeOrder(
+      partId1, Actions::Actions::Add, std::nullopt, "SPY", Side::Side::Buy,
+      OrderType::OrderType::GoodTillCancel, 124.25, 4, "", "");
+  const TimeStamp placedAt =
+      live.getParticipantInfo(partId1)->getOrder(orderId.value())->getOrderTime();
+  ASSERT_EQ(placedAt, start);
+  Xchange::destroyInstance();
+  Clock::install(nullptr);
+
+  // wall clock installed: replay still runs on the journaled times
+  Xchange &rebuilt = Xchange::getInstance(30, 1000000);
+  ASSERT_EQ(rebuilt.replayJournal(path), 3);
+  ASSERT_EQ(rebuilt.getParticipantInfo(partId1)->getOrder(orderId.value())->getOrderTime(),
+            placedAt);
+  ASSERT_EQ(Clock::installed(), nullptr); // and is back afterwards
+  ASSERT_GT(Clock::now(), start + hours(24));
+  Xchange::destroyInstance();
+  std::filesystem::remove(path);
+}
+
+TEST(Xchange, QuietJournalCommitsOnInterval)
+{
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "xchange-quiet.test").string();
+  std::filesystem::remove(path);
+
+  Xchange &xchange = Xchange::getInstance(30, 1000000);
+  xchange.startJournal(path, JournalOptions{1024, std::chrono::milliseconds(5)});
+  xchange.addParticipant("ID1");
+  ASSERT_EQ(xchange.getJournal()->getLastSequence(), 1);
+
+  // nothing else arrives: the flusher commits once the interval is up
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (xchange.getJournal()->getCommittedSequence() < 1 &&
+         std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  ASSERT_EQ(xchange.getJournal()->getCommittedSequence(), 1);
+  ASSERT_EQ(Journal::replay(path, [](const Journal::Event &) {}), 1);
+  Xchange::destroyInstance();
+  std::filesystem::remove(path);
+}
+
+TEST(Xchange, JournalRollsBackToLastCommit)
+{
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "xchange-rollback.test").string();
+  std::filesystem::remove(path);
+
+  {
+    Journal journal(path, JournalOptions{1024, std::chrono::seconds(60)});
+    journal.appendName(Journal::EventType::TradeSymbol, "SPY");
+    journal.commit();
+    journal.appendName(Journal::EventType::TradeSymbol, "APL");
+    journal.appendName(Journal::EventType::RetireSymbol, "APL");
+    ASSERT_EQ(journal.getLastSequence(), 3);
+
+    // the two uncommitted ones go, sequences carry on after the commit
+    journal.rollback();
+    ASSERT_EQ(journal.getLastSequence(), 1);
+    ASSERT_EQ(journal.appendName(Journal::EventType::TradeSymbol, "MSF"), 2);
+  } // commits the tail
+
+  std::vector<std::string> names;
+  ASSERT_EQ(Journal::replay(path, [&names](const Journal::Event &event)
+                            { names.push_back(event.name); }),
+            2);
+  ASSERT_EQ(names, (std::vector<std::string>{"SPY", "MSF"}));
+  std::filesystem::remove(path);
+}
+
+TEST(Xchange, JournalStopsAtCorruptRecord)
+{
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "xchange-corrupt.test").string();
+  std::filesystem::remove(path);
+
+  {
+    Journal journal(path);
+    journal.appendName(Journal::EventType::TradeSymbol, "SPY");
+    journal.appendName(Journal::EventType::TradeSymbol, "APL");
+    journal.appendName(Journal::EventType::TradeSymbol, "MSF");
+  } // commits the tail
+
+  { // garbage in the last payload: length & sequence still look right
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(-1, std::ios::end);
+    file.put('X');
+  }
+
+  std::vector<std::string> names;
+  ASSERT_EQ(Journal::replay(path, [&names](const Journal::Event &event)
+                            { names.push_back(event.name); }),
+            2);
+  ASSERT_EQ(names, (std::vector<std::string>{"SPY", "APL"}));
+
+  { // reopened: cut at the last verified event, appends carry on after it
+    Journal journal(path);
+    ASSERT_EQ(journal.getLastSequence(), 2);
+    ASSERT_EQ(journal.appendName(Journal::EventType::TradeSymbol, "PXL"), 3);
+  }
+  names.clear();
+  ASSERT_EQ(Journal::replay(path, [&names](const Journal::Event &event)
+                            { names.push_back(event.name); }),
+            3);
+  ASSERT_EQ(names, (std::vector<std::string>{"SPY", "APL", "PXL"}));
+  std::filesystem::remove(path);
+}
+
+TEST(Xchange, SnapshotPlusJournalTailRestores)
+{
+  const std::filesystem::path dir = std::filesystem::temp_directory_path();
+  const std::string journal = (dir / "xchange-restore.journal").string();
+  const std::string snapshot = (dir / "xchange-restore.snapshot").string();
+  std::filesystem::remove(journal);
+  std::filesystem::remove(snapshot);
+
+  Xchange &live = Xchange::getInstance(30, 1000000);
+  live.startJournal(journal);
+  ParticipantHandle buyer = live.registerParticipant("ID1");
+  ParticipantHandle seller = live.registerParticipant("ID2");
+  live.registerParticipant("ID3");
+  live.removeParticipant(live.getParticipantNames()->name(2)); // gap in handles
+  SymbolHandle spy = live.tradeNewSymbol("SPY");
+  ParticipantPointer sellerInfo = live.getParticipantInfo(seller);
+  ParticipantPointer buyerInfo = live.getParticipantInfo(buyer);
+
+  // resting asks & one fill, straight through the book
+  OrderBookPointer ob = live.getOrderBook(spy);
+  for (double price : {10.25, 10.50, 10.75})
+    ob->AddOrder(*sellerInfo->recordNonCancelOrder(
+        Actions::Actions::Add, "SPY", OrderType::OrderType::GoodTillCancel,
+        Side::Side::Sell, price, 5, sellerInfo->getParticipantID()));
+  ob->AddOrder(*buyerInfo->recordNonCancelOrder(
+      Actions::Actions::Add, "SPY", OrderType::OrderType::GoodTillCancel,
+      Side::Side::Buy, 10.25, 2, buyerInfo->getParticipantID()));
+  // buffered in the preprocessor
+  live.placeOrder(buyer, Actions::Actions::Add, std::nullopt, spy,
+                  Side::Side::Buy, OrderType::OrderType::AllOrNone, 9.50, 7,
+                  "01-07-2025 19:12:27", "");
+  live.writeSnapshot(snapshot);
+  // journal tail after the snapshot
+  live.placeOrder(seller, Actions::Actions::Add, std::nullopt, spy,
+                  Side::Side::Sell, OrderType::OrderType::AllOrNone, 11.00, 3,
+                  "01-07-2025 19:12:27", "");
+  JournalSequence last = live.getJournal()->getLastSequence();
+  std::size_t buyerOrders = buyerInfo->getNumberOfOrdersPlaced();
+  std::size_t sellerOrders = sellerInfo->getNumberOfOrdersPlaced();
+  double buyerValue = buyerInfo->getValuationOfSymbol("SPY");
+  Quantity bestAsk = ob->getAskLevels().best()->getQuantity();
+  std::size_t bids = live.getPreProcessor("SPY", Side::Side::Buy)->getBufferedOrderCount();
+  std::size_t asks = live.getPreProcessor("SPY", Side::Side::Sell)->getBufferedOrderCount();
+  Xchange::destroyInstance();
+
+  Xchange &restored = Xchange::getInstance(30, 1000000);
+  ASSERT_EQ(restored.restore(snapshot, journal), last);
+  ASSERT_EQ(restored.getParticipantCount(), 2);
+  ASSERT_EQ(restored.getParticipantInfo(ParticipantHandle{2}), nullptr);
+  ASSERT_EQ(restored.findSymbol("SPY"), spy);
+  ParticipantPointer buyerBack = restored.getParticipantInfo(buyer);
+  ParticipantPointer sellerBack = restored.getParticipantInfo(seller);
+  ASSERT_EQ(buyerBack->getNumberOfOrdersPlaced(), buyerOrders);
+  ASSERT_EQ(sellerBack->getNumberOfOrdersPlaced(), sellerOrders);
+  ASSERT_EQ(buyerBack->getNumberOfTrades(), 1);
+  ASSERT_EQ(buyerBack->getValuationOfSymbol("SPY"), buyerValue);
+  ASSERT_EQ(restored.getParticipantIDFromGovID("ID1"), buyerBack->getParticipantID());
+
+  OrderBookPointer back = restored.getOrderBook(spy);
+  ASSERT_EQ(back->getAskLevels().size(), 3);
+  ASSERT_EQ(back->getAskLevels().best()->getQuantity(), bestAsk);
+  // the book's trade log comes back too, in sequence
+  ASSERT_EQ(back->getTradeSequence(), 1);
+  ASSERT_EQ(back->getTrades().at(0).getMatchedBid().quantityFilled, 2);
+  ASSERT_EQ(back->getTrades().at(0).getMatchedAsk().price, 10.25);
+  ASSERT_EQ(restored.getPreProcessor("SPY", Side::Side::Buy)->getBufferedOrderCount(), bids);
+  ASSERT_EQ(restored.getPreProcessor("SPY", Side::Side::Sell)->getBufferedOrderCount(), asks);
+
+  // restored book keeps matching, fills reach the restored participants
+  OrderPointer take = buyerBack->recordNonCancelOrder(
+      Actions::Actions::Add, "SPY", OrderType::OrderType::GoodTillCancel,
+      Side::Side::Buy, 10.25, 3, buyerBack->getParticipantID());
+  ASSERT_EQ(back->AddOrder(*take).size(), 1);
+  ASSERT_EQ(back->getTradeSequence(), 2);
+  ASSERT_EQ(sellerBack->getNumberOfTrades(), 2);
+  Xchange::destroyInstance();
+  std::filesystem::remove(journal);
+  std::filesystem::remove(snapshot);
+}
+
 void verifyAddOrderInformation(
     const ParticipantID &partId, const ParticipantPointer &partPtr,
     const PreProcessorPointer &relPre,
@@ -104,6 +459,433 @@ void verifyAddOrderInformation(
     const OrderType::OrderType &otype, const double &price, const Quantity &qty,
     const std::string &activationTime, const std::string &deactivationTime);
 
+TEST(Xchange, ShardedPlaceOrderReportsAsynchronously)
+{
+  Xchange &xchange = Xchange::getInstance(30, 1000000);
+  ParticipantID partId1 = xchange.addParticipant("ID1");
+  ParticipantID partId2 = xchange.addParticipant("ID2");
+  xchange.tradeNewSymbol("SPY");
+  xchange.tradeNewSymbol("APL");
+
+  std::mutex guard; // two shards report concurrently
+  std::vector<ExecutionReport> reports;
+  xchange.setExecutionListener([&](const ExecutionReport &report)
+                               {
+    std::lock_guard<std::mutex> lock(guard);
+    reports.push_back(report); });
+  xchange.startShards(2);
+  ASSERT_EQ(xchange.getShardCount(), 2);
+
+  // ids come back at once, before the shards ran anything
+  std::optional<OrderID> bid = xchange.placeOrder(
+      partId1, Actions::Actions::Add, std::nullopt, "SPY", Side::Side::Buy,
+      OrderType::OrderType::GoodTillCancel, 124.25, 4, "01-07-2025 19:12:27", "");
+  std::optional<OrderID> ask = xchange.placeOrder(
+      partId2, Actions::Actions::Add, std::nullopt, "APL", Side::Side::Sell,
+      OrderType::OrderType::GoodTillCancel, 130.50, 43, "09-07-2025 19:12:27", "");
+  ASSERT_EQ(bid.has_value(), true);
+  ASSERT_EQ(ask, bid.value() + 1); // one sequence, whatever the shard
+
+  // side can not change on modify: rejected on the shard, nothing thrown here
+  xchange.placeOrder(partId1, Actions::Actions::Modify, bid.value(), "SPY",
+                     Side::Side::Sell, OrderType::OrderType::GoodTillCancel,
+                     125.00, 4, "", "");
+  ASSERT_EQ(xchange.placeOrder(partId1, Actions::Actions::Cancel, bid.value(),
+                               "SPY", Side::Side::Buy,
+                               OrderType::OrderType::GoodTillCancel,
+                               std::nullopt, std::nullopt, std::nullopt,
+                               std::nullopt),
+            std::nullopt);
+  xchange.drainShards();
+
+  ASSERT_EQ(reports.size(), 4);
+  std::size_t rejected = 0;
+  for (const ExecutionReport &report : reports)
+  {
+    if (report.accepted)
+      continue;
+    rejected++;
+    ASSERT_EQ(report.action, Actions::Actions::Modify);
+    ASSERT_EQ(report.reason.empty(), false);
+  }
+  ASSERT_EQ(rejected, 1);
+  ASSERT_EQ(xchange.getPreProcessor("SPY", Side::Side::Buy)->getBufferedOrderCount(), 0);
+  ASSERT_EQ(xchange.getPreProcessor("APL", Side::Side::Sell)->getBufferedOrderCount(), 1);
+  ASSERT_EQ(xchange.getParticipantInfo(partId2)->getNumberOfOrdersPlaced(), 1);
+
+  xchange.stopShards();
+  ASSERT_EQ(xchange.getShardCount(), 0);
+  Xchange::destroyInstance();
+}
+
+TEST(Xchange, PipelinedPlaceOrderRunsStagesInOrder)
+{
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "xchange-pipeline.test").string();
+  std::filesystem::remove(path);
+
+  Xchange &xchange = Xchange::getInstance(30, 1000000);
+  xchange.startJournal(path, JournalOptions{1024, std::chrono::microseconds(1000000), false});
+  ParticipantID partId1 = xchange.addParticipant("ID1");
+  ParticipantID partId2 = xchange.addParticipant("ID2");
+  SymbolHandle spy = xchange.tradeNewSymbol("SPY");
+  ParticipantHandle part1 = xchange.findParticipant(partId1);
+
+  std::vector<ExecutionReport> reports; // publish stage only
+  xchange.setExecutionListener([&](const ExecutionReport &report)
+                               { reports.push_back(report); });
+  xchange.startPipeline(8); // wraps a few times below
+  ASSERT_EQ(xchange.isPipelined(), true);
+  ASSERT_THROW(xchange.startShards(2), std::logic_error);
+
+  std::vector<std::optional<OrderID>> ids;
+  for (int tick = 0; tick < 20; tick++)
+    ids.push_back(xchange.placeOrder(
+        part1, Actions::Actions::Add, std::nullopt, spy, Side::Side::Buy,
+        OrderType::OrderType::GoodTillCancel, 100.25 + tick, 4,
+        std::string("01-07-2025 19:12:27"), std::string("")));
+  // unknown symbol: only the validation stage finds out
+  xchange.placeOrder(part1, Actions::Actions::Add, std::nullopt, 99,
+                     Side::Side::Buy, OrderType::OrderType::GoodTillCancel,
+                     100.25, 4, std::string(""), std::string(""));
+  xchange.placeOrder(part1, Actions::Actions::Cancel, ids[0], spy,
+                     Side::Side::Buy, OrderType::OrderType::GoodTillCancel,
+                     std::nullopt, std::nullopt, std::nullopt, std::nullopt);
+  xchange.drainPipeline();
+
+  ASSERT_EQ(reports.size(), 22);
+  for (int tick = 0; tick < 20; tick++)
+  { // published in the order placed, with the ids handed out upfront
+    ASSERT_EQ(reports[tick].accepted, true);
+    ASSERT_EQ(reports[tick].orderID, ids[tick]);
+  }
+  ASSERT_EQ(reports[20].accepted, false);
+  ASSERT_EQ(reports[21].accepted, true);
+  ASSERT_EQ(reports[21].action, Actions::Actions::Cancel);
+  // 3 name events, then the 21 accepted requests (rejected one not logged)
+  ASSERT_EQ(xchange.getJournal()->getLastSequence(), 24);
+  ASSERT_EQ(xchange.getJournal()->getCommittedSequence(), 24);
+  ASSERT_EQ(xchange.getPreProcessor("SPY", Side::Side::Buy)->getBufferedOrderCount(), 19);
+  ASSERT_EQ(xchange.getParticipantInfo(partId2)->getNumberOfOrdersPlaced(), 0);
+
+  xchange.stopPipeline();
+  ASSERT_EQ(xchange.isPipelined(), false);
+  Xchange::destroyInstance();
+  std::filesystem::remove(path);
+}
+
+TEST(Xchange, OrderIdsNeverCollide)
+{
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "xchange-ids.test").string();
+  std::filesystem::remove(path);
+
+  Xchange &live = Xchange::getInstance(30, 1000000);
+  live.startJournal(path);
+  ParticipantID partId1 = live.addParticipant("ID1");
+  live.tradeNewSymbol("SPY");
+  // same price, side & instant: still two orders
+  std::optional<OrderID> first = live.placeOrder(
+      partId1, Actions::Actions::Add, std::nullopt, "SPY", Side::Side::Buy,
+      OrderType::OrderType::GoodTillCancel, 124.25, 4, "", "");
+  std::optional<OrderID> second = live.placeOrder(
+      partId1, Actions::Actions::Add, std::nullopt, "SPY", Side::Side::Buy,
+      OrderType::OrderType::GoodTillCancel, 124.25, 4, "", "");
+  ASSERT_EQ(second, first.value() + 1);
+  ASSERT_EQ(live.getPreProcessor("SPY", Side::Side::Buy)->getBufferedOrderCount(), 2);
+  Xchange::destroyInstance();
+
+  // replay hands out the journaled ids, later orders carry on after them
+  Xchange &rebuilt = Xchange::getInstance(30, 1000000);
+  rebuilt.replayJournal(path);
+  ParticipantPointer part = rebuilt.getParticipantInfo(partId1);
+  ASSERT_NE(part->getOrder(first.value()), nullptr);
+  ASSERT_NE(part->getOrder(second.value()), nullptr);
+  std::optional<OrderID> third = rebuilt.placeOrder(
+      partId1, Actions::Actions::Add, std::nullopt, "SPY", Side::Side::Buy,
+      OrderType::OrderType::GoodTillCancel, 124.25, 4, "", "");
+  ASSERT_GT(third.value(), second.value());
+  Xchange::destroyInstance();
+  std::filesystem::remove(path);
+}
+
+// dd-mm-yyyy hh:mm:ss local, as placeOrder takes it
+std::string localDateTime(TimeStamp time)
+{
+  std::time_t tt = std::chrono::system_clock::to_time_t(time);
+  std::tm local = *std::localtime(&tt);
+  char text[32];
+  std::strftime(text, sizeof(text), "%d-%m-%Y %H:%M:%S", &local);
+  return text;
+}
+
+TEST(Xchange, SimulatedClockRunsOnEventTime)
+{
+  using namespace std::chrono;
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "xchange-clock.test").string();
+  std::filesystem::remove(path);
+  // Monday, half an hour into the BSE session (03:45 GMT)
+  const TimeStamp start = sys_days{2025y / July / 21} + hours(4) + minutes(15);
+  auto clock = std::make_shared<SimulatedClock>(start);
+
+  Xchange &live = Xchange::getInstance(30, 1000); // 1 s pending duration
+  live.setClock(clock);
+  live.startJournal(path);
+  ParticipantID partId1 = live.addParticipant("ID1");
+  live.tradeNewSymbol("SPY");
+  OrderBookPointer ob = live.getOrderBook("SPY");
+  std::optional<OrderID> expiring = live.placeOrder(
+      partId1, Actions::Actions::Add, std::nullopt, "SPY", Side::Side::Buy,
+      OrderType::OrderType::GoodTillDate, 124.25, 4, "",
+      localDateTime(start + minutes(1)));
+  ASSERT_EQ(ob->isResting(expiring.value()), false); // buffered
+
+  clock->advance(seconds(2)); // pending duration up: next insert flushes
+  live.placeOrder(partId1, Actions::Actions::Add, std::nullopt, "SPY",
+                  Side::Side::Buy, OrderType::OrderType::GoodTillCancel, 124.00,
+                  4, "", "");
+  ASSERT_EQ(ob->isResting(expiring.value()), true);
+
+  clock->advance(minutes(2)); // past the deactivation time
+  live.placeOrder(partId1, Actions::Actions::Add, std::nullopt, "SPY",
+                  Side::Side::Buy, OrderType::OrderType::GoodTillCancel, 123.75,
+                  4, "", "");
+  ASSERT_EQ(ob->isResting(expiring.value()), false);
+  ASSERT_EQ(live.getParticipantInfo(partId1)->getOrder(expiring.value())->getOrderStatus(),
+            OrderStatus::OrderStatus::Cancelled);
+  const TimeStamp end = Clock::now();
+  ASSERT_THROW(live.setClock(std::make_shared<SimulatedClock>(start)),
+               std::logic_error); // backwards under a traded symbol
+  Xchange::destroyInstance();
+
+  // same minutes replayed at once, on the journaled times
+  Clock::install(std::make_shared<SimulatedClock>(start));
+  Xchange &rebuilt = Xchange::getInstance(30, 1000);
+  ASSERT_EQ(rebuilt.replayJournal(path), 5);
+  ASSERT_EQ(Clock::now(), end);
+  ASSERT_EQ(rebuilt.getOrderBook("SPY")->isResting(expiring.value()), false);
+  ASSERT_EQ(rebuilt.getParticipantInfo(partId1)->getOrder(expiring.value())->getOrderStatus(),
+            OrderStatus::OrderStatus::Cancelled);
+  Xchange::destroyInstance();
+  Clock::install(nullptr);
+  std::filesystem::remove(path);
+}
+
+TEST(Xchange, ClosedMarketHoldsInPlaceAmend)
+{
+  using namespace std::chrono;
+  const TimeStamp start = sys_days{2025y / July / 21} + hours(4) + minutes(15);
+  auto clock = std::make_shared<SimulatedClock>(start);
+  Xchange &xchange = Xchange::getInstance(30, 1000); // 1 s pending duration
+  xchange.setClock(clock);
+  ParticipantID partId1 = xchange.addParticipant("ID1");
+  xchange.tradeNewSymbol("SPY");
+  OrderBookPointer ob = xchange.getOrderBook("SPY");
+  std::optional<OrderID> resting = xchange.placeOrder(
+      partId1, Actions::Actions::Add, std::nullopt, "SPY", Side::Side::Buy,
+      OrderType::OrderType::GoodTillCancel, 124.25, 4, "", "");
+  clock->advance(seconds(2)); // pending duration up: next insert flushes
+  xchange.placeOrder(partId1, Actions::Actions::Add, std::nullopt, "SPY",
+                     Side::Side::Buy, OrderType::OrderType::GoodTillCancel,
+                     124.00, 4, "", "");
+  ASSERT_EQ(ob->isResting(resting.value()), true);
+
+  // after the close a size down can amend in place but must not reach the book
+  clock->set(sys_days{2025y / July / 21} + hours(10) + minutes(30));
+  std::optional<OrderID> amended = xchange.placeOrder(
+      partId1, Actions::Actions::Modify, resting, "SPY", Side::Side::Buy,
+      OrderType::OrderType::GoodTillCancel, 124.25, 2, "", "");
+  ASSERT_EQ(ob->isResting(amended.value()), false);
+  ASSERT_EQ(ob->getBidLevels().best()->getQuantity(), 4);
+  Xchange::destroyInstance();
+  Clock::install(nullptr);
+}
+
+TEST(Xchange, FlushSchedulerServesQuietSymbols)
+{
+  using namespace std::chrono;
+  const TimeStamp start = sys_days{2025y / July / 21} + hours(4) + minutes(15);
+  auto clock = std::make_shared<SimulatedClock>(start);
+  Xchange &xchange = Xchange::getInstance(30, 100); // 100 ms pending duration
+  xchange.setClock(clock);
+  ParticipantID partId1 = xchange.addParticipant("ID1");
+  xchange.tradeNewSymbol("SPY");
+  OrderBookPointer ob = xchange.getOrderBook("SPY");
+  PreProcessorPointer pre = xchange.getPreProcessor("SPY", Side::Side::Buy);
+
+  // nothing else ever arrives for SPY
+  std::optional<OrderID> orderId = xchange.placeOrder(
+      partId1, Actions::Actions::Add, std::nullopt, "SPY", Side::Side::Buy,
+      OrderType::OrderType::GoodTillDate, 124.25, 4, "",
+      localDateTime(start + minutes(1)));
+  OrderPointer order = xchange.getParticipantInfo(partId1)->getOrder(orderId.value());
+  // scheduler passes come on real 1 ms ticks, due is judged on the clock's
+  // time; stopped (joined) before the book is read
+  auto scheduledFor = [&xchange, &pre](milliseconds span)
+  {
+    xchange.startFlushScheduler(milliseconds(1));
+    ASSERT_EQ(pre->isFlushScheduled(), true);
+    std::this_thread::sleep_for(span);
+    xchange.stopFlushScheduler();
+    ASSERT_EQ(pre->isFlushScheduled(), false);
+  };
+
+  scheduledFor(milliseconds(20)); // clock stands still: nothing due yet
+  ASSERT_EQ(ob->isResting(orderId.value()), false);
+
+  clock->advance(milliseconds(101)); // pending duration + 1 tick
+  scheduledFor(milliseconds(50));
+  ASSERT_EQ(ob->isResting(orderId.value()), true);
+  ASSERT_EQ(pre->getBufferedOrderCount(), 0);
+
+  clock->advance(minutes(1)); // past the deactivation time
+  scheduledFor(milliseconds(50));
+  ASSERT_EQ(ob->isResting(orderId.value()), false);
+  ASSERT_EQ(order->getOrderStatus(), OrderStatus::OrderStatus::Cancelled);
+  Xchange::destroyInstance();
+  Clock::install(nullptr);
+}
+
+TEST(Xchange, CoarseClockMovesOnRefreshOnly)
+{
+  auto clock = std::make_shared<CoarseClock>();
+  Clock::install(clock);
+  const TimeStamp first = Clock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  ASSERT_EQ(Clock::now(), first);
+  Clock::refresh();
+  ASSERT_GT(Clock::now(), first);
+  ASSERT_EQ(Clock::install(nullptr), clock);
+  ASSERT_EQ(Clock::installed(), nullptr);
+}
+
+TEST(Xchange, BinaryOrderEntryPlacesOrders)
+{
+  using namespace std::chrono;
+  const TimeStamp expiry = sys_days{2099y / December / 31} + hours(10);
+  Xchange &xchange = Xchange::getInstance(30, 1000000);
+  ParticipantHandle part = xchange.registerParticipant("ID1");
+  SymbolHandle spy = xchange.tradeNewSymbol("SPY");
+
+  std::vector<char> wire;
+  OrderEntry::Encoder encoder(wire);
+  encoder.newOrder(part, spy, Side::Side::Buy,
+                   OrderType::OrderType::GoodTillCancel, 12425, 4);
+  encoder.newOrder(part, spy, Side::Side::Sell,
+                   OrderType::OrderType::GoodTillDate, 12450, 6,
+                   Constants::Now, expiry);
+  std::vector<std::optional<OrderID>> acks;
+  OrderEntry::Decoder decoder(
+      xchange,
+      [&acks](const OrderRequest &, const std::optional<OrderID> &id,
+              std::string_view rejected)
+      {
+        ASSERT_TRUE(rejected.empty());
+        acks.push_back(id);
+      });
+
+  // cut inside the second message: it waits for the rest
+  ASSERT_EQ(decoder.decode(wire.data(), 60), OrderEntry::NewOrderBytes);
+  ASSERT_EQ(acks.size(), 1);
+  ASSERT_EQ(decoder.decode(wire.data() + OrderEntry::NewOrderBytes,
+                           wire.size() - OrderEntry::NewOrderBytes),
+            OrderEntry::NewOrderBytes);
+  ASSERT_EQ(acks.size(), 2);
+  ParticipantPointer info = xchange.getParticipantInfo(part);
+  OrderPointer bid = info->getOrder(acks[0].value());
+  ASSERT_EQ(bid->getPrice(), 12425);
+  ASSERT_EQ(bid->getRemainingQuantity(), 4);
+  ASSERT_EQ(bid->getActivationTime(), bid->getOrderTime());
+  ASSERT_EQ(bid->getDeactivationTime(), Constants::EndOfTime);
+  OrderPointer ask = info->getOrder(acks[1].value());
+  ASSERT_EQ(ask->getSide(), Side::Side::Sell);
+  ASSERT_EQ(ask->getDeactivationTime(), expiry);
+
+  wire.clear();
+  encoder.replaceOrder(part, acks[0].value(), spy, Side::Side::Buy,
+                       OrderType::OrderType::GoodTillCancel, 12430, 4);
+  encoder.cancelOrder(part, acks[1].value(), spy, Side::Side::Sell,
+                      OrderType::OrderType::GoodTillDate);
+  ASSERT_EQ(decoder.decode(wire.data(), wire.size()), wire.size());
+  ASSERT_EQ(acks.size(), 4);
+  ASSERT_EQ(info->getOrder(acks[2].value())->getPrice(), 12430);
+  ASSERT_FALSE(acks[3].has_value());
+  ASSERT_FALSE(info->isParticularOrderPlacedByParticipant(acks[0].value()));
+  ASSERT_FALSE(info->isParticularOrderPlacedByParticipant(acks[1].value()));
+
+  // a good order, then one with an unknown version: the stream stops there
+  wire.clear();
+  encoder.newOrder(part, spy, Side::Side::Buy,
+                   OrderType::OrderType::GoodTillCancel, 12400, 1);
+  encoder.newOrder(part, spy, Side::Side::Buy,
+                   OrderType::OrderType::GoodTillCancel, 12400, 1);
+  encoder.newOrder(part, spy, Side::Side::Buy,
+                   OrderType::OrderType::GoodTillCancel, 12400, 1);
+  wire[OrderEntry::NewOrderBytes + 3] = 9;
+  std::string malformed;
+  OrderEntry::Decoder strict(
+      xchange,
+      [&acks, &malformed, part](const OrderRequest &request,
+                                const std::optional<OrderID> &id,
+                                std::string_view rejected)
+      {
+        ASSERT_EQ(request.participant, part);
+        acks.push_back(id);
+        malformed = rejected;
+      });
+  ASSERT_EQ(strict.decode(wire.data(), wire.size()),
+            OrderEntry::NewOrderBytes);
+  ASSERT_EQ(acks.size(), 6);
+  ASSERT_TRUE(acks[4].has_value());
+  ASSERT_FALSE(acks[5].has_value());
+  ASSERT_NE(malformed.find("version"), std::string::npos);
+  Xchange::destroyInstance();
+}
+
+TEST(Xchange, BinaryOrderEntryRejectsOneMessage)
+{
+  Xchange &xchange = Xchange::getInstance(30, 1000000);
+  ParticipantHandle part = xchange.registerParticipant("ID1");
+  SymbolHandle spy = xchange.tradeNewSymbol("SPY");
+
+  std::vector<char> wire;
+  OrderEntry::Encoder encoder(wire);
+  encoder.newOrder(part, spy, Side::Side::Buy,
+                   OrderType::OrderType::GoodTillCancel, 12425, 4);
+  std::vector<std::optional<OrderID>> acks;
+  std::vector<std::string> rejections;
+  OrderEntry::Decoder decoder(
+      xchange,
+      [&acks, &rejections](const OrderRequest &,
+                           const std::optional<OrderID> &id,
+                           std::string_view rejected)
+      {
+        acks.push_back(id);
+        rejections.emplace_back(rejected);
+      });
+  ASSERT_EQ(decoder.decode(wire.data(), wire.size()), wire.size());
+  const OrderID bid = acks[0].value();
+
+  // a replace that flips the side sits between two good orders
+  wire.clear();
+  encoder.replaceOrder(part, bid, spy, Side::Side::Sell,
+                       OrderType::OrderType::GoodTillCancel, 12430, 4);
+  encoder.newOrder(part, spy, Side::Side::Sell,
+                   OrderType::OrderType::GoodTillCancel, 12450, 6);
+  ASSERT_EQ(decoder.decode(wire.data(), wire.size()), wire.size());
+  ASSERT_EQ(acks.size(), 3);
+  ASSERT_FALSE(acks[1].has_value());
+  ASSERT_FALSE(rejections[1].empty());
+  ASSERT_TRUE(acks[2].has_value());
+  ASSERT_TRUE(rejections[2].empty());
+  ParticipantPointer info = xchange.getParticipantInfo(part);
+  ASSERT_TRUE(info->isParticularOrderPlacedByParticipant(bid));
+  ASSERT_EQ(info->getOrder(bid)->getPrice(), 12425);
+  ASSERT_EQ(info->getOrder(acks[2].value())->getPrice(), 12450);
+  Xchange::destroyInstance();
+}
+
 TEST(Xchange, PlaceAddOrder)
 {
   // ensure that order stays in preprocessor
@@ -127,6 +909,52 @@ TEST(Xchange, PlaceAddOrder)
   Xchange::destroyInstance();
 }
 
+TEST(Xchange, DateTimesParsedAtTheEdge)
+{
+  using namespace std::chrono;
+  // wall time in the zone handed in, not the process' TZ
+  const time_zone *kolkata = locate_zone("Asia/Kolkata");
+  const time_zone *newYork = locate_zone("America/New_York");
+  ASSERT_EQ(Order::convertDateTimeToTimeStamp("21-07-2025 16:43:57", kolkata),
+            sys_days{2025y / July / 21} + hours(11) + minutes(13) + seconds(57));
+  ASSERT_EQ(Order::convertDateTimeToTimeStamp("21-07-2025 16:43:57", newYork),
+            sys_days{2025y / July / 21} + hours(20) + minutes(43) + seconds(57));
+  // back to the first zone: its own offset, not the one cached last
+  ASSERT_EQ(Order::convertDateTimeToTimeStamp("21-07-2025 16:43:58", kolkata),
+            sys_days{2025y / July / 21} + hours(11) + minutes(13) + seconds(58));
+  // right before a change the cached span isn't trusted
+  ASSERT_EQ(Order::convertDateTimeToTimeStamp("09-03-2025 01:59:59", newYork),
+            sys_days{2025y / March / 9} + hours(6) + minutes(59) + seconds(59));
+  ASSERT_THROW(Order::convertDateTimeToTimeStamp("09-03-2025 02:30:00", newYork),
+               std::runtime_error); // skipped
+  ASSERT_EQ(Order::convertDateTimeToTimeStamp("09-03-2025 03:00:00", newYork),
+            sys_days{2025y / March / 9} + hours(7));
+  // repeated: the earlier (EDT) instant
+  ASSERT_EQ(Order::convertDateTimeToTimeStamp("02-11-2025 01:30:00", newYork),
+            sys_days{2025y / November / 2} + hours(5) + minutes(30));
+  ASSERT_EQ(Order::convertDateTimeToTimeStamp("02-11-2025 02:30:00", newYork),
+            sys_days{2025y / November / 2} + hours(7) + minutes(30));
+  ASSERT_EQ(Order::parseActivationTime("NOW", kolkata), Constants::Now);
+  ASSERT_EQ(Order::parseDeactivationTime("", kolkata), Constants::EndOfTime);
+  for (const std::string bad : {"21-7-2025 16:43:57", "31-02-2025 10:00:00",
+                                "21-07-2025 24:00:00", "21-07-2025 16:43",
+                                "21/07/2025 16:43:57"})
+    ASSERT_THROW(Order::convertDateTimeToTimeStamp(bad, kolkata),
+                 std::runtime_error);
+
+  // a bad date is turned down before anything is journaled or recorded
+  Xchange &xchange = Xchange::getInstance(30, 1000000);
+  ParticipantID partId1 = xchange.addParticipant("ID1");
+  xchange.tradeNewSymbol("SPY");
+  ASSERT_THROW(xchange.placeOrder(partId1, Actions::Actions::Add,
+                                  std::nullopt, "SPY", Side::Side::Buy,
+                                  OrderType::OrderType::GoodTillDate, 124.32,
+                                  4, "", "31-02-2025 10:00:00"),
+               std::runtime_error);
+  ASSERT_EQ(xchange.getParticipantInfo(partId1)->getNumberOfOrdersPlaced(), 0);
+  Xchange::destroyInstance();
+}
+
 TEST(Xchange, IsTimeAttributeAdjusted)
 {
   Xchange &xchange = Xchange::getInstance(30, 1000000);
@@ -232,10 +1060,13 @@ void verifyAddOrderInformation(
   std::optional<PreProcessor::OrderActionInfo> ordactinfo =
       relPre->getOrderInfo(orderId);
   ASSERT_EQ(ordactinfo.has_value(), true);
-  auto const &[_, type, actionStored] = ordactinfo.value();
+  auto const &[_, type, actionStored, sideStored, priceStored] =
+      ordactinfo.value();
   ASSERT_EQ(_, orderId);
   ASSERT_EQ(type, otype);
   ASSERT_EQ(actionStored, action);
+  ASSERT_EQ(sideStored, side);
+  ASSERT_EQ(static_cast<double>(priceStored) / 100, price);
 
   const OrderPointer orderptr = relPre->getOrder(orderId);
   ASSERT_NE(orderptr, nullptr);
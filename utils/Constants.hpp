@@ -2,6 +2,7 @@
 
 #include "utils/alias/Fundamental.hpp"
 #include <chrono>
+#include <cstddef>
 #include <cstdlib>
 #include <ctime>
 
@@ -13,6 +14,14 @@ struct Constants {
   //     std::numeric_limits<double>::quiet_NaN();
   static constexpr Price InvalidPrice = 1e9;
 
+  // width (in ticks) of dense price ladder per side of a symbol's orderbook
+  // 4096 ticks at PRICE_MULTIPLIER 100 covers +-20.48 around first price
+  static constexpr std::size_t LadderTicks = 4096;
+
+  // typed activation time of NOW: the order's own entry time (resolved when
+  // it is created, so replay & shards stamp it as they run it)
+  static constexpr TimeStamp Now{};
+
   // static constexpr vs inline
   inline static const TimeStamp EndOfTime = [] {
     std::tm tm{};
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "include/Clock.hpp"
+
+#include <memory>
+
+// installed process wide (Clock::install / Xchange::setClock)
+using ClockPointer = std::shared_ptr<Clock>;
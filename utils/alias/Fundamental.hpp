@@ -15,6 +15,12 @@ using TimeStamp = std::chrono::system_clock::time_point;
 using OrderID = std::uint64_t;
 
 using ParticipantID = std::string;
+
+// interned names: dense 32 bit handles (InternTable), strings only at edges
+using InternHandle = std::uint32_t;
+using SymbolHandle = InternHandle;
+using ParticipantHandle = InternHandle;
+inline constexpr InternHandle InvalidHandle = UINT32_MAX;
 // net position can also be effectively negative (loss)
 using Amount = double;
 using Portfolio = std::unordered_map<Symbol, Amount>;
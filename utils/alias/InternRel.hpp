@@ -0,0 +1,8 @@
+#pragma once
+
+#include "include/InternTable.hpp"
+#include <memory>
+
+// one table per name space (symbols, participants), owned by Xchange &
+// shared with every book & participant it creates
+using InternTablePointer = std::shared_ptr<InternTable>;
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "include/Order.hpp"
-#include <list>
+#include <cstdint>
 #include <memory>
 
 // resources:
@@ -24,11 +24,8 @@
 // shared_ptr sample usage: https://onlinegdb.com/iNK_JFDd7
 using OrderPointer = std::shared_ptr<Order>;
 
-// stl list: doubly linked list
-// optimize insertion/deletion (order)
-// tradeoff: slower searching(get away w/ order iterator storing)
-
-// alternatives: map <time, orderinfo>
-// but multiple different orders can enter at same time
-// map<time, list<orderinfo>>? time info repeat but rest fine
-using OrderList = std::list<OrderPointer>;
+// stl list: doubly linked list (one heap node per order + shared_ptr copy)
+// replaced by an intrusive FIFO: orders sit in the book's OrderPool slots &
+// link to each other by slot index (no per order allocation once warm)
+using SlotIndex = std::uint32_t;
+inline constexpr SlotIndex NullSlot = UINT32_MAX;
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "include/PriceLadder.hpp"
+#include <functional>
+
+using BidLadder = PriceLadder<std::greater<Price>>; // max bid tradable
+using AskLadder = PriceLadder<std::less<Price>>;    // min ask tradable
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "include/SessionCalendar.hpp"
+
+#include <memory>
+
+// built once per venue, read by every preprocessor (immutable)
+using SessionCalendarPointer = std::shared_ptr<const SessionCalendar>;
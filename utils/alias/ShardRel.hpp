@@ -0,0 +1,9 @@
+#pragma once
+
+#include "include/Shard.hpp"
+#include <functional>
+#include <memory>
+
+using ShardPointer = std::unique_ptr<Shard>;
+// execution reports of sharded mode, called on the shard threads
+using ExecutionListener = std::function<void(const ExecutionReport &report)>;
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "include/Trade.hpp"
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <vector>
+
+using Trades = std::vector<Trade>;
+// fills produced by a single aggressor (view, owned by the orderbook)
+using TradeBatch = std::span<const Trade>;
+// position of a trade in an orderbook's trade history (0 = first trade)
+using TradeSequence = std::size_t;
+// one side of a fill pushed to that side's consumer as the match happens
+using FillListener = std::function<void(const OrderTraded &fill)>;
+// whole trade (both legs) pushed to the exchange for participant attribution
+using TradeListener = std::function<void(const Trade &trade)>;